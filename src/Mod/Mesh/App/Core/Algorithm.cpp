@@ -27,6 +27,8 @@
 # include <algorithm>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "Algorithm.h"
 #include "Approximation.h"
 #include "Elements.h"
@@ -1447,10 +1449,70 @@ bool MeshAlgorithm::CutWithPlane (const Base::Vector3f &clBase, const Base::Vect
   std::sort(aulFacets.begin(), aulFacets.end());
   aulFacets.erase(std::unique(aulFacets.begin(), aulFacets.end()), aulFacets.end());  
 
+  return CutFacetsWithPlane(clBase, clNormal, aulFacets, rclResult, fMinEps, bConnectPolygons);
+}
+
+void MeshAlgorithm::CutWithPlanes (const Base::Vector3f &clNormal, const std::vector<Base::Vector3f> &clBases,
+                                   std::vector<std::list<std::vector<Base::Vector3f> > > &rclResults,
+                                   float fMinEps, bool bConnectPolygons) const
+{
+  rclResults.clear();
+  rclResults.resize(clBases.size());
+  if (clBases.empty())
+    return;
+
+  // the planes sorted by their distance to the origin
+  Base::Vector3d clDir = Base::toVector<double>(clNormal);
+  clDir.Normalize();
+  std::vector<std::pair<double, unsigned long> > aclPlanes;
+  aclPlanes.reserve(clBases.size());
+  for (std::size_t i = 0; i < clBases.size(); i++)
+    aclPlanes.push_back(std::make_pair(clDir * Base::toVector<double>(clBases[i]), static_cast<unsigned long>(i)));
+  std::sort(aclPlanes.begin(), aclPlanes.end());
+
+  // Assign each facet to the planes that pass through its extent along the normal
+  // instead of searching the grid for each plane. As the facets are processed in
+  // ascending order the facets of a plane are sorted as in CutWithPlane().
+  std::vector<std::vector<unsigned long> > aulFacets(clBases.size());
+  const MeshPointArray& rclPoints = _rclMesh.GetPoints();
+  const MeshFacetArray& rclFacets = _rclMesh.GetFacets();
+  unsigned long ulIndex = 0;
+  for (MeshFacetArray::_TConstIterator pF = rclFacets.begin(); pF != rclFacets.end(); ++pF, ++ulIndex)
+  {
+    double fMin = clDir * Base::toVector<double>(rclPoints[pF->_aulPoints[0]]);
+    double fMax = fMin;
+    for (int i = 1; i < 3; i++) {
+      double fDist = clDir * Base::toVector<double>(rclPoints[pF->_aulPoints[i]]);
+      fMin = std::min<double>(fMin, fDist);
+      fMax = std::max<double>(fMax, fDist);
+    }
+
+    // keep a margin for the tolerance and the float precision of the intersection
+    double fSlack = 1.0e-5 + 1.0e-6 * std::max<double>(fabs(fMin), fabs(fMax));
+    std::vector<std::pair<double, unsigned long> >::iterator it = std::lower_bound(aclPlanes.begin(), aclPlanes.end(),
+        std::make_pair(fMin - fSlack, 0UL));
+    for (; it != aclPlanes.end() && it->first <= fMax + fSlack; ++it)
+      aulFacets[it->second].push_back(ulIndex);
+  }
+
+  // the planes are independent of each other
+  std::vector<unsigned long> aulPlanes(clBases.size());
+  for (std::size_t i = 0; i < aulPlanes.size(); i++)
+    aulPlanes[i] = static_cast<unsigned long>(i);
+  QtConcurrent::blockingMap(aulPlanes, [&](unsigned long& ulPlane) {
+    CutFacetsWithPlane(clBases[ulPlane], clNormal, aulFacets[ulPlane], rclResults[ulPlane], fMinEps, bConnectPolygons);
+  });
+}
+
+bool MeshAlgorithm::CutFacetsWithPlane (const Base::Vector3f &clBase, const Base::Vector3f &clNormal,
+                                        const std::vector<unsigned long> &aulFacets,
+                                        std::list<std::vector<Base::Vector3f> > &rclResult,
+                                        float fMinEps, bool bConnectPolygons) const
+{
   // alle Facets mit Ebene schneiden
   std::list<std::pair<Base::Vector3f, Base::Vector3f> > clTempPoly;  // Feld mit Schnittlinien (unsortiert, nicht verkettet)
 
-  for (std::vector<unsigned long>::iterator pF = aulFacets.begin(); pF != aulFacets.end(); ++pF)
+  for (std::vector<unsigned long>::const_iterator pF = aulFacets.begin(); pF != aulFacets.end(); ++pF)
   {
     Base::Vector3f  clE1, clE2;
     const MeshGeomFacet clF(_rclMesh.GetFacet(*pF));
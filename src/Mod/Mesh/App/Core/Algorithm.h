@@ -287,6 +287,14 @@ public:
   /** Cuts the mesh with a plane. The result is a list of polylines. */
   bool CutWithPlane (const Base::Vector3f &clBase, const Base::Vector3f &clNormal, const MeshFacetGrid &rclGrid,
                      std::list<std::vector<Base::Vector3f> > &rclResult, float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
+  /**
+   * Cuts the mesh with a family of parallel planes with the normal \a clNormal through the points \a clBases.
+   * The facets are assigned to the planes in one pass and the planes are cut concurrently. \a rclResults
+   * gets the polylines of each plane in the order of \a clBases, they are the same as those of CutWithPlane().
+   */
+  void CutWithPlanes (const Base::Vector3f &clNormal, const std::vector<Base::Vector3f> &clBases,
+                      std::vector<std::list<std::vector<Base::Vector3f> > > &rclResults,
+                      float fMinEps = 1.0e-2f, bool bConnectPolygons = false) const;
   /** 
    * Gets all facets that cut the plane (N,d) and that lie between the two points left and right. 
    * The plane is defined by it normalized normal and the signed distance to the origin.
@@ -305,6 +313,9 @@ public:
   float CalculateMinimumGridLength(float fLength, const Base::BoundBox3f& rBBox, unsigned long maxElements) const;
    
 protected:
+  /** Cuts the facets \a aulFacets with a plane and connects the intersection lines to polylines. */
+  bool CutFacetsWithPlane (const Base::Vector3f &clBase, const Base::Vector3f &clNormal, const std::vector<unsigned long> &aulFacets,
+                           std::list<std::vector<Base::Vector3f> > &rclResult, float fMinEps, bool bConnectPolygons) const;
   /** Helper method to connect the intersection points to polylines. */
   bool ConnectLines (std::list<std::pair<Base::Vector3f, Base::Vector3f> > &rclLines, std::list<std::vector<Base::Vector3f> >&rclPolylines,
                     float fMinEps) const;
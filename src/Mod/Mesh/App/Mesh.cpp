@@ -1037,8 +1037,29 @@ void MeshObject::crossSections(const std::vector<MeshObject::TPlane>& planes, st
     MeshCore::MeshKernel kernel(this->_kernel);
     kernel.Transform(this->_Mtrx);
 
-    MeshCore::MeshFacetGrid grid(kernel);
     MeshCore::MeshAlgorithm algo(kernel);
+
+    // a family of parallel planes is cut at once
+    bool parallel = !planes.empty();
+    for (std::vector<MeshObject::TPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it) {
+        if (it->second != planes.front().second) {
+            parallel = false;
+            break;
+        }
+    }
+
+    if (parallel) {
+        std::vector<Base::Vector3f> bases;
+        bases.reserve(planes.size());
+        for (std::vector<MeshObject::TPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it)
+            bases.push_back(it->first);
+        std::vector<MeshObject::TPolylines> polylines;
+        algo.CutWithPlanes(planes.front().second, bases, polylines, fMinEps, bConnectPolygons);
+        sections.insert(sections.end(), polylines.begin(), polylines.end());
+        return;
+    }
+
+    MeshCore::MeshFacetGrid grid(kernel);
     for (std::vector<MeshObject::TPlane>::const_iterator it = planes.begin(); it != planes.end(); ++it) {
         MeshObject::TPolylines polylines;
         algo.CutWithPlane(it->first, it->second, grid, polylines, fMinEps, bConnectPolygons);
@@ -230,3 +230,16 @@ class PolynomialFitCases(unittest.TestCase):
 
     def tearDown(self):
         pass
+
+class MeshCrossSectionCases(unittest.TestCase):
+    def testParallelPlanes(self):
+        mesh = Mesh.createTorus(8.0, 2.0, 50)
+        planes = [(FreeCAD.Vector(0, 0, 0.1 * i), FreeCAD.Vector(0, 0, 1)) for i in range(-25, 26)]
+        sections = mesh.crossSections(planes)
+        self.assertEqual(len(sections), len(planes))
+        # a plane with another normal cuts each plane on its own
+        other = (FreeCAD.Vector(0, 0, 0), FreeCAD.Vector(1, 0, 0))
+        for plane, section in zip(planes, sections):
+            single = mesh.crossSections([plane, other])[0]
+            self.assertEqual(len(section), len(single))
+            self.assertEqual(sorted(len(i) for i in section), sorted(len(i) for i in single))
@@ -46,6 +46,11 @@
 #endif
 
 
+#include <QEventLoop>
+#include <QFuture>
+#include <QFutureWatcher>
+#include <QtConcurrentMap>
+
 #include "MeshAlgos.h"
 #include "CurveProjector.h"
 
@@ -59,6 +64,7 @@
 
 #include <Base/Exception.h>
 #include <Base/Console.h>
+#include <Base/FutureWatcherProgress.h>
 #include <Base/Sequencer.h>
 
 
@@ -70,6 +76,47 @@ using MeshCore::MeshAlgorithm;
 using MeshCore::MeshFacetGrid;
 using MeshCore::MeshFacet;
 
+namespace {
+// Runs \a fn on all elements of \a items concurrently and shows the progress
+template<class Sequence, class MapFunctor>
+void mapWithProgress(const char* text, Sequence& items, MapFunctor fn)
+{
+    if (items.empty())
+        return;
+
+    QFuture<void> future = QtConcurrent::map(items, fn);
+    Base::FutureWatcherProgress progress(text, static_cast<unsigned int>(items.size()));
+    QFutureWatcher<void> watcher;
+    QObject::connect(&watcher, SIGNAL(progressValueChanged(int)),
+                     &progress, SLOT(progressValueChanged(int)));
+
+    // keep it responsive during computation
+    QEventLoop loop;
+    QObject::connect(&watcher, SIGNAL(finished()), &loop, SLOT(quit()));
+    watcher.setFuture(future);
+    loop.exec();
+
+    // without a running application the event loop returns immediately
+    future.waitForFinished();
+}
+
+// The edges are projected concurrently and the same edge may occur several
+// times in a shape, so each projection works on its own copy of the curve.
+Handle(Geom_Curve) copyCurve(const TopoDS_Edge& aEdge, Standard_Real& fFirst, Standard_Real& fLast)
+{
+    Handle(Geom_Curve) hCurve = BRep_Tool::Curve(aEdge, fFirst, fLast);
+    if (hCurve.IsNull())
+        return hCurve;
+    return Handle(Geom_Curve)::DownCast(hCurve->Copy());
+}
+
+struct EdgeSplitPoints
+{
+    TopoDS_Edge edge;
+    std::vector<CurveProjector::FaceSplitEdge> splitEdges;
+};
+}
+
 CurveProjector::CurveProjector(const TopoDS_Shape &aShape, const MeshKernel &pMesh)
 : _Shape(aShape), _Mesh(pMesh)
 {
@@ -104,25 +151,52 @@ CurveProjectorShape::CurveProjectorShape(const TopoDS_Shape &aShape, const MeshK
 void CurveProjectorShape::Do(void)
 {
   TopExp_Explorer Ex;
-  TopoDS_Shape Edge;
 
+  // collect all edges first and project them concurrently using a shared grid
+  std::vector<EdgeSplitPoints> edges;
   for (Ex.Init(_Shape, TopAbs_EDGE); Ex.More(); Ex.Next())
   {
-	  const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
+    EdgeSplitPoints item;
+    item.edge = TopoDS::Edge(Ex.Current());
+    edges.push_back(item);
+  }
 
-    //std::vector<FaceSplitEdge> vSplitEdges;
-    projectCurve(aEdge, mvEdgeSplitPoints[aEdge]);
+  if (edges.empty())
+    return;
 
-  }
+  MeshFacetGrid cGrid(_Mesh);
+  mapWithProgress("Project curve on mesh", edges, [this, &cGrid](EdgeSplitPoints& item) {
+    projectCurve(item.edge, &cGrid, item.splitEdges);
+  });
 
+  // an edge that occurs several times gets all its projections in the order of the explorer
+  for (std::vector<EdgeSplitPoints>::iterator it = edges.begin(); it != edges.end(); ++it)
+  {
+    std::vector<FaceSplitEdge>& vSplitEdges = mvEdgeSplitPoints[it->edge];
+    vSplitEdges.insert(vSplitEdges.end(), it->splitEdges.begin(), it->splitEdges.end());
+  }
 }
 
 
 void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge,
                                         std::vector<FaceSplitEdge> &vSplitEdges)
+{
+  projectCurve(aEdge, nullptr, vSplitEdges);
+}
+
+void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge, const MeshFacetGrid& rGrid,
+                                        std::vector<FaceSplitEdge> &vSplitEdges)
+{
+  projectCurve(aEdge, &rGrid, vSplitEdges);
+}
+
+void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge, const MeshFacetGrid* pGrid,
+                                        std::vector<FaceSplitEdge> &vSplitEdges)
 {
   Standard_Real fFirst, fLast;
-  Handle(Geom_Curve) hCurve = BRep_Tool::Curve( aEdge,fFirst,fLast );
+  Handle(Geom_Curve) hCurve = copyCurve( aEdge,fFirst,fLast );
+  if (hCurve.IsNull())
+    return;
   
   // getting start point
   gp_Pnt gpPt = hCurve->Value(fFirst);
@@ -137,7 +211,9 @@ void CurveProjectorShape::projectCurve( const TopoDS_Edge& aEdge,
   unsigned long auNeighboursIdx[3];
   bool GoOn;
   
-  if( !findStartPoint(_Mesh,cStartPoint,cResultPoint,uStartFacetIdx) )
+  bool bStart = pGrid ? findStartPoint(_Mesh,*pGrid,cStartPoint,cResultPoint,uStartFacetIdx)
+                      : findStartPoint(_Mesh,cStartPoint,cResultPoint,uStartFacetIdx);
+  if( !bStart )
     return;
 
   uCurFacetIdx = uStartFacetIdx;
@@ -255,6 +331,60 @@ bool CurveProjectorShape::findStartPoint(const MeshKernel &MeshK,const Base::Vec
   return bHit;
 }
 
+bool CurveProjectorShape::findStartPoint(const MeshKernel &MeshK,const MeshFacetGrid& rGrid,
+                                         const Base::Vector3f &Pnt,Base::Vector3f &Rslt,unsigned long &FaceIndex)
+{
+  Base::Vector3f TempResultPoint;
+  float MinLength = FLOAT_MAX;
+  bool bHit = false;
+
+  // A facet with a projected point at distance d intersects the box of size d
+  // around the point. So the box is enlarged until it contains a hit and then
+  // only the facets inside the box of the closest hit are checked.
+  float fLenX, fLenY, fLenZ;
+  rGrid.GetGridLengths(fLenX, fLenY, fLenZ);
+  float fRadius = std::max<float>(fLenX, std::max<float>(fLenY, fLenZ));
+
+  Base::BoundBox3f clGridBB = rGrid.GetBoundBox();
+  clGridBB.Add(Pnt);
+  float fMaxRadius = std::max<float>(clGridBB.LengthX(), std::max<float>(clGridBB.LengthY(), clGridBB.LengthZ()));
+  if (fRadius <= 0.0f)
+    fRadius = fMaxRadius;
+
+  std::vector<unsigned long> aulFacets;
+  for (;;)
+  {
+    Base::BoundBox3f clBB(Pnt.x - fRadius, Pnt.y - fRadius, Pnt.z - fRadius,
+                          Pnt.x + fRadius, Pnt.y + fRadius, Pnt.z + fRadius);
+    aulFacets.clear();
+    rGrid.Inside(clBB, aulFacets);
+    for (std::vector<unsigned long>::iterator it = aulFacets.begin(); it != aulFacets.end(); ++it)
+    {
+      MeshGeomFacet cFacet = MeshK.GetFacet(*it);
+      if (cFacet.Foraminate(Pnt, cFacet.GetNormal(), TempResultPoint))
+      {
+        // on equal distances prefer the lower index like the search over all facets
+        float Dist = (Pnt-TempResultPoint).Length();
+        if (Dist < MinLength || (Dist == MinLength && *it < FaceIndex))
+        {
+          bHit = true;
+          MinLength = Dist;
+          Rslt = TempResultPoint;
+          FaceIndex = *it;
+        }
+      }
+    }
+
+    if (bHit && MinLength <= fRadius)
+      break;
+    if (fRadius >= fMaxRadius)
+      break;
+    fRadius = bHit ? std::min<float>(MinLength, fMaxRadius) : std::min<float>(2.0f * fRadius, fMaxRadius);
+  }
+
+  return bHit;
+}
+
 
 //**************************************************************************
 //**************************************************************************
@@ -314,50 +444,57 @@ void CurveProjectorSimple::projectCurve( const TopoDS_Edge& aEdge,
                                          const std::vector<Base::Vector3f> &/*rclPoints*/,
                                          std::vector<FaceSplitEdge> &/*vSplitEdges*/)
 {
-  Base::Vector3f /*cResultPoint, cSplitPoint, cPlanePnt, cPlaneNormal,*/TempResultPoint;
-  bool bFirst = true;
   //unsigned long auNeighboursIdx[3];
   //std::map<unsigned long,std::vector<Base::Vector3f> >::iterator N1,N2,N3;
   
   Standard_Real fBegin, fEnd;
   Handle(Geom_Curve) hCurve = BRep_Tool::Curve(aEdge,fBegin,fEnd);
+  if (hCurve.IsNull())
+    return;
   float fLen   = float(fEnd - fBegin);
   
   unsigned long ulNbOfPoints = 1000,PointCount=0;
-  
-  MeshFacetIterator It(_Mesh);
 
-  Base::SequencerLauncher seq("Building up projection map...", ulNbOfPoints+1);
-  std::ofstream str("projected.asc", std::ios::out | std::ios::binary);
-  str.precision(4);
-  str.setf(std::ios::fixed | std::ios::showpoint);
-
-  std::map<unsigned long,std::vector<Base::Vector3f> > FaceProjctMap;
- 
+  // sample the curve first, then intersect all samples concurrently with the mesh
+  typedef std::pair<unsigned long, Base::Vector3f> FacetHit;
+  typedef std::pair<Base::Vector3f, std::vector<FacetHit> > Sample;
+  std::vector<Sample> samples(ulNbOfPoints+1);
   for (unsigned long i = 0; i <= ulNbOfPoints; i++)
   {
-    seq.next();
     gp_Pnt gpPt = hCurve->Value(fBegin + (fLen * float(i)) / float(ulNbOfPoints-1));
+    samples[i].first.Set((float)gpPt.X(),(float)gpPt.Y(),(float)gpPt.Z());
+  }
+
+  mapWithProgress("Building up projection map...", samples, [this](Sample& sample) {
+    Base::Vector3f TempResultPoint;
+    MeshFacetIterator It(_Mesh);
 
     // go through the whole Mesh
     for(It.Init();It.More();It.Next())
     {
       // try to project (with angle) to the face
-      if (It->IntersectWithLine (Base::Vector3f((float)gpPt.X(),(float)gpPt.Y(),(float)gpPt.Z()), 
-          It->GetNormal(), TempResultPoint))
-      {
-        FaceProjctMap[It.Position()].push_back(TempResultPoint);
-        str << TempResultPoint.x << " " 
-            << TempResultPoint.y << " " 
-            << TempResultPoint.z << std::endl;
-        Base::Console().Log("IDX %d\n",It.Position());
-
-        if(bFirst){
-          bFirst = false;
-        }
+      if (It->IntersectWithLine (sample.first, It->GetNormal(), TempResultPoint))
+        sample.second.emplace_back(It.Position(), TempResultPoint);
+    }
+  });
 
-        PointCount++;
-      }
+  std::ofstream str("projected.asc", std::ios::out | std::ios::binary);
+  str.precision(4);
+  str.setf(std::ios::fixed | std::ios::showpoint);
+
+  std::map<unsigned long,std::vector<Base::Vector3f> > FaceProjctMap;
+
+  for (std::vector<Sample>::iterator it = samples.begin(); it != samples.end(); ++it)
+  {
+    for (std::vector<FacetHit>::iterator jt = it->second.begin(); jt != it->second.end(); ++jt)
+    {
+      FaceProjctMap[jt->first].push_back(jt->second);
+      str << jt->second.x << " " 
+          << jt->second.y << " " 
+          << jt->second.z << std::endl;
+      Base::Console().Log("IDX %d\n",jt->first);
+
+      PointCount++;
     }
   }
 
@@ -825,22 +962,22 @@ void MeshProjection::projectToMesh (const TopoDS_Shape &aShape, float fMaxDist,
 
     TopExp_Explorer Ex;
 
-    int iCnt=0;
+    typedef std::pair<TopoDS_Edge, std::vector<SplitEdge> > EdgeSplitEdges;
+    std::vector<EdgeSplitEdges> edges;
     for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next())
-        iCnt++;
+        edges.emplace_back(TopoDS::Edge(Ex.Current()), std::vector<SplitEdge>());
 
-    Base::SequencerLauncher seq( "Project curve on mesh", iCnt );
+    // the grid is only read, so all edges can be projected concurrently
+    mapWithProgress("Project curve on mesh", edges, [this, fMaxDist, &cGrid](EdgeSplitEdges& item) {
+        projectEdgeToEdge(item.first, fMaxDist, cGrid, item.second);
+    });
 
-    for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-        const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
-        std::vector<SplitEdge> rSplitEdges;
-        projectEdgeToEdge(aEdge, fMaxDist, cGrid, rSplitEdges);
+    for (auto it : edges) {
         PolyLine polyline;
-        polyline.points.reserve(rSplitEdges.size());
-        for (auto it : rSplitEdges)
-            polyline.points.push_back(it.cPt);
+        polyline.points.reserve(it.second.size());
+        for (auto jt : it.second)
+            polyline.points.push_back(jt.cPt);
         rPolyLines.push_back(polyline);
-        seq.next();
     }
 }
 
@@ -926,54 +1063,22 @@ void MeshProjection::projectOnMesh(const std::vector<Base::Vector3f>& pointsIn,
 
 void MeshProjection::projectParallelToMesh (const TopoDS_Shape &aShape, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
 {
-    // calculate the average edge length and create a grid
-    MeshAlgorithm clAlg(_rcMesh);
-    float fAvgLen = clAlg.GetAverageEdgeLength();
-    MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
     TopExp_Explorer Ex;
 
-    int iCnt=0;
+    std::vector<TopoDS_Edge> edges;
     for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next())
-        iCnt++;
-
-    Base::SequencerLauncher seq( "Project curve on mesh", iCnt );
-
-    for (Ex.Init(aShape, TopAbs_EDGE); Ex.More(); Ex.Next()) {
-        const TopoDS_Edge& aEdge = TopoDS::Edge(Ex.Current());
-        std::vector<Base::Vector3f> points;
-        discretize(aEdge, points, 5);
-
-        typedef std::pair<Base::Vector3f, unsigned long> HitPoint;
-        std::vector<HitPoint> hitPoints;
-        typedef std::pair<HitPoint, HitPoint> HitPoints;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            unsigned long index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
-        }
-
-        MeshCore::MeshProjection meshProjection(_rcMesh);
-        PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
-            }
-        }
-        rPolyLines.push_back(polyline);
-
-        seq.next();
+        edges.push_back(TopoDS::Edge(Ex.Current()));
+
+    // sample all edges up front
+    std::vector<PolyLine> polylines(edges.size());
+    if (!edges.empty()) {
+        PolyLine* first = &polylines.front();
+        QtConcurrent::blockingMap(polylines, [this, first, &edges](PolyLine& polyline) {
+            discretize(edges[&polyline - first], polyline.points, 5);
+        });
     }
+
+    projectParallelToMesh(polylines, dir, rPolyLines);
 }
 
 void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const
@@ -983,42 +1088,61 @@ void MeshProjection::projectParallelToMesh (const std::vector<PolyLine> &aEdges,
     float fAvgLen = clAlg.GetAverageEdgeLength();
     MeshFacetGrid cGrid(_rcMesh, 5.0f*fAvgLen);
 
-    Base::SequencerLauncher seq( "Project curve on mesh", aEdges.size() );
+    struct HitPoint
+    {
+        Base::Vector3f point;
+        Base::Vector3f result;
+        unsigned long index;
+        bool hit;
+    };
 
+    // project the points of all polylines at once
+    std::vector<HitPoint> hitPoints;
+    std::vector<std::size_t> offsets;
+    offsets.reserve(aEdges.size() + 1);
     for (auto it : aEdges) {
-        std::vector<Base::Vector3f> points = it.points;
-
-        typedef std::pair<Base::Vector3f, unsigned long> HitPoint;
-        std::vector<HitPoint> hitPoints;
-        typedef std::pair<HitPoint, HitPoint> HitPoints;
-        std::vector<HitPoints> hitPointPairs;
-        for (auto it : points) {
-            Base::Vector3f result;
-            unsigned long index;
-            if (clAlg.NearestFacetOnRay(it, dir, cGrid, result, index)) {
-                hitPoints.emplace_back(result, index);
-
-                if (hitPoints.size() > 1) {
-                    HitPoint p1 = hitPoints[hitPoints.size()-2];
-                    HitPoint p2 = hitPoints[hitPoints.size()-1];
-                    hitPointPairs.emplace_back(p1, p2);
-                }
-            }
+        offsets.push_back(hitPoints.size());
+        for (auto jt : it.points) {
+            HitPoint hp;
+            hp.point = jt;
+            hp.index = ULONG_MAX;
+            hp.hit = false;
+            hitPoints.push_back(hp);
         }
-
-        MeshCore::MeshProjection meshProjection(_rcMesh);
-        PolyLine polyline;
-        for (auto it : hitPointPairs) {
-            points.clear();
-            if (meshProjection.projectLineOnMesh(cGrid, it.first.first, it.first.second,
-                                                 it.second.first, it.second.second, dir, points)) {
-                polyline.points.insert(polyline.points.end(), points.begin(), points.end());
+    }
+    offsets.push_back(hitPoints.size());
+
+    mapWithProgress("Project points on mesh", hitPoints, [&clAlg, &cGrid, &dir](HitPoint& hp) {
+        hp.hit = clAlg.NearestFacetOnRay(hp.point, dir, cGrid, hp.result, hp.index);
+    });
+
+    // connect the consecutive hits of every polyline along the mesh
+    std::vector<PolyLine> polylines(aEdges.size());
+    if (!polylines.empty()) {
+        PolyLine* first = &polylines.front();
+        mapWithProgress("Project curve on mesh", polylines,
+                        [this, first, &offsets, &hitPoints, &cGrid, &dir](PolyLine& polyline) {
+            std::size_t index = &polyline - first;
+            MeshCore::MeshProjection meshProjection(_rcMesh);
+            const HitPoint* last = nullptr;
+            std::vector<Base::Vector3f> points;
+            for (std::size_t i = offsets[index]; i < offsets[index+1]; i++) {
+                const HitPoint& hp = hitPoints[i];
+                if (!hp.hit)
+                    continue;
+                if (last) {
+                    points.clear();
+                    if (meshProjection.projectLineOnMesh(cGrid, last->result, last->index,
+                                                         hp.result, hp.index, dir, points)) {
+                        polyline.points.insert(polyline.points.end(), points.begin(), points.end());
+                    }
+                }
+                last = &hp;
             }
-        }
-        rPolyLines.push_back(polyline);
-
-        seq.next();
+        });
     }
+
+    rPolyLines.insert(rPolyLines.end(), polylines.begin(), polylines.end());
 }
 
 void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist, const MeshFacetGrid& rGrid,
@@ -1053,7 +1177,9 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
     BRepAdaptor_Curve clCurve(aEdge);
     Standard_Real fFirst = clCurve.FirstParameter();
     Standard_Real fLast  = clCurve.LastParameter();
-    Handle(Geom_Curve) hCurve = BRep_Tool::Curve( aEdge,fFirst,fLast );
+    Handle(Geom_Curve) hCurve = copyCurve( aEdge,fFirst,fLast );
+    if (hCurve.IsNull())
+        return;
 
     // bounds of curve
 //  Bnd_Box clBB;
@@ -1062,11 +1188,8 @@ void MeshProjection::projectEdgeToEdge( const TopoDS_Edge &aEdge, float fMaxDist
     MeshPointIterator cPI( _rcMesh );
     MeshFacetIterator cFI( _rcMesh );
 
-    Base::SequencerLauncher seq( "Project curve on mesh", pEdgeToFace.size() );
     std::map<std::pair<unsigned long, unsigned long>, std::list<unsigned long> >::iterator it;
     for ( it = pEdgeToFace.begin(); it != pEdgeToFace.end(); ++it ) {
-        seq.next();
-
         // edge points
         unsigned long uE0 = it->first.first;
         cPI.Set( uE0 );
@@ -94,13 +94,22 @@ public:
 
   void projectCurve(const TopoDS_Edge& aEdge,
                     std::vector<FaceSplitEdge> &vSplitEdges);
+  /// Same as above but the start facet is searched with the help of the grid
+  void projectCurve(const TopoDS_Edge& aEdge, const MeshCore::MeshFacetGrid& rGrid,
+                    std::vector<FaceSplitEdge> &vSplitEdges);
 
   bool findStartPoint(const MeshKernel &MeshK,const Base::Vector3f &Pnt,Base::Vector3f &Rslt,unsigned long &FaceIndex);
+  /// Gives the same result as above but only checks the facets around \a Pnt
+  bool findStartPoint(const MeshKernel &MeshK,const MeshCore::MeshFacetGrid& rGrid,
+                      const Base::Vector3f &Pnt,Base::Vector3f &Rslt,unsigned long &FaceIndex);
 
 
 
 protected:
+  /// Projects all edges of the shape concurrently
   virtual void Do();
+  void projectCurve(const TopoDS_Edge& aEdge, const MeshCore::MeshFacetGrid* pGrid,
+                    std::vector<FaceSplitEdge> &vSplitEdges);
 };
 
 
@@ -194,6 +203,7 @@ public:
      * Searches all edges that intersect with the projected curve \a aShape. Therefore \a aShape must
      * contain shapes of type TopoDS_Edge, other shape types are ignored. A possible solution is
      * taken if the distance between the curve point and the projected point is <= \a fMaxDist.
+     * The edges are projected concurrently.
      */
     void projectToMesh (const TopoDS_Shape &aShape, float fMaxDist, std::vector<PolyLine>& rPolyLines) const;
     /**
@@ -210,10 +220,13 @@ public:
                        float tolerance, std::vector<Base::Vector3f>& pointsOut) const;
     /**
      * Project all edges of the shape onto the mesh using parallel projection.
+     * The edges are sampled first and all sample points are projected concurrently.
      */
     void projectParallelToMesh (const TopoDS_Shape &aShape, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const;
     /**
      * Project all polylines onto the mesh using parallel projection.
+     * All points of all polylines are projected concurrently, afterwards the
+     * projected points are connected per polyline.
      */
     void projectParallelToMesh (const std::vector<PolyLine>& aEdges, const Base::Vector3f& dir, std::vector<PolyLine>& rPolyLines) const;
     /**
@@ -26,6 +26,7 @@
 #include <Eigen/IterativeLinearSolvers>
 #include <Eigen/SparseCholesky>
 #include <Eigen/SVD>
+#include <QtConcurrentMap>
 #include <iostream>
 #include <algorithm>
 #include <cmath>
@@ -145,27 +146,88 @@ LscmRelax::LscmRelax(
 //////////////////////////////////////////////////////////////////////////
 /////////////////                 F.E.M                      /////////////
 //////////////////////////////////////////////////////////////////////////
-void LscmRelax::relax(double weight)
+void LscmRelax::set_relax_pattern()
 {
-    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
-    // for every triangle
-    Eigen::Matrix<double, 3, 6> B;
-    Eigen::Matrix<double, 2, 2> T;
-    Eigen::Matrix<double, 6, 6> K_m;
-    Eigen::Matrix<double, 6, 1> u_m, rhs_m;
-    Eigen::VectorXd rhs(this->vertices.cols() * 2 + 3);
-    if (this->sol.size() == 0)
-        this->sol.Zero(this->vertices.cols() * 2 + 3);
-    spMat K_g(this->vertices.cols() * 2 + 3, this->vertices.cols() * 2 + 3);
+    // the entries are listed in the same order as relax() writes the values:
+    // 4 entries for every vertex pair of a triangle followed by 8 entries of the
+    // lagrange multipliers for every vertex.
+    long n = this->vertices.cols();
     std::vector<trip> K_g_triplets;
-    Vector2 v1, v2, v3, v12, v23, v31;
+    K_g_triplets.reserve(this->triangles.cols() * 36 + n * 8);
     long row_pos, col_pos;
-    double A;
+    for (long i=0; i<this->triangles.cols(); i++)
+    {
+        for (int j=0; j < 3; j++)
+        {
+            row_pos = this->triangles(j, i);
+            for (int k=0; k < 3; k++)
+            {
+                col_pos = this->triangles(k, i);
+                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2,     0));
+                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2,     0));
+                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2 + 1, 0));
+                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2 + 1, 0));
+            }
+        }
+    }
+    for (long i=0; i < n; i++)
+    {
+        K_g_triplets.push_back(trip(i * 2, n * 2, 0));
+        K_g_triplets.push_back(trip(n * 2, i * 2, 0));
+        K_g_triplets.push_back(trip(i * 2 + 1, n * 2 + 1, 0));
+        K_g_triplets.push_back(trip(n * 2 + 1, i * 2 + 1, 0));
+        K_g_triplets.push_back(trip(i * 2, n * 2 + 2, 0));
+        K_g_triplets.push_back(trip(n * 2 + 2, i * 2, 0));
+        K_g_triplets.push_back(trip(i * 2 + 1, n * 2 + 2, 0));
+        K_g_triplets.push_back(trip(n * 2 + 2, i * 2 + 1, 0));
+    }
 
-    rhs.setZero();
+    // setFromTriplets keeps the explicit zeros, so the structure is complete
+    this->K_relax.resize(n * 2 + 3, n * 2 + 3);
+    this->K_relax.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
+    this->K_relax.makeCompressed();
 
+    this->K_relax_slots.resize(K_g_triplets.size());
+    const int* outer = this->K_relax.outerIndexPtr();
+    const int* inner = this->K_relax.innerIndexPtr();
+    for (std::size_t i=0; i < K_g_triplets.size(); i++)
+    {
+        const int* begin = inner + outer[K_g_triplets[i].col()];
+        const int* end = inner + outer[K_g_triplets[i].col() + 1];
+        this->K_relax_slots[i] = std::lower_bound(begin, end, K_g_triplets[i].row()) - inner;
+    }
+
+    this->relax_solver = std::make_shared<Eigen::SimplicialLDLT<spMat, Eigen::Lower>>();
+    this->relax_solver->analyzePattern(this->K_relax);
+}
+
+void LscmRelax::relax(double weight)
+{
+    ColMat<double, 3> d_q_l_g = this->q_l_m - this->q_l_g;
+    long n = this->vertices.cols();
+    Eigen::VectorXd rhs(n * 2 + 3);
+    if (this->sol.size() == 0)
+        this->sol.Zero(n * 2 + 3);
+    if (!this->relax_solver || static_cast<long>(this->K_relax_slots.size()) != this->triangles.cols() * 36 + n * 8)
+        this->set_relax_pattern();
+
+    // the element matrices are independent of each other and are computed concurrently
+    std::vector<double> K_m_values(this->triangles.cols() * 36);
+    std::vector<double> rhs_m_values(this->triangles.cols() * 6);
+    std::vector<long> element_indices(this->triangles.cols());
     for (long i=0; i<this->triangles.cols(); i++)
+        element_indices[i] = i;
+
+    QtConcurrent::blockingMap(element_indices, [&](long i)
     {
+        Eigen::Matrix<double, 3, 6> B;
+        Eigen::Matrix<double, 2, 2> T;
+        Eigen::Matrix<double, 6, 1> u_m;
+        Eigen::Map<Eigen::Matrix<double, 6, 6>> K_m(&K_m_values[i * 36]);
+        Eigen::Map<Eigen::Matrix<double, 6, 1>> rhs_m(&rhs_m_values[i * 6]);
+        Vector2 v1, v2, v3, v12, v23, v31;
+        double A;
+
         // 1: construct B-mat in m-system
         v1 = this->flat_vertices.col(this->triangles(0, i));
         v2 = this->flat_vertices.col(this->triangles(1, i));
@@ -185,24 +247,32 @@ void LscmRelax::relax(double weight)
         // 2: sigma due dqlg in m-system
         u_m << Vector2(0, 0), T * Vector2(d_q_l_g(i, 0), 0), T * Vector2(d_q_l_g(i, 1), d_q_l_g(i, 2));
 
-        // 3: rhs_m = B.T * C * B * dqlg_m
-        //    K_m = B.T * C * B
-        rhs_m = B.transpose() * this->C * B * u_m * A;
+        // 3: K_m = B.T * C * B
+        //    rhs_m = B.T * C * B * dqlg_m
         K_m = B.transpose() * this->C * B * A;
+        rhs_m = K_m * u_m;
+    });
 
-        // 5: add to rhs_g, K_g
+    // 5: add to rhs_g, K_g
+    double* K_g_values = this->K_relax.valuePtr();
+    std::fill(K_g_values, K_g_values + this->K_relax.nonZeros(), 0.);
+    rhs.setZero();
+    std::vector<long>::const_iterator slot = this->K_relax_slots.begin();
+    long row_pos;
+    for (long i=0; i<this->triangles.cols(); i++)
+    {
+        Eigen::Map<const Eigen::Matrix<double, 6, 6>> K_m(&K_m_values[i * 36]);
         for (int j=0; j < 3; j++)
         {
             row_pos = this->triangles(j, i);
-            rhs[row_pos * 2]     += rhs_m[j * 2];
-            rhs[row_pos * 2 + 1] += rhs_m[j * 2 +1];
+            rhs[row_pos * 2]     += rhs_m_values[i * 6 + j * 2];
+            rhs[row_pos * 2 + 1] += rhs_m_values[i * 6 + j * 2 + 1];
             for (int k=0; k < 3; k++)
             {
-                col_pos = this->triangles(k, i);
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2,        K_m(j * 2,      k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2,        K_m(j * 2 + 1,  k * 2)));
-                K_g_triplets.push_back(trip(row_pos * 2 + 1, col_pos * 2 + 1,    K_m(j * 2 + 1,  k * 2 + 1)));
-                K_g_triplets.push_back(trip(row_pos * 2,     col_pos * 2 + 1,    K_m(j * 2,      k * 2 + 1)));
+                K_g_values[*slot++] += K_m(j * 2,      k * 2);
+                K_g_values[*slot++] += K_m(j * 2 + 1,  k * 2);
+                K_g_values[*slot++] += K_m(j * 2 + 1,  k * 2 + 1);
+                K_g_values[*slot++] += K_m(j * 2,      k * 2 + 1);
                 // we don't have to fill all because the matrix is symmetric.
             }
         }
@@ -254,16 +324,16 @@ void LscmRelax::relax(double weight)
     for (long i=0; i < this->flat_vertices.cols() ; i++)
     {
         // fixing total ux
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2, i * 2, 1));
+        K_g_values[*slot++] += 1;
+        K_g_values[*slot++] += 1;
         // fixing total uy
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 1, 1));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 1, i * 2 + 1, 1));
+        K_g_values[*slot++] += 1;
+        K_g_values[*slot++] += 1;
         // fixing ux*y-uy*x
-        K_g_triplets.push_back(trip(i * 2, this->flat_vertices.cols() * 2 + 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2, - this->flat_vertices(1, i)));
-        K_g_triplets.push_back(trip(i * 2 + 1, this->flat_vertices.cols() * 2 + 2, this->flat_vertices(0, i)));
-        K_g_triplets.push_back(trip(this->flat_vertices.cols() * 2 + 2, i * 2 + 1, this->flat_vertices(0, i)));
+        K_g_values[*slot++] += - this->flat_vertices(1, i);
+        K_g_values[*slot++] += - this->flat_vertices(1, i);
+        K_g_values[*slot++] += this->flat_vertices(0, i);
+        K_g_values[*slot++] += this->flat_vertices(0, i);
     }
 
     // project out the nullspace solution:
@@ -282,13 +352,12 @@ void LscmRelax::relax(double weight)
     // rhs -= nullspace1.dot(rhs) * nullspace1;
     // rhs -= nullspace2.dot(rhs) * nullspace2;
 
-    K_g.setFromTriplets(K_g_triplets.begin(), K_g_triplets.end());
     // rhs +=  K_g * Eigen::VectorXd::Ones(K_g.rows());
     
     // solve linear system (privately store the value for guess in next step)
-    Eigen::SimplicialLDLT<spMat, Eigen::Lower> solver;
-    solver.compute(K_g);
-    this->sol = solver.solve(-rhs);
+    // the symbolic analysis of the pattern is done once in set_relax_pattern
+    this->relax_solver->factorize(this->K_relax);
+    this->sol = this->relax_solver->solve(-rhs);
     this->set_shift(this->sol.head(this->vertices.cols() * 2) * weight);
     this->set_q_l_m();
 }
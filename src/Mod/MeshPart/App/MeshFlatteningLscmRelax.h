@@ -43,6 +43,7 @@
 
 #include <Eigen/Geometry>
 #include <Eigen/IterativeLinearSolvers>
+#include <Eigen/SparseCholesky>
 
 typedef Eigen::SparseMatrix<double> spMat;
 
@@ -87,6 +88,13 @@ private:
     Eigen::Matrix<double, 3, 3> C;
     Eigen::VectorXd sol;
 
+    // the stiffness matrix of the relaxation only changes its values, so the
+    // structure and the symbolic factorization are computed once and reused.
+    spMat K_relax;
+    std::vector<long> K_relax_slots;  // position in K_relax.valuePtr() of every element entry
+    std::shared_ptr<Eigen::SimplicialLDLT<spMat, Eigen::Lower>> relax_solver;
+    void set_relax_pattern();
+
     std::vector<long> get_fem_fixed_pins();
     Eigen::MatrixXd get_nullspace();
 
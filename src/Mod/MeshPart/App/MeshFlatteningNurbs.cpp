@@ -23,6 +23,7 @@
 
 #include "PreCompiled.h"
 #include "MeshFlatteningNurbs.h"
+#include <QtConcurrentMap>
 #include <iostream>
 #include "math.h"
 
@@ -203,16 +204,34 @@ void add_triplets(Eigen::VectorXd values, double row, std::vector<trip> &triplet
     }
 }
 
-spMat NurbsBase2D::getInfluenceMatrix(Eigen::Matrix<double, Eigen::Dynamic, 2> U)
+spMat get_row_matrix(long rows, long cols, std::function<Eigen::VectorXd(long)> row_vector)
 {
+    // the rows are independent of each other and are evaluated concurrently,
+    // every row collects its own triplets which are merged afterwards
+    std::vector<std::vector<trip>> row_triplets(rows);
+    if (rows > 0)
+    {
+        std::vector<trip>* first = &row_triplets.front();
+        QtConcurrent::blockingMap(row_triplets, [first, &row_vector](std::vector<trip>& triplets)
+        {
+            long row_index = &triplets - first;
+            add_triplets(row_vector(row_index), row_index, triplets);
+        });
+    }
     std::vector<trip> triplets;
-    for (unsigned int row_index = 0; row_index < U.rows(); row_index++)
-        add_triplets(this->getInfluenceVector(U.row(row_index)), row_index, triplets);
-    spMat mat(U.rows(), this->u_functions.size() * this->v_functions.size());
+    for (auto& row: row_triplets)
+        triplets.insert(triplets.end(), row.begin(), row.end());
+    spMat mat(rows, cols);
     mat.setFromTriplets(triplets.begin(), triplets.end());
     return mat;
 }
 
+spMat NurbsBase2D::getInfluenceMatrix(Eigen::Matrix<double, Eigen::Dynamic, 2> U)
+{
+    return get_row_matrix(U.rows(), this->u_functions.size() * this->v_functions.size(),
+        [this, &U](long row_index) { return this->getInfluenceVector(U.row(row_index)); });
+}
+
 void NurbsBase2D::computeFirstDerivatives()
 {
     for (unsigned int u_i = 0; u_i < u_functions.size(); u_i ++)
@@ -313,22 +332,14 @@ Eigen::VectorXd NurbsBase2D::getDvVector(Eigen::Vector2d u)
 
 spMat NurbsBase2D::getDuMatrix(Eigen::Matrix<double, Eigen::Dynamic, 2> U)
 {
-    std::vector<trip> triplets;
-    for (unsigned int row_index = 0; row_index < U.rows(); row_index++)
-        add_triplets(this->getDuVector(U.row(row_index)), row_index, triplets);
-    spMat mat(U.rows(), this->u_functions.size() * this->v_functions.size());
-    mat.setFromTriplets(triplets.begin(), triplets.end());
-    return mat;
+    return get_row_matrix(U.rows(), this->u_functions.size() * this->v_functions.size(),
+        [this, &U](long row_index) { return this->getDuVector(U.row(row_index)); });
 }
 
 spMat NurbsBase2D::getDvMatrix(Eigen::Matrix<double, Eigen::Dynamic, 2> U)
 {
-    std::vector<trip> triplets;
-    for (unsigned int row_index = 0; row_index < U.rows(); row_index++)
-        add_triplets(this->getDvVector(U.row(row_index)), row_index, triplets);
-    spMat mat(U.rows(), this->u_functions.size() * this->v_functions.size());
-    mat.setFromTriplets(triplets.begin(), triplets.end());
-    return mat;
+    return get_row_matrix(U.rows(), this->u_functions.size() * this->v_functions.size(),
+        [this, &U](long row_index) { return this->getDvVector(U.row(row_index)); });
 }
 
 
@@ -414,12 +425,8 @@ Eigen::VectorXd NurbsBase1D::getInfluenceVector(double u)
 
 spMat NurbsBase1D::getInfluenceMatrix(Eigen::VectorXd u)
 {
-    std::vector<trip> triplets;
-    for (unsigned int row_index = 0; row_index < u.size(); row_index++)
-        add_triplets(this->getInfluenceVector(u[row_index]), row_index, triplets);
-    spMat mat(u.size(), this->u_functions.size());
-    mat.setFromTriplets(triplets.begin(), triplets.end());
-    return mat;
+    return get_row_matrix(u.size(), this->u_functions.size(),
+        [this, &u](long row_index) { return this->getInfluenceVector(u[row_index]); });
 }
 
 void NurbsBase1D::computeFirstDerivatives()
@@ -471,12 +478,8 @@ Eigen::VectorXd NurbsBase1D::getDuVector(double u)
 
 spMat NurbsBase1D::getDuMatrix(Eigen::VectorXd U)
 {
-    std::vector<trip> triplets;
-    for (unsigned int row_index = 0; row_index < U.size(); row_index++)
-        add_triplets(this->getDuVector(U[row_index]), row_index, triplets);
-    spMat mat(U.size(), this->u_functions.size());
-    mat.setFromTriplets(triplets.begin(), triplets.end());
-    return mat;
+    return get_row_matrix(U.size(), this->u_functions.size(),
+        [this, &U](long row_index) { return this->getDuVector(U[row_index]); });
 }
 
 std::tuple<NurbsBase1D, Eigen::Matrix<double, Eigen::Dynamic, 3>> NurbsBase1D::interpolateUBS(
@@ -24,6 +24,9 @@
 #include <algorithm>
 #include "Mesher.h"
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include <Base/Console.h>
 #include <Base/Exception.h>
 #include <Base/Tools.h>
@@ -83,6 +86,52 @@ using namespace MeshPart;
 
 SMESH_Gen* Mesher::_mesh_gen = 0;
 
+namespace {
+// Sorts the items with one chunk per thread and merges the sorted chunks pairwise
+template <class T, class Compare>
+void parallelSort(std::vector<T>& items, Compare comp)
+{
+    struct Range {
+        std::size_t begin, middle, end;
+    };
+
+    std::size_t numChunks = static_cast<std::size_t>(std::max(1, QThread::idealThreadCount()));
+    std::size_t chunkSize = items.size() / numChunks + 1;
+    std::vector<Range> ranges;
+    for (std::size_t begin = 0; begin < items.size(); begin += chunkSize) {
+        Range r;
+        r.begin = begin;
+        r.end = std::min(begin + chunkSize, items.size());
+        r.middle = r.end;
+        ranges.push_back(r);
+    }
+
+    QtConcurrent::blockingMap(ranges, [&items, comp](Range& r) {
+        std::sort(items.begin() + r.begin, items.begin() + r.end, comp);
+    });
+
+    while (ranges.size() > 1) {
+        std::vector<Range> merged;
+        for (std::size_t i = 0; i < ranges.size(); i += 2) {
+            Range r = ranges[i];
+            if (i + 1 < ranges.size()) {
+                r.middle = ranges[i].end;
+                r.end = ranges[i+1].end;
+            }
+            merged.push_back(r);
+        }
+
+        QtConcurrent::blockingMap(merged, [&items, comp](Range& r) {
+            if (r.middle < r.end)
+                std::inplace_merge(items.begin() + r.begin, items.begin() + r.middle,
+                                   items.begin() + r.end, comp);
+            r.middle = r.end;
+        });
+        ranges.swap(merged);
+    }
+}
+}
+
 
 MeshingOutput::MeshingOutput() 
 {
@@ -122,20 +171,18 @@ int MeshingOutput::sync()
 struct Mesher::Vertex {
     static const double deflection;
     Standard_Real x,y,z;
-    Standard_Integer i;
-    mutable MeshCore::MeshPoint p;
+    unsigned long i;
 
-    Vertex(Standard_Real X, Standard_Real Y, Standard_Real Z)
-        : x(X),y(Y),z(Z),i(0)
+    Vertex()
+        : x(0),y(0),z(0),i(0)
     {
-        p.x = static_cast<float>(x);
-        p.y = static_cast<float>(y);
-        p.z = static_cast<float>(z);
     }
 
-    const MeshCore::MeshPoint& toPoint() const
+    MeshCore::MeshPoint toPoint() const
     {
-        return p;
+        return MeshCore::MeshPoint(static_cast<float>(x),
+                                   static_cast<float>(y),
+                                   static_cast<float>(z));
     }
 
     bool operator < (const Vertex &v) const
@@ -188,8 +235,11 @@ Mesh::MeshObject* Mesher::createMesh() const
     // OCC standard mesher
     if (method == Standard) {
         if (!shape.IsNull()) {
+            // The shared edges are discretized first and the faces are then
+            // meshed in parallel on their fixed boundaries which keeps the
+            // seams between the faces watertight.
             BRepTools::Clean(shape);
-            BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection);
+            BRepMesh_IncrementalMesh aMesh(shape, deflection, relative, angularDeflection, /*isInParallel*/ true);
         }
 
         std::vector<Part::TopoShape::Domain> domains;
@@ -202,75 +252,78 @@ Mesh::MeshObject* Mesher::createMesh() const
 
         bool createSegm = (colors.size() == domains.size());
 
-        MeshCore::MeshFacetArray faces;
-        std::size_t numTriangles = 0;
-        for (auto it : domains)
-            numTriangles += it.facets.size();
-        faces.reserve(numTriangles);
+        // Each corner of a triangle gets a sequence number. Sorting the corners
+        // by their position groups coincident points and the first corner of a
+        // group defines the mesh point. This gives the same points in the same
+        // order as adding the corners one after another to a set of vertices.
+        std::vector<std::size_t> offsets(domains.size() + 1, 0);
+        for (std::size_t i = 0; i < domains.size(); ++i)
+            offsets[i+1] = offsets[i] + 3 * domains[i].facets.size();
+        std::size_t numCorners = offsets.back();
+
+        std::vector<Vertex> corners(numCorners);
+        std::vector<std::size_t> domainIndices(domains.size());
+        std::generate(domainIndices.begin(), domainIndices.end(), Base::iotaGen<std::size_t>(0));
+        QtConcurrent::blockingMap(domainIndices, [&domains, &offsets, &corners](std::size_t& index) {
+            const Part::TopoShape::Domain& domain = domains[index];
+            std::size_t seq = offsets[index];
+            for (const auto& tria : domain.facets) {
+                for (uint32_t pnt : {tria.I1, tria.I2, tria.I3}) {
+                    Vertex& v = corners[seq];
+                    v.x = domain.points[pnt].x;
+                    v.y = domain.points[pnt].y;
+                    v.z = domain.points[pnt].z;
+                    v.i = seq++;
+                }
+            }
+        });
+
+        parallelSort(corners, [](const Vertex& v1, const Vertex& v2) {
+            if (v1 < v2)
+                return true;
+            if (v2 < v1)
+                return false;
+            return v1.i < v2.i;
+        });
+
+        std::vector<unsigned long> firstCorner(numCorners);
+        std::vector<MeshCore::MeshPoint> cornerPoints(numCorners);
+        for (std::size_t j = 0; j < numCorners;) {
+            const Vertex& first = corners[j];
+            cornerPoints[first.i] = first.toPoint();
+            std::size_t k = j;
+            for (; k < numCorners && !(first < corners[k]); ++k)
+                firstCorner[corners[k].i] = first.i;
+            j = k;
+        }
+        corners.clear();
 
-        std::set<Vertex> vertices;
-        Standard_Real x1, y1, z1;
-        Standard_Real x2, y2, z2;
-        Standard_Real x3, y3, z3;
+        MeshCore::MeshPointArray verts;
+        std::vector<unsigned long> pointIndices(numCorners);
+        for (std::size_t j = 0; j < numCorners; ++j) {
+            unsigned long first = firstCorner[j];
+            if (first == j) {
+                pointIndices[j] = verts.size();
+                verts.push_back(cornerPoints[j]);
+            }
+            else {
+                pointIndices[j] = pointIndices[first];
+            }
+        }
+
+        MeshCore::MeshFacetArray faces;
+        faces.reserve(numCorners / 3);
 
         std::vector< std::vector<unsigned long> > meshSegments;
         std::size_t numMeshFaces = 0;
 
         for (std::size_t i = 0; i < domains.size(); ++i) {
             std::size_t numDomainFaces = 0;
-            const Part::TopoShape::Domain& domain = domains[i];
-            for (std::size_t j = 0; j < domain.facets.size(); ++j) {
-                const Part::TopoShape::Facet& tria = domain.facets[j];
-                x1 = domain.points[tria.I1].x;
-                y1 = domain.points[tria.I1].y;
-                z1 = domain.points[tria.I1].z;
-
-                x2 = domain.points[tria.I2].x;
-                y2 = domain.points[tria.I2].y;
-                z2 = domain.points[tria.I2].z;
-
-                x3 = domain.points[tria.I3].x;
-                y3 = domain.points[tria.I3].y;
-                z3 = domain.points[tria.I3].z;
-
-                std::set<Vertex>::iterator it;
+            for (std::size_t j = offsets[i]; j < offsets[i+1]; j += 3) {
                 MeshCore::MeshFacet face;
-
-                // 1st vertex
-                Vertex v1(x1,y1,z1);
-                it = vertices.find(v1);
-                if (it == vertices.end()) {
-                    v1.i = vertices.size();
-                    face._aulPoints[0] = v1.i;
-                    vertices.insert(v1);
-                }
-                else {
-                    face._aulPoints[0] = it->i;
-                }
-
-                // 2nd vertex
-                Vertex v2(x2,y2,z2);
-                it = vertices.find(v2);
-                if (it == vertices.end()) {
-                    v2.i = vertices.size();
-                    face._aulPoints[1] = v2.i;
-                    vertices.insert(v2);
-                }
-                else {
-                    face._aulPoints[1] = it->i;
-                }
-
-                // 3rd vertex
-                Vertex v3(x3,y3,z3);
-                it = vertices.find(v3);
-                if (it == vertices.end()) {
-                    v3.i = vertices.size();
-                    face._aulPoints[2] = v3.i;
-                    vertices.insert(v3);
-                }
-                else {
-                    face._aulPoints[2] = it->i;
-                }
+                face._aulPoints[0] = pointIndices[j];
+                face._aulPoints[1] = pointIndices[j+1];
+                face._aulPoints[2] = pointIndices[j+2];
 
                 // make sure that we don't insert invalid facets
                 if (face._aulPoints[0] != face._aulPoints[1] &&
@@ -290,11 +343,6 @@ Mesh::MeshObject* Mesher::createMesh() const
             }
         }
 
-        MeshCore::MeshPointArray verts;
-        verts.resize(vertices.size());
-        for (auto it : vertices)
-            verts[it.i] = it.toPoint();
-
         MeshCore::MeshKernel kernel;
         kernel.Adopt(verts, faces, true);
 
@@ -126,11 +126,9 @@ private:
 class MeshCrossSection {
 public:
     MeshCrossSection(const MeshCore::MeshKernel& mesh,
-                     const MeshCore::MeshFacetGrid& grid,
                      double x, double y, double z,
                      bool connectEdges, double eps)
         : mesh(mesh)
-        , grid(grid)
         , x(x)
         , y(y)
         , z(z)
@@ -138,23 +136,28 @@ public:
         , epsilon(eps)
     {
     }
-    std::list<TopoDS_Wire> section(double d)
+    std::vector< std::list<TopoDS_Wire> > section(const std::vector<double>& d)
     {
-        Mesh::MeshObject::TPolylines polylines;
+        // all planes are cut at once
+        std::vector<Base::Vector3f> bases;
+        for (auto it = d.begin(); it != d.end(); ++it)
+            bases.emplace_back(x * *it, y * *it, z * *it);
+        std::vector<Mesh::MeshObject::TPolylines> polylines;
         MeshCore::MeshAlgorithm algo(mesh);
-        Base::Vector3f p(x*d, y*d, z*d);
         Base::Vector3f n(x, y, z);
-        algo.CutWithPlane(p, n, grid, polylines, epsilon, connectEdges);
-
-        std::list<TopoDS_Wire> wires;
-        for (auto it = polylines.begin(); it != polylines.end(); ++it) {
-            BRepBuilderAPI_MakePolygon mkPoly;
-            for (auto jt = it->begin(); jt != it->end(); ++jt) {
-                mkPoly.Add(Base::convertTo<gp_Pnt>(*jt));
+        algo.CutWithPlanes(n, bases, polylines, epsilon, connectEdges);
+
+        std::vector< std::list<TopoDS_Wire> > wires(polylines.size());
+        for (std::size_t i = 0; i < polylines.size(); i++) {
+            for (auto it = polylines[i].begin(); it != polylines[i].end(); ++it) {
+                BRepBuilderAPI_MakePolygon mkPoly;
+                for (auto jt = it->begin(); jt != it->end(); ++jt) {
+                    mkPoly.Add(Base::convertTo<gp_Pnt>(*jt));
+                }
+
+                if (mkPoly.IsDone())
+                    wires[i].push_back(mkPoly.Wire());
             }
-
-            if (mkPoly.IsDone())
-                wires.push_back(mkPoly.Wire());
         }
 
         return wires;
@@ -162,7 +165,6 @@ public:
 
 private:
     const MeshCore::MeshKernel& mesh;
-    const MeshCore::MeshFacetGrid& grid;
     double x,y,z;
     bool connectEdges;
     double epsilon;
@@ -271,18 +273,14 @@ void CrossSections::apply()
         MeshCore::MeshKernel kernel(mesh.getKernel());
         kernel.Transform(mesh.getTransform());
 
-        MeshCore::MeshFacetGrid grid(kernel);
-
-        MeshCrossSection cs(kernel, grid, a, b, c, connectEdges, eps);
-        QFuture< std::list<TopoDS_Wire> > future = QtConcurrent::mapped
-            (d, boost::bind(&MeshCrossSection::section, &cs, bp::_1));
-        future.waitForFinished();
+        MeshCrossSection cs(kernel, a, b, c, connectEdges, eps);
+        std::vector< std::list<TopoDS_Wire> > sections = cs.section(d);
 
         TopoDS_Compound comp;
         BRep_Builder builder;
         builder.MakeCompound(comp);
 
-        for (auto ft = future.begin(); ft != future.end(); ++ft) {
+        for (auto ft = sections.begin(); ft != sections.end(); ++ft) {
             const std::list<TopoDS_Wire>& w = *ft;
             for (std::list<TopoDS_Wire>::const_iterator wt = w.begin(); wt != w.end(); ++wt) {
                 if (!wt->IsNull())
@@ -0,0 +1,126 @@
+#**************************************************************************
+#   Copyright (c) 2020 FreeCAD Developers                                 *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, unittest, math
+import Part, Mesh, MeshPart
+
+try:
+    import numpy as np
+    import flatmesh
+except ImportError:
+    flatmesh = None
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD MeshPart module
+#---------------------------------------------------------------------------
+
+def planeMesh(count, size):
+    facets = []
+    step = size / count
+    for i in range(count):
+        for j in range(count):
+            p1 = FreeCAD.Vector(i * step, j * step, 0)
+            p2 = FreeCAD.Vector((i + 1) * step, j * step, 0)
+            p3 = FreeCAD.Vector((i + 1) * step, (j + 1) * step, 0)
+            p4 = FreeCAD.Vector(i * step, (j + 1) * step, 0)
+            facets.append([p1, p2, p3])
+            facets.append([p1, p3, p4])
+    return Mesh.Mesh(facets)
+
+
+class ProjectShapeOnMeshCases(unittest.TestCase):
+    def setUp(self):
+        self.mesh = planeMesh(50, 10.0)
+
+    def testProjectAlongDirection(self):
+        edges = [Part.makeLine(FreeCAD.Vector(1, 1 + i, 2), FreeCAD.Vector(9, 2 + i, 2)) for i in range(5)]
+        polylines = MeshPart.projectShapeOnMesh(Part.Compound(edges), self.mesh, FreeCAD.Vector(0, 0, -1))
+        self.assertEqual(len(polylines), len(edges))
+        for poly in polylines:
+            self.assertGreater(len(poly), 1)
+            for pnt in poly:
+                self.assertAlmostEqual(pnt.z, 0.0, places=5)
+
+    def testProjectPolygons(self):
+        polygons = [[FreeCAD.Vector(1, 1 + i, 2), FreeCAD.Vector(5, 1.5 + i, 2), FreeCAD.Vector(9, 2 + i, 2)] for i in range(5)]
+        polylines = MeshPart.projectShapeOnMesh(polygons, self.mesh, FreeCAD.Vector(0, 0, -1))
+        self.assertEqual(len(polylines), len(polygons))
+        for poly in polylines:
+            self.assertGreater(len(poly), 1)
+
+    def testProjectWithMaxDistance(self):
+        edges = [Part.makeCircle(0.8, FreeCAD.Vector(2 + 1.5 * i, 5, 0.01)) for i in range(5)]
+        polylines = MeshPart.projectShapeOnMesh(Part.Compound(edges), self.mesh, 0.1)
+        self.assertEqual(len(polylines), len(edges))
+        for poly in polylines:
+            for pnt in poly:
+                self.assertAlmostEqual(pnt.z, 0.0, places=5)
+
+
+class MeshFromShapeCases(unittest.TestCase):
+    def testSolidIsWatertight(self):
+        shape = Part.makeCylinder(2, 5).fuse(Part.makeSphere(2.5, FreeCAD.Vector(0, 0, 5)))
+        mesh = MeshPart.meshFromShape(Shape=shape, LinearDeflection=0.01, AngularDeflection=0.1)
+        self.assertTrue(mesh.isSolid())
+        self.assertFalse(mesh.hasNonManifolds())
+        self.assertAlmostEqual(mesh.Volume, shape.Volume, delta=0.01 * shape.Volume)
+
+    def testSegmentsPerFace(self):
+        shape = Part.makeBox(1, 2, 3)
+        mesh = MeshPart.meshFromShape(Shape=shape, LinearDeflection=0.1, Segments=True)
+        self.assertTrue(mesh.isSolid())
+        self.assertEqual(mesh.countSegments(), len(shape.Faces))
+        self.assertEqual(sum(len(mesh.getSegment(i)) for i in range(mesh.countSegments())), mesh.CountFacets)
+
+
+@unittest.skipIf(flatmesh is None, "flatmesh is not available")
+class MeshFlatteningCases(unittest.TestCase):
+    def testFlattenDeveloped(self):
+        # a cylindrical patch can be developed without distortion
+        nodes = []
+        for i in range(20):
+            for j in range(20):
+                phi = 0.1 * i
+                nodes.append([math.cos(phi), math.sin(phi), 0.1 * j])
+        tris = []
+        for i in range(19):
+            for j in range(19):
+                a = i * 20 + j
+                tris.append([a, a + 20, a + 1])
+                tris.append([a + 1, a + 20, a + 21])
+        flattener = flatmesh.LscmRelax(np.array(nodes), np.array(tris), [])
+        flattener.lscm()
+        for i in range(3):
+            flattener.relax(0.95)
+        self.assertAlmostEqual(flattener.flat_area, flattener.area, delta=1e-3 * flattener.area)
+
+    def testNurbsMatrices(self):
+        u_knots = flatmesh.NurbsBase1D.getKnotSequence(0.0, 1.0, 3, 5)
+        v_knots = flatmesh.NurbsBase1D.getKnotSequence(0.0, 1.0, 3, 5)
+        weights = np.ones((len(u_knots) - 4) * (len(v_knots) - 4))
+        base = flatmesh.NurbsBase2D(u_knots, v_knots, weights, 3, 3)
+        base.computeFirstDerivatives()
+        uv = base.getUVMesh(10, 10)
+        mat = base.getInfluenceMatrix(uv)
+        self.assertEqual(mat.shape, (len(uv), len(weights)))
+        self.assertEqual(base.getDuMatrix(uv).shape, mat.shape)
+        self.assertEqual(base.getDvMatrix(uv).shape, mat.shape)
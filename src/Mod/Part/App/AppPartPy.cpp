@@ -130,6 +130,7 @@
 #include "ImportStep.h"
 #include "edgecluster.h"
 #include "FaceMaker.h"
+#include "AttachExtension.h"
 #include "PartFeature.h"
 #include "PartPyCXX.h"
 #include "modelRefine.h"
@@ -510,6 +511,16 @@ public:
         add_varargs_method("clearShapeCache",&Module::clearShapeCache,
             "clearShapeCache() -- Clears internal shape cache"
         );
+        add_varargs_method("getShapeCacheInfo",&Module::getShapeCacheInfo,
+            "getShapeCacheInfo() -- Returns a dict with the statistics of the internal shape cache\n\n"
+            "* Hits, Misses: number of lookups since the cache was last cleared\n"
+            "* Entries: number of cached shapes and sub-elements\n"
+            "* MemSize, MaxMemSize: estimated memory of the cached shapes and its limit in bytes"
+        );
+        add_varargs_method("positionBySupport",&Module::positionBySupport,
+            "positionBySupport(list_of_objects) -- Updates the placements of the attached objects\n\n"
+            "Independent attachments are calculated concurrently. Returns the number of attached objects."
+        );
         add_keyword_method("getShape",&Module::getShape,
             "getShape(obj,subname=None,mat=None,needSubElement=False,transform=True,retType=0):\n"
             "Obtain the the TopoShape of a given object with SubName reference\n\n"
@@ -2231,6 +2242,34 @@ private:
         return Py::Object();
     }
 
+    Py::Object getShapeCacheInfo(const Py::Tuple &args) {
+        if (!PyArg_ParseTuple(args.ptr(),""))
+            throw Py::Exception();
+        auto info = Part::Feature::getShapeCacheInfo();
+        Py::Dict dict;
+        dict.setItem("Hits", Py::Long(static_cast<unsigned long>(info.hits)));
+        dict.setItem("Misses", Py::Long(static_cast<unsigned long>(info.misses)));
+        dict.setItem("Entries", Py::Long(static_cast<unsigned long>(info.entries)));
+        dict.setItem("MemSize", Py::Long(static_cast<unsigned long>(info.memSize)));
+        dict.setItem("MaxMemSize", Py::Long(static_cast<unsigned long>(info.maxMemSize)));
+        return dict;
+    }
+
+    Py::Object positionBySupport(const Py::Tuple &args) {
+        PyObject *pcObj;
+        if (!PyArg_ParseTuple(args.ptr(), "O", &pcObj))
+            throw Py::Exception();
+        std::vector<App::DocumentObject*> objs;
+        Py::Sequence list(pcObj);
+        for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+            PyObject* item = (*it).ptr();
+            if (!PyObject_TypeCheck(item, &(App::DocumentObjectPy::Type)))
+                throw Py::TypeError("expect a list of document objects");
+            objs.push_back(static_cast<App::DocumentObjectPy*>(item)->getDocumentObjectPtr());
+        }
+        return Py::Long(Part::AttachExtension::positionAllBySupport(objs));
+    }
+
     Py::Object splitSubname(const Py::Tuple& args) {
         const char *subname;
         if (!PyArg_ParseTuple(args.ptr(), "s",&subname))
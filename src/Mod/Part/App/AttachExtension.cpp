@@ -22,8 +22,12 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <set>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "AttachExtension.h"
 
 #include <Base/Console.h>
@@ -134,6 +138,82 @@ bool AttachExtension::positionBySupport()
     };
 }
 
+int AttachExtension::positionAllBySupport(const std::vector<App::DocumentObject*> &objs)
+{
+    struct Attachment {
+        AttachExtension* ext;
+        Base::Placement placement;
+        bool attached = false;
+        std::string error;
+    };
+    std::vector<Attachment> pending;
+    std::set<const App::DocumentObject*> waiting;
+    for (App::DocumentObject* obj : objs) {
+        AttachExtension* ext = obj ? obj->getExtensionByType<AttachExtension>(true) : nullptr;
+        if (!ext || !ext->_attacher || !waiting.insert(obj).second)
+            continue;
+        Attachment attachment;
+        attachment.ext = ext;
+        pending.push_back(attachment);
+    }
+
+    int count = 0;
+    while (!pending.empty()) {
+        // the attachments that do not refer to a waiting object can be calculated now
+        std::vector<Attachment> ready, rest;
+        for (Attachment& attachment : pending) {
+            const std::vector<App::DocumentObject*>& support = attachment.ext->Support.getValues();
+            bool independent = std::none_of(support.begin(), support.end(),
+                [&waiting](App::DocumentObject* obj) { return waiting.count(obj) > 0; });
+            (independent ? ready : rest).push_back(attachment);
+        }
+        if (ready.empty()) {
+            // cyclic references, go on with the first one
+            ready.push_back(rest.front());
+            rest.erase(rest.begin());
+        }
+
+        for (Attachment& attachment : ready) {
+            attachment.ext->_active = 0;
+            attachment.ext->updateAttacherVals();
+        }
+        QtConcurrent::blockingMap(ready, [](Attachment& attachment) {
+            AttachEngine* attacher = attachment.ext->_attacher;
+            try {
+                if (attacher->mapMode == mmDeactivated)
+                    return;
+                attachment.placement = attacher->calculateAttachedPlacement(
+                    attachment.ext->getPlacement().getValue());
+                attachment.attached = true;
+            } catch (ExceptionCancel&) {
+                //disabled, don't do anything
+            } catch (Base::Exception& e) {
+                attachment.error = e.what();
+            } catch (Standard_Failure& e) {
+                attachment.error = e.GetMessageString() ? e.GetMessageString() : "Attachment failed";
+            }
+        });
+
+        for (Attachment& attachment : ready) {
+            App::DocumentObject* obj = attachment.ext->getExtendedObject();
+            waiting.erase(obj);
+            if (!attachment.error.empty()) {
+                obj->setStatus(App::Error, true);
+                Base::Console().Error("PositionBySupport: %s: %s\n",
+                    obj->getNameInDocument(), attachment.error.c_str());
+            }
+            else if (attachment.attached) {
+                attachment.ext->getPlacement().setValue(attachment.placement);
+                attachment.ext->_active = 1;
+                count++;
+            }
+        }
+        pending.swap(rest);
+    }
+
+    return count;
+}
+
 bool AttachExtension::isAttacherActive() const {
     if(_active < 0) {
         _active = 0;
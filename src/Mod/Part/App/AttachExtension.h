@@ -107,6 +107,15 @@ public:
       */
     virtual bool positionBySupport(void);
 
+    /** Updates the placements of all attached objects of \a objs like
+      * positionBySupport(). The attachments that do not refer to another object
+      * of \a objs are calculated concurrently, the others once the objects they
+      * refer to are placed. Objects whose attachment fails are marked as erroneous
+      * and reported, the others are still placed. Returns the number of attached
+      * objects.
+      */
+    static int positionAllBySupport(const std::vector<App::DocumentObject*> &objs);
+
     /** Return whether this attacher is active
      */
     bool isAttacherActive() const;
@@ -785,13 +785,16 @@ void AttachEngine::readLinks(const App::PropertyLinkSubList &references,
         geofs[i] = geof;
         const Part::TopoShape* shape;
         if (geof->isDerivedFrom(Part::Feature::getClassTypeId())){
-            shape = &(static_cast<Part::Feature*>(geof)->Shape.getShape());
+            Part::Feature* feat = static_cast<Part::Feature*>(geof);
+            shape = &(feat->Shape.getShape());
             if (shape->isNull()){
                 throw AttachEngineException("AttachEngine3D: Part has null shape");
             }
             if (sub[i].length()>0){
                 try{
-                    storage.push_back(shape->getSubShape(sub[i].c_str()));
+                    //the elements are cached per object, so that objects attached
+                    //to the same shape do not map its sub-shapes over and over
+                    storage.push_back(feat->getElementShape(sub[i].c_str()));
                 } catch (Standard_Failure&){
                     throw AttachEngineException("AttachEngine3D: subshape not found");
                 }
@@ -23,31 +23,72 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <BRep_Builder.hxx>
 # include <BRepAdaptor_Surface.hxx>
 # include <BRepAlgoAPI_Common.hxx>
 # include <BRepAlgoAPI_Cut.hxx>
 # include <BRepAlgoAPI_Section.hxx>
 # include <BRepBuilderAPI_MakeFace.hxx>
 # include <BRepBuilderAPI_MakeWire.hxx>
+# include <BRepBndLib.hxx>
 # include <BRepGProp_Face.hxx>
 # include <BRepPrimAPI_MakeHalfSpace.hxx>
+# include <Bnd_Box.hxx>
 # include <gp_Pln.hxx>
 # include <Precision.hxx>
+# include <Standard_Failure.hxx>
+# include <Standard_Version.hxx>
 # include <ShapeFix_Wire.hxx>
 # include <ShapeAnalysis_FreeBounds.hxx>
 # include <TopExp.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
 # include <TopTools_HSequenceOfShape.hxx>
+# include <TopTools_ListOfShape.hxx>
 # include <TopoDS.hxx>
+# include <TopoDS_Compound.hxx>
 # include <TopoDS_Edge.hxx>
 # include <TopoDS_Wire.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "CrossSection.h"
 
 using namespace Part;
 
+namespace {
+// A solid, free shell or free face to be sliced together with its extent
+// along the plane normal
+struct SliceShape
+{
+    TopoDS_Shape shape;
+    bool solid;
+    double dmin, dmax;
+    std::vector<TopoDS_Face> faces; // faces of a shell or face
+    std::vector<std::pair<double, double> > range; // extent of each face
+};
+
+void getExtent(const TopoDS_Shape& shape, double a, double b, double c, double& dmin, double& dmax)
+{
+    Bnd_Box box;
+    BRepBndLib::Add(shape, box);
+    if (box.IsVoid()) {
+        // don't skip a shape without bounding box
+        dmin = -Precision::Infinite();
+        dmax = Precision::Infinite();
+        return;
+    }
+
+    box.Enlarge(Precision::Confusion());
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    dmin = std::min(a*xMin, a*xMax) + std::min(b*yMin, b*yMax) + std::min(c*zMin, c*zMax);
+    dmax = std::max(a*xMin, a*xMax) + std::max(b*yMin, b*yMax) + std::max(c*zMin, c*zMax);
+}
+}
+
 
 CrossSection::CrossSection(double a, double b, double c, const TopoDS_Shape& s)
   : a(a), b(b), c(c), s(s)
@@ -73,9 +114,104 @@ std::list<TopoDS_Wire> CrossSection::slice(double d) const
     return wires;
 }
 
+std::vector< std::list<TopoDS_Wire> > CrossSection::slices(const std::vector<double>& d) const
+{
+    // Collect the shapes and the extents of them and their faces once, so that
+    // each plane only has to slice the shapes and faces it passes through.
+    std::vector<SliceShape> shapes;
+    TopExp_Explorer xp;
+    for (xp.Init(s, TopAbs_SOLID); xp.More(); xp.Next()) {
+        SliceShape shape;
+        shape.shape = xp.Current();
+        shape.solid = true;
+        getExtent(shape.shape, a, b, c, shape.dmin, shape.dmax);
+        shapes.push_back(shape);
+    }
+    for (int type = TopAbs_SHELL; type <= TopAbs_FACE; type++) {
+        TopAbs_ShapeEnum avoid = type == TopAbs_SHELL ? TopAbs_SOLID : TopAbs_SHELL;
+        for (xp.Init(s, static_cast<TopAbs_ShapeEnum>(type), avoid); xp.More(); xp.Next()) {
+            SliceShape shape;
+            shape.shape = xp.Current();
+            shape.solid = false;
+            getExtent(shape.shape, a, b, c, shape.dmin, shape.dmax);
+            for (TopExp_Explorer xf(shape.shape, TopAbs_FACE); xf.More(); xf.Next()) {
+                double dmin, dmax;
+                getExtent(xf.Current(), a, b, c, dmin, dmax);
+                shape.faces.push_back(TopoDS::Face(xf.Current()));
+                shape.range.push_back(std::make_pair(dmin, dmax));
+            }
+            shapes.push_back(shape);
+        }
+    }
+
+    std::vector< std::list<TopoDS_Wire> > wires(d.size());
+    std::vector<std::string> errors(d.size());
+    if (wires.empty())
+        return wires;
+
+    const std::list<TopoDS_Wire>* first = &wires.front();
+    auto slicePlane = [this, first, &d, &shapes, &errors](std::list<TopoDS_Wire>& result) {
+        std::size_t index = &result - first;
+        double dist = d[index];
+        try {
+            for (std::vector<SliceShape>::const_iterator it = shapes.begin(); it != shapes.end(); ++it) {
+                if (dist < it->dmin || dist > it->dmax)
+                    continue;
+                if (it->solid) {
+                    sliceSolid(dist, it->shape, result);
+                    continue;
+                }
+
+                // only the faces reaching the plane take part in the section
+                std::vector<std::size_t> faces;
+                for (std::size_t i = 0; i < it->faces.size(); i++) {
+                    if (dist >= it->range[i].first && dist <= it->range[i].second)
+                        faces.push_back(i);
+                }
+                if (faces.size() == it->faces.size()) {
+                    sliceNonSolid(dist, it->shape, result);
+                }
+                else if (!faces.empty()) {
+                    TopoDS_Compound comp;
+                    BRep_Builder builder;
+                    builder.MakeCompound(comp);
+                    for (std::vector<std::size_t>::iterator jt = faces.begin(); jt != faces.end(); ++jt)
+                        builder.Add(comp, it->faces[*jt]);
+                    sliceNonSolid(dist, comp, result);
+                }
+            }
+        }
+        catch (Standard_Failure& e) {
+            errors[index] = e.GetMessageString() ? e.GetMessageString() : "Slicing failed";
+        }
+    };
+
+#if OCC_VERSION_HEX >= 0x070100
+    QtConcurrent::blockingMap(wires, slicePlane);
+#else
+    // without the non-destructive mode the section may modify shared sub-shapes
+    std::for_each(wires.begin(), wires.end(), slicePlane);
+#endif
+
+    for (std::vector<std::string>::iterator it = errors.begin(); it != errors.end(); ++it) {
+        if (!it->empty())
+            Standard_Failure::Raise(it->c_str());
+    }
+
+    return wires;
+}
+
 void CrossSection::sliceNonSolid(double d, const TopoDS_Shape& shape, std::list<TopoDS_Wire>& wires) const
 {
+#if OCC_VERSION_HEX >= 0x070100
+    BRepBuilderAPI_MakeFace mkFace(gp_Pln(a,b,c,-d));
+    BRepAlgoAPI_Section cs(shape, mkFace.Face(), Standard_False);
+    // the shape may share sub-shapes with the slices of other threads
+    cs.SetNonDestructive(Standard_True);
+    cs.Build();
+#else
     BRepAlgoAPI_Section cs(shape, gp_Pln(a,b,c,-d));
+#endif
     if (cs.IsDone()) {
         std::list<TopoDS_Edge> edges;
         TopExp_Explorer xp;
@@ -113,7 +249,18 @@ void CrossSection::sliceSolid(double d, const TopoDS_Shape& shape, std::list<Top
 
     BRepPrimAPI_MakeHalfSpace mkSolid(face, refPoint);
     TopoDS_Solid solid = mkSolid.Solid();
+#if OCC_VERSION_HEX >= 0x070100
+    BRepAlgoAPI_Cut mkCut;
+    TopTools_ListOfShape shapeArguments, shapeTools;
+    shapeArguments.Append(shape);
+    shapeTools.Append(solid);
+    mkCut.SetArguments(shapeArguments);
+    mkCut.SetTools(shapeTools);
+    mkCut.SetNonDestructive(Standard_True);
+    mkCut.Build();
+#else
     BRepAlgoAPI_Cut mkCut(shape, solid);
+#endif
 
     if (mkCut.IsDone()) {
         TopTools_IndexedMapOfShape mapOfFaces;
@@ -25,6 +25,7 @@
 #define PART_CROSSSECTION_H
 
 #include <list>
+#include <vector>
 #include <TopTools_IndexedMapOfShape.hxx>
 
 class TopoDS_Shape;
@@ -37,6 +38,13 @@ class PartExport CrossSection
 public:
     CrossSection(double a, double b, double c, const TopoDS_Shape& s);
     std::list<TopoDS_Wire> slice(double d) const;
+    /** Slices the shape with the parallel planes at the distances \a d.
+     * The extents of the sub-shapes are computed once for all planes and
+     * each plane only slices the solids and faces it passes through. The
+     * planes are sliced concurrently. The wires of each plane are returned
+     * in the order of \a d.
+     */
+    std::vector< std::list<TopoDS_Wire> > slices(const std::vector<double>& d) const;
 
 private:
     void sliceNonSolid(double d, const TopoDS_Shape&, std::list<TopoDS_Wire>& wires) const;
@@ -23,7 +23,11 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <numeric>
 # include <Bnd_Box.hxx>
+# include <Bnd_BoundSortBox.hxx>
+# include <Bnd_HArray1OfBox.hxx>
 # include <BRepBndLib.hxx>
 # include <BRep_Builder.hxx>
 # include <BRep_Tool.hxx>
@@ -32,8 +36,8 @@
 # include <BRepCheck_Analyzer.hxx>
 # include <BRepClass_FaceClassifier.hxx>
 # include <BRepLib_FindSurface.hxx>
+# include <ElSLib.hxx>
 # include <Geom_Plane.hxx>
-# include <GeomAPI_ProjectPointOnSurf.hxx>
 # include <IntTools_FClass2d.hxx>
 # include <Precision.hxx>
 # include <ShapeAnalysis.hxx>
@@ -42,6 +46,7 @@
 # include <ShapeFix_Shape.hxx>
 # include <ShapeFix_Wire.hxx>
 # include <Standard_Failure.hxx>
+# include <TColStd_ListIteratorOfListOfInteger.hxx>
 # include <TopoDS.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
@@ -50,6 +55,8 @@
 # include <QtGlobal>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "FaceMakerBullseye.h"
 #include "FaceMakerCheese.h"
 
@@ -106,42 +113,113 @@ void FaceMakerBullseye::Build_Essence()
         plane = GeomAdaptor_Surface(planeFinder.Surface()).Plane();
     }
 
-    //sort wires by length of diagonal of bounding box.
-    std::vector<TopoDS_Wire> wires = this->myWires;
-    std::stable_sort(wires.begin(), wires.end(), FaceMakerCheese::Wire_Compare());
-
-    //add wires one by one to current set of faces.
-    //We go from last to first, to make it so that outer wires come before inner wires.
-    std::vector< std::unique_ptr<FaceDriller> > faces;
-    for (int i = static_cast<int>(wires.size())-1; i >= 0; --i) {
-        TopoDS_Wire &w = wires[i];
-
-        //test if this wire is on any of existing faces (if yes, it's a hole;
-        // if no, it's a beginning of a new face).
-        //Since we are assuming the wires do not intersect, testing if one vertex of wire is in a face is enough.
-        gp_Pnt p = BRep_Tool::Pnt(TopoDS::Vertex(TopExp_Explorer(w, TopAbs_VERTEX).Current()));
-        FaceDriller* foundFace = nullptr;
-        for(std::unique_ptr<FaceDriller> &ff : faces){
-            if(ff->hitTest(p)){
-                foundFace = &(*ff);
-                break;
-            }
+    //Each wire becomes a hole of the innermost wire around it, unless that one is
+    //a hole itself. The wires are oriented and measured independently of each
+    //other, so this is done in parallel.
+    struct WireData {
+        TopoDS_Wire wire;
+        Bnd_Box box;
+        double extent = 0.0; //squared diagonal of the bounding box
+        gp_Pnt point; //a vertex of the wire
+        std::unique_ptr<FaceDriller> face; //the region enclosed by the wire
+        int rank = 0; //position in the order from outer to inner wires
+        std::vector<int> candidates; //wires whose bounding box contains the point
+        int parent = -1; //the innermost wire around this one
+        int depth = 0;
+        std::string error;
+    };
+    std::vector<WireData> data(myWires.size());
+    for (std::size_t i = 0; i < myWires.size(); i++)
+        data[i].wire = myWires[i];
+
+    QtConcurrent::blockingMap(data, [&plane](WireData& d) {
+        try {
+            BRepBndLib::Add(d.wire, d.box);
+            d.box.SetGap(0.0);
+            d.extent = d.box.SquareExtent();
+            d.box.Enlarge(Precision::Confusion());
+            //Since we are assuming the wires do not intersect, testing if one vertex of wire is in a face is enough.
+            d.point = BRep_Tool::Pnt(TopoDS::Vertex(TopExp_Explorer(d.wire, TopAbs_VERTEX).Current()));
+            d.face.reset(new FaceDriller(plane, d.wire));
+        }
+        catch (Standard_Failure& e) {
+            d.error = e.GetMessageString() ? e.GetMessageString() : "Failed to create face from wire";
         }
+    });
+    for (const WireData& d : data) {
+        if (!d.error.empty())
+            throw Standard_Failure(d.error.c_str());
+    }
 
-        if(foundFace){
-            //wire is on a face.
-            foundFace->addHole(w);
-        } else {
-            //wire is not on a face. Start a new face.
-            faces.push_back(std::unique_ptr<FaceDriller>(
-                                new FaceDriller(plane, w)
-                           ));
+    //sort wires by length of diagonal of bounding box, so that outer wires come before inner wires.
+    std::vector<int> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&data](int a, int b) {
+        return data[a].extent < data[b].extent;
+    });
+    std::reverse(order.begin(), order.end());
+
+    //look up the wires around each wire by their bounding boxes
+    Bnd_Box bounds;
+    Handle(Bnd_HArray1OfBox) boxes = new Bnd_HArray1OfBox(1, static_cast<int>(data.size()));
+    for (std::size_t i = 0; i < order.size(); i++) {
+        data[order[i]].rank = static_cast<int>(i);
+        boxes->SetValue(order[i] + 1, data[order[i]].box);
+        bounds.Add(data[order[i]].box);
+    }
+    Bnd_BoundSortBox index;
+    index.Initialize(bounds, boxes);
+    for (WireData& d : data) {
+        Bnd_Box box;
+        box.Add(d.point);
+        box.Enlarge(Precision::Confusion());
+        for (TColStd_ListIteratorOfListOfInteger it(index.Compare(box)); it.More(); it.Next()) {
+            int other = it.Value() - 1;
+            if (data[other].rank < d.rank)
+                d.candidates.push_back(other);
         }
+        //the wires around this one are nested, so the innermost one is the last in order
+        std::sort(d.candidates.begin(), d.candidates.end(), [&data](int a, int b) {
+            return data[a].rank > data[b].rank;
+        });
+    }
+
+    QtConcurrent::blockingMap(data, [&data](WireData& d) {
+        try {
+            for (int other : d.candidates) {
+                if (data[other].face->hitTest(d.point)) {
+                    d.parent = other;
+                    break;
+                }
+            }
+        }
+        catch (Standard_Failure& e) {
+            d.error = e.GetMessageString() ? e.GetMessageString() : "Failed to classify wire";
+        }
+        catch (Base::Exception& e) {
+            d.error = e.what();
+        }
+    });
+    for (const WireData& d : data) {
+        if (!d.error.empty())
+            throw Base::ValueError(d.error.c_str());
+    }
+
+    //wires at even depth start a new face, the others are holes of their parent
+    std::vector<int> faces;
+    for (int i : order) {
+        WireData& d = data[i];
+        if (d.parent >= 0)
+            d.depth = data[d.parent].depth + 1;
+        if (d.depth % 2 == 0)
+            faces.push_back(i);
+        else
+            data[d.parent].face->addHole(*d.face);
     }
 
     //and we are done!
-    for(std::unique_ptr<FaceDriller> &ff : faces){
-        this->myShapesToReturn.push_back(ff->Face());
+    for (int i : faces) {
+        this->myShapesToReturn.push_back(data[i].face->Face());
     }
 }
 
@@ -159,12 +237,13 @@ FaceMakerBullseye::FaceDriller::FaceDriller(const gp_Pln& plane, TopoDS_Wire out
     BRep_Builder builder;
     builder.MakeFace(this->myFace, myHPlane, Precision::Confusion());
     builder.Add(this->myFace, outerWire);
+    this->myOuterWire = outerWire;
 }
 
 bool FaceMakerBullseye::FaceDriller::hitTest(const gp_Pnt& point) const
 {
     double u,v;
-    GeomAPI_ProjectPointOnSurf(point, myHPlane).LowerDistanceParameters(u,v);
+    ElSLib::Parameters(myPlane, point, u, v);
     BRepClass_FaceClassifier cl(myFace, gp_Pnt2d(u,v), Precision::Confusion());
     TopAbs_State ret = cl.State();
     switch(ret){
@@ -187,6 +266,13 @@ void FaceMakerBullseye::FaceDriller::addHole(TopoDS_Wire w)
     builder.Add(this->myFace, w);
 }
 
+void FaceMakerBullseye::FaceDriller::addHole(const FaceDriller& inner)
+{
+    //the outer wire of the other face is CCW, so reversing it makes it a hole
+    BRep_Builder builder;
+    builder.Add(this->myFace, TopoDS::Wire(inner.myOuterWire.Reversed()));
+}
+
 int FaceMakerBullseye::FaceDriller::getWireDirection(const gp_Pln& plane, const TopoDS_Wire& wire)
 {
     //make a test face
@@ -83,6 +83,11 @@ protected:
         bool hitTest(const gp_Pnt& point) const;
 
         void addHole(TopoDS_Wire w);
+        /**
+         * @brief addHole: adds the outer wire of another face as a hole. Its
+         * direction is known already, so it is not tested again.
+         */
+        void addHole(const FaceDriller& inner);
 
         const TopoDS_Face& Face() const {return myFace;}
     public:
@@ -96,6 +101,7 @@ protected:
     private:
         gp_Pln myPlane;
         TopoDS_Face myFace;
+        TopoDS_Wire myOuterWire;
         Handle(Geom_Surface) myHPlane;
     };
 };
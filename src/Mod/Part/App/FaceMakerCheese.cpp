@@ -23,7 +23,11 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <numeric>
 # include <Bnd_Box.hxx>
+# include <Bnd_BoundSortBox.hxx>
+# include <Bnd_HArray1OfBox.hxx>
 # include <BRepBndLib.hxx>
 # include <BRep_Builder.hxx>
 # include <BRep_Tool.hxx>
@@ -39,6 +43,7 @@
 # include <ShapeExtend_Explorer.hxx>
 # include <ShapeFix_Shape.hxx>
 # include <ShapeFix_Wire.hxx>
+# include <TColStd_ListIteratorOfListOfInteger.hxx>
 # include <TopoDS.hxx>
 # include <TopExp_Explorer.hxx>
 # include <TopTools_IndexedMapOfShape.hxx>
@@ -46,12 +51,50 @@
 # include <QtGlobal>
 #endif
 
+#include <QtConcurrentMap>
+
 #include "FaceMakerCheese.h"
 
 
 
 using namespace Part;
 
+namespace {
+// Tests whether wires lie inside of a given wire. The face of the given
+// wire is made only once for all tests.
+class WireClassifier
+{
+public:
+    explicit WireClassifier(const TopoDS_Wire& wire)
+    {
+        BRepBuilderAPI_MakeFace mkFace(wire);
+        if (!mkFace.IsDone())
+            Standard_Failure::Raise("Failed to create a face from wire in sketch");
+        TopoDS_Face face = FaceMakerCheese::validateFace(mkFace.Face());
+        BRepAdaptor_Surface adapt(face);
+        class2d.Init(face, Precision::Confusion());
+        Handle(Geom_Surface) surf = new Geom_Plane(adapt.Plane());
+        analysis = new ShapeAnalysis_Surface(surf);
+    }
+
+    bool contains(const TopoDS_Wire& wire)
+    {
+        TopExp_Explorer xp(wire,TopAbs_VERTEX);
+        if (!xp.More())
+            return false;
+        // TODO: We can make a check to see if all points are inside or all outside
+        // because otherwise we have some intersections which is not allowed
+        gp_Pnt p = BRep_Tool::Pnt(TopoDS::Vertex(xp.Current()));
+        gp_Pnt2d uv = analysis->ValueOfUV(p, Precision::Confusion());
+        return class2d.Perform(uv) == TopAbs_IN;
+    }
+
+private:
+    IntTools_FClass2d class2d;
+    Handle(ShapeAnalysis_Surface) analysis;
+};
+}
+
 TYPESYSTEM_SOURCE(Part::FaceMakerCheese, Part::FaceMakerPublic)
 
 
@@ -128,32 +171,7 @@ bool FaceMakerCheese::isInside(const TopoDS_Wire& wire1, const TopoDS_Wire& wire
     if (box1.IsOut(box2))
         return false;
 
-    double prec = Precision::Confusion();
-
-    BRepBuilderAPI_MakeFace mkFace(wire1);
-    if (!mkFace.IsDone())
-        Standard_Failure::Raise("Failed to create a face from wire in sketch");
-    TopoDS_Face face = validateFace(mkFace.Face());
-    BRepAdaptor_Surface adapt(face);
-    IntTools_FClass2d class2d(face, prec);
-    Handle(Geom_Surface) surf = new Geom_Plane(adapt.Plane());
-    ShapeAnalysis_Surface as(surf);
-
-    TopExp_Explorer xp(wire2,TopAbs_VERTEX);
-    while (xp.More())  {
-        TopoDS_Vertex v = TopoDS::Vertex(xp.Current());
-        gp_Pnt p = BRep_Tool::Pnt(v);
-        gp_Pnt2d uv = as.ValueOfUV(p, prec);
-        if (class2d.Perform(uv) == TopAbs_IN)
-            return true;
-        // TODO: We can make a check to see if all points are inside or all outside
-        // because otherwise we have some intersections which is not allowed
-        else
-            return false;
-        //xp.Next();
-    }
-
-    return false;
+    return WireClassifier(wire1).contains(wire2);
 }
 
 TopoDS_Shape FaceMakerCheese::makeFace(std::list<TopoDS_Wire>& wires)
@@ -193,29 +211,74 @@ TopoDS_Shape FaceMakerCheese::makeFace(const std::vector<TopoDS_Wire>& w)
     if (w.empty())
         return TopoDS_Shape();
 
+    // The bounding boxes are computed once per wire, in parallel
+    struct WireData {
+        TopoDS_Wire wire;
+        Bnd_Box box;
+        double extent = 0.0;
+        int rank = 0;
+        bool used = false;
+    };
+    std::vector<WireData> data(w.size());
+    for (std::size_t i = 0; i < w.size(); i++)
+        data[i].wire = w[i];
+    QtConcurrent::blockingMap(data, [](WireData& d) {
+        if (!d.wire.IsNull()) {
+            BRepBndLib::Add(d.wire, d.box);
+            d.box.SetGap(0.0);
+            d.extent = d.box.SquareExtent();
+        }
+    });
+
     //FIXME: Need a safe method to sort wire that the outermost one comes last
     // Currently it's done with the diagonal lengths of the bounding boxes
-    std::vector<TopoDS_Wire> wires = w;
-    std::sort(wires.begin(), wires.end(), Wire_Compare());
-    std::list<TopoDS_Wire> wire_list;
-    wire_list.insert(wire_list.begin(), wires.rbegin(), wires.rend());
+    std::vector<int> order(data.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&data](int a, int b) {
+        return data[a].extent < data[b].extent;
+    });
+    std::reverse(order.begin(), order.end());
+
+    // only the wires whose bounding boxes overlap can be inside of each other
+    Bnd_Box bounds;
+    Handle(Bnd_HArray1OfBox) boxes = new Bnd_HArray1OfBox(1, static_cast<int>(data.size()));
+    for (std::size_t i = 0; i < order.size(); i++) {
+        WireData& d = data[order[i]];
+        d.rank = static_cast<int>(i);
+        Bnd_Box box = d.box;
+        box.Enlarge(Precision::Confusion());
+        boxes->SetValue(order[i] + 1, box);
+        bounds.Add(box);
+    }
+    Bnd_BoundSortBox index;
+    index.Initialize(bounds, boxes);
 
     // separate the wires into several independent faces
-    std::list< std::list<TopoDS_Wire> > sep_wire_list;
-    while (!wire_list.empty()) {
+    std::vector< std::list<TopoDS_Wire> > sep_wire_list;
+    for (int i : order) {
+        WireData& outer = data[i];
+        if (outer.used)
+            continue;
+        outer.used = true;
         std::list<TopoDS_Wire> sep_list;
-        TopoDS_Wire wire = wire_list.front();
-        wire_list.pop_front();
-        sep_list.push_back(wire);
-
-        std::list<TopoDS_Wire>::iterator it = wire_list.begin();
-        while (it != wire_list.end()) {
-            if (isInside(wire, *it)) {
-                sep_list.push_back(*it);
-                it = wire_list.erase(it);
-            }
-            else {
-                ++it;
+        sep_list.push_back(outer.wire);
+
+        std::vector<int> candidates;
+        for (TColStd_ListIteratorOfListOfInteger it(index.Compare(outer.box)); it.More(); it.Next()) {
+            int other = it.Value() - 1;
+            if (!data[other].used && data[other].rank > outer.rank)
+                candidates.push_back(other);
+        }
+        if (!candidates.empty()) {
+            std::sort(candidates.begin(), candidates.end(), [&data](int a, int b) {
+                return data[a].rank < data[b].rank;
+            });
+            WireClassifier classifier(outer.wire);
+            for (int other : candidates) {
+                if (classifier.contains(data[other].wire)) {
+                    data[other].used = true;
+                    sep_list.push_back(data[other].wire);
+                }
             }
         }
 
@@ -227,13 +290,30 @@ TopoDS_Shape FaceMakerCheese::makeFace(const std::vector<TopoDS_Wire>& w)
         return makeFace(wires);
     }
     else if (sep_wire_list.size() > 1) {
+        // the faces do not share any wires, so they are made in parallel
+        std::vector<TopoDS_Shape> faces(sep_wire_list.size());
+        std::vector<std::string> errors(sep_wire_list.size());
+        const std::list<TopoDS_Wire>* first = &sep_wire_list.front();
+        QtConcurrent::blockingMap(sep_wire_list, [first, &faces, &errors](std::list<TopoDS_Wire>& wires) {
+            std::size_t index = &wires - first;
+            try {
+                faces[index] = makeFace(wires);
+            }
+            catch (Standard_Failure& e) {
+                errors[index] = e.GetMessageString() ? e.GetMessageString() : "Failed to create face from wires";
+            }
+        });
+        for (std::vector<std::string>::iterator it = errors.begin(); it != errors.end(); ++it) {
+            if (!it->empty())
+                Standard_Failure::Raise(it->c_str());
+        }
+
         TopoDS_Compound comp;
         BRep_Builder builder;
         builder.MakeCompound(comp);
-        for (std::list< std::list<TopoDS_Wire> >::iterator it = sep_wire_list.begin(); it != sep_wire_list.end(); ++it) {
-            TopoDS_Shape aFace = makeFace(*it);
-            if (!aFace.IsNull())
-                builder.Add(comp, aFace);
+        for (std::vector<TopoDS_Shape>::iterator it = faces.begin(); it != faces.end(); ++it) {
+            if (!it->IsNull())
+                builder.Add(comp, *it);
         }
 
         return TopoDS_Shape(std::move(comp));
@@ -23,7 +23,10 @@
 
 #include "PreCompiled.h"
 #ifndef _PreComp_
+# include <algorithm>
+# include <Bnd_Box.hxx>
 # include <BRepAlgoAPI_Fuse.hxx>
+# include <BRepBndLib.hxx>
 # include <BRepCheck_Analyzer.hxx>
 # include <Standard_Failure.hxx>
 # include <TopoDS_Iterator.hxx>
@@ -32,11 +35,16 @@
 #endif
 
 
+#include <QThread>
+#include <QtConcurrentMap>
+
 #include "FeaturePartFuse.h"
 #include "modelRefine.h"
 #include <App/Application.h>
+#include <Base/Console.h>
 #include <Base/Parameter.h>
 #include <Base/Exception.h>
+#include <Base/TimeInfo.h>
 
 using namespace Part;
 
@@ -57,6 +65,7 @@ BRepAlgoAPI_BooleanOperation* Fuse::makeOperation(const TopoDS_Shape& base, cons
 
 PROPERTY_SOURCE(Part::MultiFuse, Part::Feature)
 
+const char* MultiFuse::MethodEnums[]= {"Simultaneous","Hierarchical",NULL};
 
 MultiFuse::MultiFuse(void)
 {
@@ -67,6 +76,10 @@ MultiFuse::MultiFuse(void)
     History.setSize(0);
 
     ADD_PROPERTY_TYPE(Refine,(0),"Boolean",(App::PropertyType)(App::Prop_None),"Refine shape (clean up redundant edges) after this boolean operation");
+    ADD_PROPERTY_TYPE(Method,(long(0)),"Boolean",(App::PropertyType)(App::Prop_None),
+        "Simultaneous fuses all shapes in one operation, Hierarchical fuses spatial clusters\n"
+        "of the shapes concurrently and merges them pairwise, which scales better for many shapes");
+    Method.setEnums(MethodEnums);
 
     //init Refine property
     Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter()
@@ -79,6 +92,8 @@ short MultiFuse::mustExecute() const
 {
     if (Shapes.isTouched())
         return 1;
+    if (Method.isTouched())
+        return 1;
     return 0;
 }
 
@@ -140,28 +155,32 @@ App::DocumentObjectExecReturn *MultiFuse::execute(void)
                 }
             }
 #else
-            BRepAlgoAPI_Fuse mkFuse;
-            TopTools_ListOfShape shapeArguments,shapeTools;
-            const TopoDS_Shape& shape = s.front();
-            if (shape.IsNull())
-                throw Base::RuntimeError("Input shape is null");
-            shapeArguments.Append(shape);
-
-            for (std::vector<TopoDS_Shape>::iterator it = s.begin()+1; it != s.end(); ++it) {
+            for (std::vector<TopoDS_Shape>::iterator it = s.begin(); it != s.end(); ++it) {
                 if (it->IsNull())
                     throw Base::RuntimeError("Input shape is null");
-                shapeTools.Append(*it);
             }
 
-            mkFuse.SetArguments(shapeArguments);
-            mkFuse.SetTools(shapeTools);
-            mkFuse.Build();
-            if (!mkFuse.IsDone())
-                throw Base::RuntimeError("MultiFusion failed");
+            TopoDS_Shape resShape;
+            if (Method.getValue() == 1 && s.size() > 2) {
+                resShape = fuseHierarchical(s, history);
+            }
+            else {
+                BRepAlgoAPI_Fuse mkFuse;
+                TopTools_ListOfShape shapeArguments,shapeTools;
+                shapeArguments.Append(s.front());
+                for (std::vector<TopoDS_Shape>::iterator it = s.begin()+1; it != s.end(); ++it)
+                    shapeTools.Append(*it);
+
+                mkFuse.SetArguments(shapeArguments);
+                mkFuse.SetTools(shapeTools);
+                mkFuse.Build();
+                if (!mkFuse.IsDone())
+                    throw Base::RuntimeError("MultiFusion failed");
 
-            TopoDS_Shape resShape = mkFuse.Shape();
-            for (std::vector<TopoDS_Shape>::iterator it = s.begin(); it != s.end(); ++it) {
-                history.push_back(buildHistory(mkFuse, TopAbs_FACE, resShape, *it));
+                resShape = mkFuse.Shape();
+                for (std::vector<TopoDS_Shape>::iterator it = s.begin(); it != s.end(); ++it) {
+                    history.push_back(buildHistory(mkFuse, TopAbs_FACE, resShape, *it));
+                }
             }
 #endif
             if (resShape.IsNull())
@@ -225,3 +244,178 @@ App::DocumentObjectExecReturn *MultiFuse::execute(void)
 
     return App::DocumentObject::StdReturn;
 }
+
+#if OCC_VERSION_HEX > 0x060800
+namespace {
+// An intermediate result of the fuse tree
+struct FusePart
+{
+    TopoDS_Shape shape;
+    std::vector<std::size_t> operands;  // indexes of the input shapes fused into the part
+    std::vector<ShapeHistory> history;  // history of the operands, empty for an input shape
+};
+
+// The parts fused by one operation of a level
+struct FuseGroup
+{
+    std::vector<FusePart> parts;
+    FusePart result;
+    std::string error;
+};
+
+// Orders the shapes so that consecutive shapes are close to each other by
+// splitting them recursively at the median along the longest extent. The sizes
+// of the resulting leaves are appended to leafSizes in their order.
+void sortSpatially(const std::vector<gp_Pnt>& centers, std::vector<std::size_t>::iterator begin,
+                   std::vector<std::size_t>::iterator end, std::size_t leafSize,
+                   std::vector<std::size_t>& leafSizes)
+{
+    if (static_cast<std::size_t>(end - begin) <= leafSize) {
+        leafSizes.push_back(static_cast<std::size_t>(end - begin));
+        return;
+    }
+
+    Bnd_Box box;
+    for (std::vector<std::size_t>::iterator it = begin; it != end; ++it)
+        box.Add(centers[*it]);
+    Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+    box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+    int axis = 1;
+    if (yMax - yMin > xMax - xMin)
+        axis = 2;
+    if (zMax - zMin > std::max(xMax - xMin, yMax - yMin))
+        axis = 3;
+
+    std::vector<std::size_t>::iterator mid = begin + (end - begin) / 2;
+    std::nth_element(begin, mid, end, [&centers, axis](std::size_t a, std::size_t b) {
+        return centers[a].Coord(axis) < centers[b].Coord(axis);
+    });
+    sortSpatially(centers, begin, mid, leafSize, leafSizes);
+    sortSpatially(centers, mid, end, leafSize, leafSizes);
+}
+}
+
+TopoDS_Shape MultiFuse::fuseHierarchical(const std::vector<TopoDS_Shape>& shapes, std::vector<ShapeHistory>& history)
+{
+    Base::TimeInfo totalTime;
+
+    // Each thread gets one cluster of the first level, but a cluster is kept
+    // small because the general fuse doesn't scale well with many operands
+    std::size_t numThreads = static_cast<std::size_t>(std::max(QThread::idealThreadCount(), 1));
+    std::size_t leafSize = (shapes.size() + numThreads - 1) / numThreads;
+    leafSize = std::min<std::size_t>(std::max<std::size_t>(leafSize, 2), 32);
+
+    std::vector<gp_Pnt> centers(shapes.size());
+    for (std::size_t i = 0; i < shapes.size(); i++) {
+        Bnd_Box box;
+        BRepBndLib::Add(shapes[i], box);
+        if (!box.IsVoid()) {
+            Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
+            box.Get(xMin, yMin, zMin, xMax, yMax, zMax);
+            centers[i].SetCoord((xMin + xMax) / 2, (yMin + yMax) / 2, (zMin + zMax) / 2);
+        }
+    }
+
+    std::vector<std::size_t> order(shapes.size());
+    for (std::size_t i = 0; i < order.size(); i++)
+        order[i] = i;
+    std::vector<std::size_t> leafSizes;
+    sortSpatially(centers, order.begin(), order.end(), leafSize, leafSizes);
+
+    std::vector<FusePart> parts(shapes.size());
+    for (std::size_t i = 0; i < order.size(); i++) {
+        parts[i].shape = shapes[order[i]];
+        parts[i].operands.push_back(order[i]);
+    }
+
+    auto fuse = [this](FuseGroup& group) {
+        if (group.parts.size() == 1) {
+            group.result = group.parts.front();
+            return;
+        }
+
+        try {
+            BRepAlgoAPI_Fuse mkFuse;
+            TopTools_ListOfShape shapeArguments,shapeTools;
+            shapeArguments.Append(group.parts.front().shape);
+            for (std::vector<FusePart>::iterator it = group.parts.begin()+1; it != group.parts.end(); ++it)
+                shapeTools.Append(it->shape);
+            mkFuse.SetArguments(shapeArguments);
+            mkFuse.SetTools(shapeTools);
+# if OCC_VERSION_HEX >= 0x070100
+            // the input shapes may share sub-shapes with those of other threads
+            mkFuse.SetNonDestructive(Standard_True);
+# endif
+            mkFuse.Build();
+            if (!mkFuse.IsDone()) {
+                group.error = "MultiFusion failed";
+                return;
+            }
+
+            FusePart& result = group.result;
+            result.shape = mkFuse.Shape();
+            for (std::vector<FusePart>::iterator it = group.parts.begin(); it != group.parts.end(); ++it) {
+                ShapeHistory hist = buildHistory(mkFuse, TopAbs_FACE, result.shape, it->shape);
+                result.operands.insert(result.operands.end(), it->operands.begin(), it->operands.end());
+                if (it->history.empty()) {
+                    result.history.push_back(hist);
+                }
+                else {
+                    for (std::vector<ShapeHistory>::iterator jt = it->history.begin(); jt != it->history.end(); ++jt)
+                        result.history.push_back(joinHistory(*jt, hist));
+                }
+            }
+        }
+        catch (Standard_Failure& e) {
+            group.error = e.GetMessageString() ? e.GetMessageString() : "MultiFusion failed";
+        }
+        catch (...) {
+            group.error = "MultiFusion failed";
+        }
+    };
+
+    // The first level fuses the leaves of the spatial split, the next levels merge
+    // neighbouring results pairwise
+    for (int level = 0; parts.size() > 1; level++) {
+        Base::TimeInfo levelTime;
+        std::vector<FuseGroup> groups(level == 0 ? leafSizes.size() : (parts.size() + 1) / 2);
+        if (level == 0) {
+            std::vector<FusePart>::iterator it = parts.begin();
+            for (std::size_t i = 0; i < leafSizes.size(); i++) {
+                groups[i].parts.assign(it, it + leafSizes[i]);
+                it += leafSizes[i];
+            }
+        }
+        else {
+            for (std::size_t i = 0; i < parts.size(); i++)
+                groups[i / 2].parts.push_back(parts[i]);
+        }
+
+#if OCC_VERSION_HEX >= 0x070100
+        QtConcurrent::blockingMap(groups, fuse);
+#else
+        // without the non-destructive mode the fuses may modify shared sub-shapes
+        std::for_each(groups.begin(), groups.end(), fuse);
+#endif
+
+        parts.clear();
+        for (std::vector<FuseGroup>::iterator it = groups.begin(); it != groups.end(); ++it) {
+            if (!it->error.empty())
+                throw Base::RuntimeError(it->error);
+            parts.push_back(it->result);
+        }
+
+        Base::Console().Log("%s: fuse level %d: %d operations in %.3f s\n", getFullName().c_str(),
+            level, static_cast<int>(groups.size()), Base::TimeInfo::diffTimeF(levelTime, Base::TimeInfo()));
+    }
+
+    const FusePart& root = parts.front();
+    history.resize(shapes.size());
+    for (std::size_t i = 0; i < root.operands.size(); i++)
+        history[root.operands[i]] = root.history[i];
+
+    Base::Console().Log("%s: hierarchical fuse of %d shapes in %.3f s\n", getFullName().c_str(),
+        static_cast<int>(shapes.size()), Base::TimeInfo::diffTimeF(totalTime, Base::TimeInfo()));
+    return root.shape;
+}
+#endif
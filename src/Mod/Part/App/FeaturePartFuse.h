@@ -56,6 +56,7 @@ public:
     App::PropertyLinkList Shapes;
     PropertyShapeHistory History;
     App::PropertyBool Refine;
+    App::PropertyEnumeration Method;
 
     /** @name methods override feature */
     //@{
@@ -68,6 +69,13 @@ public:
         return "PartGui::ViewProviderMultiFuse";
     }
 
+private:
+    /** Fuses spatial clusters of the shapes concurrently and merges the results
+     * pairwise. \a history gets the history of each shape.
+     */
+    TopoDS_Shape fuseHierarchical(const std::vector<TopoDS_Shape>& shapes, std::vector<ShapeHistory>& history);
+
+    static const char* MethodEnums[];
 };
 
 }
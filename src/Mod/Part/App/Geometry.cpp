@@ -100,10 +100,14 @@
 # include <ShapeConstruct_Curve.hxx>
 # include <LProp_NotDefined.hxx>
 
+# include <algorithm>
 # include <ctime>
 # include <cmath>
+# include <limits>
 #endif //_PreComp_
 
+#include <QtConcurrentMap>
+
 #include <Base/VectorPy.h>
 #include <Mod/Part/App/LinePy.h>
 #include <Mod/Part/App/LineSegmentPy.h>
@@ -142,6 +146,49 @@
 
 using namespace Part;
 
+namespace {
+
+/* Calls func(begin, end) for consecutive blocks of the index range [0, count) and
+ * raises the first Standard_Failure that occurred. Before OCC 7 the B-spline
+ * geometries cache their evaluation data in the object itself, so the blocks
+ * are only evaluated in parallel with newer versions.
+ */
+template <typename Func>
+void evaluateBlocks(std::size_t count, Func func)
+{
+    const std::size_t blockSize = 1024;
+    std::vector< std::pair<std::size_t, std::size_t> > blocks;
+    for (std::size_t i = 0; i < count; i += blockSize)
+        blocks.push_back(std::make_pair(i, std::min(count, i + blockSize)));
+
+    std::vector<std::string> errors(blocks.size());
+    const std::pair<std::size_t, std::size_t>* first = blocks.empty() ? nullptr : &blocks.front();
+    auto evaluateBlock = [&func, &errors, first](std::pair<std::size_t, std::size_t>& block) {
+        try {
+            func(block.first, block.second);
+        }
+        catch (Standard_Failure& e) {
+            errors[&block - first] = e.GetMessageString() ? e.GetMessageString() : "Evaluation failed";
+        }
+    };
+
+#if OCC_VERSION_HEX >= 0x070000
+    if (blocks.size() > 1)
+        QtConcurrent::blockingMap(blocks, evaluateBlock);
+    else
+        std::for_each(blocks.begin(), blocks.end(), evaluateBlock);
+#else
+    std::for_each(blocks.begin(), blocks.end(), evaluateBlock);
+#endif
+
+    for (std::vector<std::string>::iterator it = errors.begin(); it != errors.end(); ++it) {
+        if (!it->empty())
+            THROWM(Base::CADKernelError, it->c_str())
+    }
+}
+
+}
+
 
 const char* gce_ErrorStatusText(gce_ErrorType et)
 {
@@ -768,6 +815,43 @@ double GeomCurve::curvatureAt(double u) const
     }
 }
 
+void GeomCurve::evaluate(const double* u, std::size_t count, Base::Vector3d* points,
+                         Base::Vector3d* normals, double* curvatures) const
+{
+    Handle(Geom_Curve) c = Handle(Geom_Curve)::DownCast(handle());
+    if (c.IsNull())
+        return;
+
+    evaluateBlocks(count, [&](std::size_t begin, std::size_t end) {
+        GeomLProp_CLProps prop(c, normals || curvatures ? 2 : 0, Precision::Confusion());
+        for (std::size_t i = begin; i < end; i++) {
+            prop.SetParameter(u[i]);
+            if (points) {
+                const gp_Pnt& pnt = prop.Value();
+                points[i].Set(pnt.X(), pnt.Y(), pnt.Z());
+            }
+            if (normals) {
+                try {
+                    gp_Dir dir;
+                    prop.Normal(dir);
+                    normals[i].Set(dir.X(), dir.Y(), dir.Z());
+                }
+                catch (const LProp_NotDefined&) {
+                    normals[i].Set(0, 0, 0);
+                }
+            }
+            if (curvatures) {
+                try {
+                    curvatures[i] = prop.Curvature();
+                }
+                catch (const LProp_NotDefined&) {
+                    curvatures[i] = 0;
+                }
+            }
+        }
+    });
+}
+
 double GeomCurve::length(double u, double v) const
 {
 
@@ -4016,6 +4100,55 @@ bool GeomSurface::normal(double u, double v, gp_Dir& dir) const
     return false;
 }
 
+void GeomSurface::evaluate(const double* uv, std::size_t count, Base::Vector3d* points,
+                           Base::Vector3d* normals, double* curvatures, Curvature type) const
+{
+    Handle(Geom_Surface) s = Handle(Geom_Surface)::DownCast(handle());
+    if (s.IsNull())
+        return;
+
+    int order = curvatures ? 2 : (normals ? 1 : 0);
+    evaluateBlocks(count, [&](std::size_t begin, std::size_t end) {
+        GeomLProp_SLProps prop(s, order, Precision::Confusion());
+        for (std::size_t i = begin; i < end; i++) {
+            prop.SetParameters(uv[2*i], uv[2*i+1]);
+            if (points) {
+                const gp_Pnt& pnt = prop.Value();
+                points[i].Set(pnt.X(), pnt.Y(), pnt.Z());
+            }
+            if (normals) {
+                if (prop.IsNormalDefined()) {
+                    const gp_Dir& dir = prop.Normal();
+                    normals[i].Set(dir.X(), dir.Y(), dir.Z());
+                }
+                else {
+                    normals[i].Set(0, 0, 0);
+                }
+            }
+            if (curvatures) {
+                double value = std::numeric_limits<double>::quiet_NaN();
+                if (prop.IsCurvatureDefined()) {
+                    switch (type) {
+                    case Maximum:
+                        value = prop.MaxCurvature();
+                        break;
+                    case Minimum:
+                        value = prop.MinCurvature();
+                        break;
+                    case Mean:
+                        value = prop.MeanCurvature();
+                        break;
+                    case Gaussian:
+                        value = prop.GaussianCurvature();
+                        break;
+                    }
+                }
+                curvatures[i] = value;
+            }
+        }
+    });
+}
+
 bool GeomSurface::isUmbillic(double u, double v) const
 {
     Handle(Geom_Surface) s = Handle(Geom_Surface)::DownCast(handle());
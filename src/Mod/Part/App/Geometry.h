@@ -188,6 +188,12 @@ public:
     double curvatureAt(double u) const;
     double length(double u, double v) const;
     bool normalAt(double u, Base::Vector3d& dir) const;
+    /** Evaluates the curve at \a count parameters at once, in parallel for large inputs.
+     * Each output array may be null, otherwise it must hold \a count elements.
+     * Where the normal is not defined a null vector is written.
+     */
+    void evaluate(const double* u, std::size_t count, Base::Vector3d* points,
+                  Base::Vector3d* normals = nullptr, double* curvatures = nullptr) const;
     bool intersect(GeomCurve * c,
                    std::vector<std::pair<Base::Vector3d, Base::Vector3d>>& points,
                    double tol = Precision::Confusion()) const;
@@ -768,6 +774,14 @@ public:
     bool tangentU(double u, double v, gp_Dir& dirU) const;
     bool tangentV(double u, double v, gp_Dir& dirV) const;
     bool normal(double u, double v, gp_Dir& dir) const;
+    /** Evaluates the surface at \a count (u,v) pairs at once, in parallel for large inputs.
+     * Each output array may be null, otherwise it must hold \a count elements.
+     * Where the normal is not defined a null vector is written, where the curvature
+     * is not defined NaN is written.
+     */
+    void evaluate(const double* uv, std::size_t count, Base::Vector3d* points,
+                  Base::Vector3d* normals = nullptr, double* curvatures = nullptr,
+                  Curvature type = Mean) const;
 
     /** @name Curvature information */
     //@{
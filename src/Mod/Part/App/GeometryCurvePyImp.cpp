@@ -73,6 +73,7 @@
 
 #include "OCCError.h"
 #include "TopoShape.h"
+#include "PartPyCXX.h"
 #include "TopoShapePy.h"
 #include "TopoShapeEdgePy.h"
 
@@ -358,6 +359,48 @@ PyObject* GeometryCurvePy::parameterAtDistance(PyObject *args)
     return 0;
 }
 
+PyObject* GeometryCurvePy::evaluate(PyObject *args, PyObject *kwds)
+{
+    PyObject* params;
+    PyObject* normals = Py_False;
+    PyObject* curvature = Py_False;
+    static char* kwds_evaluate[] = {"Parameters","Normals","Curvature",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!O!", kwds_evaluate, &params,
+                                     &PyBool_Type, &normals, &PyBool_Type, &curvature))
+        return 0;
+
+    try {
+        std::vector<double> u;
+        bool asBuffer = getPyDoubles(params, u);
+
+        std::vector<Base::Vector3d> points(u.size());
+        std::vector<Base::Vector3d> dirs(PyObject_IsTrue(normals) ? u.size() : 0);
+        std::vector<double> values(PyObject_IsTrue(curvature) ? u.size() : 0);
+        getGeomCurvePtr()->evaluate(u.data(), u.size(), points.data(),
+                                    dirs.empty() ? nullptr : dirs.data(),
+                                    values.empty() ? nullptr : values.data());
+
+        Py::Object pnts = vectors2py(points, asBuffer);
+        if (!PyObject_IsTrue(normals) && !PyObject_IsTrue(curvature))
+            return Py::new_reference_to(pnts);
+
+        Py::List result;
+        result.append(pnts);
+        if (PyObject_IsTrue(normals))
+            result.append(vectors2py(dirs, asBuffer));
+        if (PyObject_IsTrue(curvature))
+            result.append(doubles2py(values, asBuffer));
+        return Py::new_reference_to(Py::Tuple(result));
+    }
+    catch (Py::Exception&) {
+        return 0;
+    }
+    catch (Base::CADKernelError& e) {
+        PyErr_SetString(PartExceptionOCCError, e.what());
+        return 0;
+    }
+}
+
 PyObject* GeometryCurvePy::getD0(PyObject *args)
 {
     Handle(Geom_Geometry) g = getGeometryPtr()->handle();
@@ -0,0 +1,227 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <functional>
+# include <limits>
+# include <sstream>
+# include <BRep_Tool.hxx>
+# include <BRepTools_ShapeSet.hxx>
+# include <TopExp.hxx>
+# include <TopLoc_Location.hxx>
+# include <TopoDS.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
+#endif
+
+#include <boost/functional/hash.hpp>
+#include <boost_bind_bind.hpp>
+#include <App/Application.h>
+#include <App/Document.h>
+
+#include "GeometryStore.h"
+
+using namespace Part;
+namespace bp = boost::placeholders;
+
+namespace {
+// The BRep data of the shape without triangulation. The full precision is
+// needed so that only identical shapes get the same data.
+std::string shapeData(const TopoDS_Shape& shape)
+{
+    std::ostringstream str;
+    str.precision(std::numeric_limits<double>::digits10 + 1);
+    BRepTools_ShapeSet set(Standard_False);
+    set.Add(shape);
+    set.Write(str);
+    set.Write(shape, str);
+    return str.str();
+}
+
+// A cheap hash of the shape that doesn't need the BRep data. It uses the
+// number of sub-shapes and the vertex positions which differ for most shapes
+// that are not identical.
+std::size_t shapeHash(const TopoDS_Shape& shape)
+{
+    std::size_t hash = 0;
+    static const TopAbs_ShapeEnum types[] = {TopAbs_SOLID, TopAbs_SHELL, TopAbs_FACE, TopAbs_WIRE, TopAbs_EDGE};
+    for (TopAbs_ShapeEnum type : types) {
+        TopTools_IndexedMapOfShape map;
+        TopExp::MapShapes(shape, type, map);
+        boost::hash_combine(hash, map.Extent());
+    }
+
+    TopTools_IndexedMapOfShape vertexes;
+    TopExp::MapShapes(shape, TopAbs_VERTEX, vertexes);
+    boost::hash_combine(hash, vertexes.Extent());
+    for (int i = 1; i <= vertexes.Extent(); ++i) {
+        gp_Pnt pnt = BRep_Tool::Pnt(TopoDS::Vertex(vertexes(i)));
+        boost::hash_combine(hash, pnt.X());
+        boost::hash_combine(hash, pnt.Y());
+        boost::hash_combine(hash, pnt.Z());
+    }
+    return hash;
+}
+}
+
+GeometryStore& GeometryStore::instance()
+{
+    static GeometryStore store;
+    return store;
+}
+
+GeometryStore::GeometryStore()
+{
+    App::GetApplication().signalDeleteDocument.connect(
+        boost::bind(&GeometryStore::slotDeleteDocument, this, bp::_1));
+}
+
+GeometryStore::~GeometryStore()
+{
+}
+
+bool GeometryStore::isEnabled()
+{
+    return App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/Part/General")->GetBool("ShareIdenticalShapes", false);
+}
+
+TopoDS_Shape GeometryStore::share(const App::Document* doc, const TopoDS_Shape& shape)
+{
+    if (!doc || shape.IsNull())
+        return shape;
+
+    TopoDS_Shape base = shape.Located(TopLoc_Location()).Oriented(TopAbs_FORWARD);
+    std::lock_guard<std::mutex> lock(mutex);
+    Shapes& shapes = documents[doc];
+
+    // fast check for a shape that is already shared
+    auto known = shapes.byTShape.find(base.TShape().operator->());
+    if (known != shapes.byTShape.end()) {
+        known->second->owners++;
+        return shape;
+    }
+
+    // the BRep data is only written for shapes with the same hash and only
+    // once for each of them
+    std::size_t hash = shapeHash(base);
+    std::string data;
+    auto range = shapes.byHash.equal_range(hash);
+    for (auto it = range.first; it != range.second; ++it) {
+        Entry& entry = *it->second;
+        if (data.empty())
+            data = shapeData(base);
+        if (entry.data.empty())
+            entry.data = shapeData(entry.shape);
+        if (entry.data == data) {
+            entry.owners++;
+            return entry.shape.Located(shape.Location()).Oriented(shape.Orientation());
+        }
+    }
+
+    Entry entry;
+    entry.shape = base;
+    entry.hash = hash;
+    entry.data = std::move(data);
+    entry.owners = 1;
+    auto pos = shapes.entries.insert(shapes.entries.end(), entry);
+    shapes.byHash.insert(std::make_pair(hash, pos));
+    shapes.byTShape[base.TShape().operator->()] = pos;
+
+    // the costs of pruning are distributed over the insertions
+    if (shapes.entries.size() > 2 * shapes.pruneSize)
+        prune(shapes);
+    return shape;
+}
+
+void GeometryStore::release(const App::Document* doc, const TopoDS_Shape& shape)
+{
+    if (!doc || shape.IsNull())
+        return;
+
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = documents.find(doc);
+    if (it == documents.end())
+        return;
+    auto known = it->second.byTShape.find(shape.TShape().operator->());
+    if (known != it->second.byTShape.end() && known->second->owners > 0)
+        known->second->owners--;
+}
+
+void GeometryStore::prune(Shapes& shapes)
+{
+    for (auto it = shapes.entries.begin(); it != shapes.entries.end();) {
+        // the store holds the only reference
+        if (it->owners > 0 || it->shape.TShape()->GetRefCount() > 1) {
+            ++it;
+            continue;
+        }
+
+        auto range = shapes.byHash.equal_range(it->hash);
+        for (auto jt = range.first; jt != range.second; ++jt) {
+            if (jt->second == it) {
+                shapes.byHash.erase(jt);
+                break;
+            }
+        }
+        shapes.byTShape.erase(it->shape.TShape().operator->());
+        it = shapes.entries.erase(it);
+    }
+
+    shapes.pruneSize = std::max<std::size_t>(shapes.entries.size(), 64);
+}
+
+int GeometryStore::countInstances(const App::Document* doc, const TopoDS_Shape& shape) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = documents.find(doc);
+    if (it == documents.end() || shape.IsNull())
+        return 0;
+
+    auto known = it->second.byTShape.find(shape.TShape().operator->());
+    if (known == it->second.byTShape.end())
+        return 0;
+    return known->second->owners;
+}
+
+std::size_t GeometryStore::countShapes(const App::Document* doc) const
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    auto it = documents.find(doc);
+    if (it == documents.end())
+        return 0;
+    return it->second.entries.size();
+}
+
+void GeometryStore::clear(const App::Document* doc)
+{
+    std::lock_guard<std::mutex> lock(mutex);
+    documents.erase(doc);
+}
+
+void GeometryStore::slotDeleteDocument(const App::Document& doc)
+{
+    clear(&doc);
+}
@@ -0,0 +1,109 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PART_GEOMETRYSTORE_H
+#define PART_GEOMETRYSTORE_H
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <TopoDS_Shape.hxx>
+
+namespace App {
+class Document;
+}
+
+namespace Part
+{
+
+/**
+ * The GeometryStore class keeps one instance of each distinct shape per document.
+ *
+ * Two shapes are considered identical if they have the same topology and geometry
+ * once their location is removed, i.e. they only differ in their placement. This is
+ * the case e.g. for the many instances of a fastener of an imported assembly that
+ * end up as independent shapes. Such shapes are replaced by a located instance of
+ * the stored shape. So, they share their TShape and with it the triangulation.
+ *
+ * The shapes are compared by their BRep data which is only done for shapes with
+ * the same hash value of their vertexes. Shapes that are not referenced any more
+ * outside the store are removed from time to time.
+ */
+class PartExport GeometryStore
+{
+public:
+    static GeometryStore& instance();
+
+    /** Returns a shape that is identical to \a shape but shares its TShape with all
+     * other identical shapes passed for the document \a doc.
+     */
+    TopoDS_Shape share(const App::Document* doc, const TopoDS_Shape& shape);
+    /** Drops \a shape as an owner of the stored shape it shares its TShape with.
+     * Each owner calls this once for every shape it got from share().
+     */
+    void release(const App::Document* doc, const TopoDS_Shape& shape);
+    /** Returns the number of owners of the stored shape that \a shape shares its
+     * TShape with, i.e. the shapes returned by share() and not released yet.
+     * Returns 0 if there is no such shape.
+     */
+    int countInstances(const App::Document* doc, const TopoDS_Shape& shape) const;
+    /** Returns the number of distinct shapes of the document. */
+    std::size_t countShapes(const App::Document* doc) const;
+    void clear(const App::Document* doc);
+
+    /// Checks the user preference whether identical shapes are shared, off by default
+    static bool isEnabled();
+
+private:
+    GeometryStore();
+    ~GeometryStore();
+    GeometryStore(const GeometryStore&);
+    void operator= (const GeometryStore&);
+
+    struct Entry
+    {
+        TopoDS_Shape shape;  /**< The shape without location and orientation. */
+        std::size_t hash;
+        std::string data;    /**< The BRep data, only written once it is compared. */
+        int owners;
+    };
+    struct Shapes
+    {
+        std::list<Entry> entries;
+        std::unordered_multimap<std::size_t, std::list<Entry>::iterator> byHash;
+        std::unordered_map<const void*, std::list<Entry>::iterator> byTShape;
+        std::size_t pruneSize = 64;
+    };
+
+    void prune(Shapes& shapes);
+    void slotDeleteDocument(const App::Document& doc);
+
+    std::unordered_map<const App::Document*, Shapes> documents;
+    mutable std::mutex mutex;
+};
+
+} //namespace Part
+
+#endif // PART_GEOMETRYSTORE_H
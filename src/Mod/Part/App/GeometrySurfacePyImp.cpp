@@ -51,6 +51,7 @@
 
 #include "OCCError.h"
 #include "Geometry.h"
+#include "PartPyCXX.h"
 #include <Mod/Part/App/GeometrySurfacePy.h>
 #include <Mod/Part/App/GeometrySurfacePy.cpp>
 #include <Mod/Part/App/GeometryCurvePy.h>
@@ -382,6 +383,73 @@ PyObject* GeometrySurfacePy::isUmbillic(PyObject *args)
     return 0;
 }
 
+PyObject* GeometrySurfacePy::evaluate(PyObject *args, PyObject *kwds)
+{
+    PyObject* params;
+    PyObject* normals = Py_False;
+    char* type = 0;
+    static char* kwds_evaluate[] = {"Parameters","Normals","Curvature",NULL};
+    if (!PyArg_ParseTupleAndKeywords(args, kwds, "O|O!z", kwds_evaluate, &params,
+                                     &PyBool_Type, &normals, &type))
+        return 0;
+
+    GeomSurface::Curvature t = GeomSurface::Mean;
+    if (type) {
+        if (strcmp(type,"Max") == 0) {
+            t = GeomSurface::Maximum;
+        }
+        else if (strcmp(type,"Min") == 0) {
+            t = GeomSurface::Minimum;
+        }
+        else if (strcmp(type,"Mean") == 0) {
+            t = GeomSurface::Mean;
+        }
+        else if (strcmp(type,"Gauss") == 0) {
+            t = GeomSurface::Gaussian;
+        }
+        else {
+            PyErr_SetString(PyExc_ValueError, "unknown curvature type");
+            return 0;
+        }
+    }
+
+    try {
+        std::vector<double> uv;
+        bool asBuffer = getPyDoubles(params, uv);
+        if (uv.size() % 2 != 0) {
+            PyErr_SetString(PyExc_ValueError, "Parameters must be pairs of (u,v)");
+            return 0;
+        }
+
+        std::size_t count = uv.size() / 2;
+        std::vector<Base::Vector3d> points(count);
+        std::vector<Base::Vector3d> dirs(PyObject_IsTrue(normals) ? count : 0);
+        std::vector<double> values(type ? count : 0);
+        getGeomSurfacePtr()->evaluate(uv.data(), count, points.data(),
+                                      dirs.empty() ? nullptr : dirs.data(),
+                                      values.empty() ? nullptr : values.data(), t);
+
+        Py::Object pnts = vectors2py(points, asBuffer);
+        if (!PyObject_IsTrue(normals) && !type)
+            return Py::new_reference_to(pnts);
+
+        Py::List result;
+        result.append(pnts);
+        if (PyObject_IsTrue(normals))
+            result.append(vectors2py(dirs, asBuffer));
+        if (type)
+            result.append(doubles2py(values, asBuffer));
+        return Py::new_reference_to(Py::Tuple(result));
+    }
+    catch (Py::Exception&) {
+        return 0;
+    }
+    catch (Base::CADKernelError& e) {
+        PyErr_SetString(PartExceptionOCCError, e.what());
+        return 0;
+    }
+}
+
 PyObject* GeometrySurfacePy::curvatureDirections(PyObject *args)
 {
     try {
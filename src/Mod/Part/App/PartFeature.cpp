@@ -24,7 +24,9 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <list>
 # include <sstream>
+# include <tuple>
 # include <gp_Trsf.hxx>
 # include <gp_Ax1.hxx>
 # include <BRepBuilderAPI_MakeShape.hxx>
@@ -52,6 +54,9 @@
 # include <gce_MakeDir.hxx>
 #endif
 
+#include <QMutex>
+#include <QMutexLocker>
+
 #include <boost/algorithm/string/predicate.hpp>
 #include <boost_bind_bind.hpp>
 #include <Base/Console.h>
@@ -70,6 +75,7 @@
 
 #include "PartPyCXX.h"
 #include "PartFeature.h"
+#include "GeometryStore.h"
 #include "PartFeaturePy.h"
 #include "TopoShapePy.h"
 
@@ -78,6 +84,195 @@ namespace bp = boost::placeholders;
 
 FC_LOG_LEVEL_INIT("Part",true,true)
 
+namespace {
+
+/** Cache of the shapes returned by Feature::getTopoShape() and of the
+ * sub-elements extracted by Feature::getSubObject().
+ *
+ * The cache is bounded by the estimated memory of the cached shapes, the
+ * least recently used entries are dropped first. The limit is taken from
+ * the parameter Mod/Part/General/ShapeCacheSize in MB. All access is
+ * serialized so that the cache can be used from worker threads.
+ */
+struct ShapeCache {
+
+    // (object, subname, is sub-element)
+    typedef std::tuple<const App::DocumentObject*, std::string, bool> Key;
+
+    struct Entry {
+        const App::Document *doc;
+        Key key;
+        TopoShape shape;
+        std::size_t memSize;
+    };
+    typedef std::list<Entry> EntryList;
+
+    // most recently used entry first
+    EntryList lru;
+    std::unordered_map<const App::Document*, std::map<Key, EntryList::iterator> > cache;
+
+    QMutex mutex;
+    std::size_t memSize = 0;
+    std::size_t maxMemSize = 0;
+    std::size_t hits = 0;
+    std::size_t misses = 0;
+
+    bool inited = false;
+    void init() {
+        if(inited)
+            return;
+        inited = true;
+        ParameterGrp::handle hGrp = App::GetApplication().GetParameterGroupByPath(
+                "User parameter:BaseApp/Preferences/Mod/Part/General");
+        maxMemSize = static_cast<std::size_t>(std::max(hGrp->GetInt("ShapeCacheSize", 256), 0L)) << 20;
+        App::GetApplication().signalDeleteDocument.connect(
+                boost::bind(&ShapeCache::slotDeleteDocument, this, bp::_1));
+        App::GetApplication().signalDeletedObject.connect(
+                boost::bind(&ShapeCache::slotClear, this, bp::_1));
+        App::GetApplication().signalChangedObject.connect(
+                boost::bind(&ShapeCache::slotChanged, this, bp::_1,bp::_2));
+    }
+
+    // A rough estimate of the memory of the shape that is cheap to compute.
+    // Cached shapes usually share most of their data with the shape of the
+    // owner object, so this rather counts the references held by the cache.
+    static std::size_t estimateSize(const TopoShape &shape) {
+        std::size_t size = sizeof(Entry) + 64;
+        if(shape.isNull())
+            return size;
+        TopTools_IndexedMapOfShape map;
+        TopExp::MapShapes(shape.getShape(), map);
+        return size + map.Extent() * (sizeof(TopoDS_Shape) + sizeof(TopoDS_TShape) + 64);
+    }
+
+    void erase(std::map<Key, EntryList::iterator>::iterator it) {
+        memSize -= it->second->memSize;
+        lru.erase(it->second);
+    }
+
+    void slotDeleteDocument(const App::Document &doc) {
+        QMutexLocker lock(&mutex);
+        auto it = cache.find(&doc);
+        if(it==cache.end())
+            return;
+        for(auto it2=it->second.begin(); it2!=it->second.end(); ++it2)
+            erase(it2);
+        cache.erase(it);
+    }
+
+    void slotChanged(const App::DocumentObject &obj, const App::Property &prop) {
+        const char *propName = prop.getName();
+        if(!propName)
+            return;
+        if(strcmp(propName,"Shape")==0 
+                || strcmp(propName,"Group")==0 
+                || strstr(propName,"Touched")!=0)
+            slotClear(obj);
+    }
+
+    void slotClear(const App::DocumentObject &obj) {
+        QMutexLocker lock(&mutex);
+        auto it = cache.find(obj.getDocument());
+        if(it==cache.end())
+            return;
+        auto &map = it->second;
+        for(auto it2=map.lower_bound(Key(&obj,std::string(),false));
+                it2!=map.end() && std::get<0>(it2->first)==&obj;)
+        {
+            erase(it2);
+            it2 = map.erase(it2);
+        }
+    }
+
+    void clear() {
+        QMutexLocker lock(&mutex);
+        cache.clear();
+        lru.clear();
+        memSize = 0;
+        hits = 0;
+        misses = 0;
+    }
+
+    bool getShape(const App::DocumentObject *obj, TopoShape &shape, 
+            const char *subname=0, bool element=false) 
+    {
+        QMutexLocker lock(&mutex);
+        init();
+        if(!subname) subname = "";
+        auto it = cache.find(obj->getDocument());
+        if(it!=cache.end()) {
+            auto it2 = it->second.find(Key(obj,subname,element));
+            if(it2!=it->second.end()) {
+                lru.splice(lru.begin(), lru, it2->second);
+                shape = it2->second->shape;
+                if(!shape.isNull()) {
+                    ++hits;
+                    return true;
+                }
+            }
+        }
+        ++misses;
+        return false;
+    }
+
+    void setShape(const App::DocumentObject *obj, const TopoShape &shape, 
+            const char *subname=0, bool element=false) 
+    {
+        std::size_t size = estimateSize(shape);
+
+        QMutexLocker lock(&mutex);
+        init();
+        if(!subname) subname = "";
+        auto doc = obj->getDocument();
+        auto &map = cache[doc];
+        Key key(obj,subname,element);
+        auto it = map.find(key);
+        if(it!=map.end()) {
+            erase(it);
+            map.erase(it);
+        }
+        if(size > maxMemSize)
+            return;
+
+        Entry entry;
+        entry.doc = doc;
+        entry.key = key;
+        entry.shape = shape;
+        entry.memSize = size;
+        lru.push_front(entry);
+        map[key] = lru.begin();
+        memSize += size;
+
+        while(memSize > maxMemSize && !lru.empty()) {
+            auto &last = lru.back();
+            auto &lastMap = cache[last.doc];
+            memSize -= last.memSize;
+            lastMap.erase(last.key);
+            lru.pop_back();
+        }
+    }
+};
+
+ShapeCache &shapeCache() {
+    static ShapeCache *cache = new ShapeCache;
+    return *cache;
+}
+
+// The sub-element of the untransformed shape of the feature, taken from the
+// shape cache if possible
+TopoShape getCachedElement(const Feature *feat, const TopoDS_Shape &shape, const char *element)
+{
+    TopoShape res;
+    if(feat->getNameInDocument() && shapeCache().getShape(feat,res,element,true))
+        return res;
+    res = TopoShape(shape.Located(TopLoc_Location())).getSubShape(element);
+    if(feat->getNameInDocument())
+        shapeCache().setShape(feat,res,element,true);
+    return res;
+}
+
+} // namespace
+
 PROPERTY_SOURCE(Part::Feature, App::GeoFeature)
 
 
@@ -150,10 +345,16 @@ App::DocumentObject *Feature::getSubObject(const char *subname,
     try {
         TopoShape ts(Shape.getShape());
         bool doTransform = mat!=ts.getTransform();
-        if(doTransform) 
+        if(subname && *subname && !ts.isNull()) {
+            // The sub-element is always extracted from the untransformed
+            // shape and cached, so that repeated queries of the same element
+            // do not have to map all sub-shapes again.
+            TopLoc_Location loc = ts.getShape().Location();
+            ts = getCachedElement(this,ts.getShape(),subname);
+            if(!doTransform && !ts.isNull())
+                ts.setShape(ts.getShape().Moved(loc));
+        } else if(doTransform)
             ts.setShape(ts.getShape().Located(TopLoc_Location()));
-        if(subname && *subname && !ts.isNull())
-            ts = ts.getSubShape(subname);
         if(doTransform && !ts.isNull()) {
             static int sCopy = -1; 
             if(sCopy<0) {
@@ -205,6 +406,17 @@ App::DocumentObject *Feature::getSubObject(const char *subname,
     }
 }
 
+TopoDS_Shape Feature::getElementShape(const char *element) const
+{
+    const TopoDS_Shape &shape = Shape.getValue();
+    if(shape.IsNull())
+        Standard_Failure::Raise("Cannot get sub-shape from empty shape");
+    TopoDS_Shape res = getCachedElement(this,shape,element).getShape();
+    if(res.IsNull())
+        return res;
+    return res.Moved(shape.Location());
+}
+
 TopoDS_Shape Feature::getShape(const App::DocumentObject *obj, const char *subname, 
         bool needSubElement, Base::Matrix4D *pmat, App::DocumentObject **powner, 
         bool resolveLink, bool transform) 
@@ -212,72 +424,21 @@ TopoDS_Shape Feature::getShape(const App::DocumentObject *obj, const char *subna
     return getTopoShape(obj,subname,needSubElement,pmat,powner,resolveLink,transform,true).getShape();
 }
 
-struct ShapeCache {
-
-    std::unordered_map<const App::Document*,
-        std::map<std::pair<const App::DocumentObject*, std::string> ,TopoShape> > cache;
-
-    bool inited = false;
-    void init() {
-        if(inited)
-            return;
-        inited = true;
-        App::GetApplication().signalDeleteDocument.connect(
-                boost::bind(&ShapeCache::slotDeleteDocument, this, bp::_1));
-        App::GetApplication().signalDeletedObject.connect(
-                boost::bind(&ShapeCache::slotClear, this, bp::_1));
-        App::GetApplication().signalChangedObject.connect(
-                boost::bind(&ShapeCache::slotChanged, this, bp::_1,bp::_2));
-    }
-
-    void slotDeleteDocument(const App::Document &doc) {
-        cache.erase(&doc);
-    }
-
-    void slotChanged(const App::DocumentObject &obj, const App::Property &prop) {
-        const char *propName = prop.getName();
-        if(!propName)
-            return;
-        if(strcmp(propName,"Shape")==0 
-                || strcmp(propName,"Group")==0 
-                || strstr(propName,"Touched")!=0)
-            slotClear(obj);
-    }
-
-    void slotClear(const App::DocumentObject &obj) {
-        auto it = cache.find(obj.getDocument());
-        if(it==cache.end())
-            return;
-        auto &map = it->second;
-        for(auto it2=map.lower_bound(std::make_pair(&obj,std::string()));
-                it2!=map.end() && it2->first.first==&obj;)
-        {
-            it2 = map.erase(it2);
-        }
-    }
-
-    bool getShape(const App::DocumentObject *obj, TopoShape &shape, const char *subname=0) {
-        init();
-        auto &entry = cache[obj->getDocument()];
-        if(!subname) subname = "";
-        auto it = entry.find(std::make_pair(obj,std::string(subname)));
-        if(it!=entry.end()) {
-            shape = it->second;
-            return !shape.isNull();
-        }
-        return false;
-    }
-
-    void setShape(const App::DocumentObject *obj, const TopoShape &shape, const char *subname=0) {
-        init();
-        if(!subname) subname = "";
-        cache[obj->getDocument()][std::make_pair(obj,std::string(subname))] = shape;
-    }
-};
-static ShapeCache _ShapeCache;
-
 void Feature::clearShapeCache() {
-    _ShapeCache.cache.clear();
+    shapeCache().clear();
+}
+
+Feature::ShapeCacheInfo Feature::getShapeCacheInfo() {
+    auto &cache = shapeCache();
+    QMutexLocker lock(&cache.mutex);
+    cache.init();
+    ShapeCacheInfo info;
+    info.hits = cache.hits;
+    info.misses = cache.misses;
+    info.entries = cache.lru.size();
+    info.memSize = cache.memSize;
+    info.maxMemSize = cache.maxMemSize;
+    return info;
 }
 
 static TopoShape _getTopoShape(const App::DocumentObject *obj, const char *subname, 
@@ -303,7 +464,7 @@ static TopoShape _getTopoShape(const App::DocumentObject *obj, const char *subna
         }
     }
 
-    if(_ShapeCache.getShape(obj,shape,subname)) {
+    if(shapeCache().getShape(obj,shape,subname)) {
         if(noElementMap) {
             // shape.resetElementMap();
             // shape.Tag = 0;
@@ -342,7 +503,7 @@ static TopoShape _getTopoShape(const App::DocumentObject *obj, const char *subna
             shape = *static_cast<TopoShapePy*>(pyobj)->getTopoShapePtr();
             if(!shape.isNull()) {
                 if(obj->getDocument() != linked->getDocument())
-                    _ShapeCache.setShape(obj,shape,subname);
+                    shapeCache().setShape(obj,shape,subname);
                 if(noElementMap) {
                     // shape.resetElementMap();
                     // shape.Tag = 0;
@@ -362,13 +523,13 @@ static TopoShape _getTopoShape(const App::DocumentObject *obj, const char *subna
 
     bool scaled = false;
     if(obj!=owner) {
-        if(_ShapeCache.getShape(owner,shape)) {
+        if(shapeCache().getShape(owner,shape)) {
             auto scaled = shape.transformShape(mat,false,true);
             if(owner->getDocument()!=obj->getDocument()) {
                 // shape.reTagElementMap(obj->getID(),obj->getDocument()->getStringHasher());
-                _ShapeCache.setShape(obj,shape,subname);
+                shapeCache().setShape(obj,shape,subname);
             } else if(scaled)
-                _ShapeCache.setShape(obj,shape,subname);
+                shapeCache().setShape(obj,shape,subname);
         }
         if(!shape.isNull()) {
             if(noElementMap) {
@@ -469,15 +630,15 @@ static TopoShape _getTopoShape(const App::DocumentObject *obj, const char *subna
         shape.makECompound(shapes);
     }
 
-    _ShapeCache.setShape(owner,shape);
+    shapeCache().setShape(owner,shape);
 
     if(owner!=obj) {
         scaled = shape.transformShape(mat,false,true);
         if(owner->getDocument()!=obj->getDocument()) {
             // shape.reTagElementMap(obj->getID(),obj->getDocument()->getStringHasher());
-            _ShapeCache.setShape(obj,shape,subname);
+            shapeCache().setShape(obj,shape,subname);
         }else if(scaled)
-            _ShapeCache.setShape(obj,shape,subname);
+            shapeCache().setShape(obj,shape,subname);
     }
     if(noElementMap) {
         // shape.resetElementMap();
@@ -550,6 +711,24 @@ void Feature::onChanged(const App::Property* prop)
             shape.setTransform(this->Placement.getValue().toMatrix());
         }
         else {
+            // Non-parametric features, e.g. of imported parts, share the data of
+            // shapes that only differ in their placement
+            if (getTypeId() == Feature::getClassTypeId() && GeometryStore::isEnabled()) {
+                // a shape that only got a new placement is still counted
+                TopoDS_Shape shape = this->Shape.getValue();
+                if (!shape.IsPartner(sharedShape)) {
+                    GeometryStore& store = GeometryStore::instance();
+                    TopoDS_Shape shared = store.share(getDocument(), shape);
+                    store.release(getDocument(), sharedShape);
+                    sharedShape = shared;
+                    if (!shared.IsEqual(shape)) {
+                        // the nested change notifies the observers with the shared shape
+                        this->Shape.setValue(shared);
+                        return;
+                    }
+                }
+            }
+
             Base::Placement p;
             // shape must not be null to override the placement
             if (!this->Shape.getValue().IsNull()) {
@@ -563,6 +742,13 @@ void Feature::onChanged(const App::Property* prop)
     GeoFeature::onChanged(prop);
 }
 
+void Feature::unsetupObject()
+{
+    GeometryStore::instance().release(getDocument(), sharedShape);
+    sharedShape.Nullify();
+    GeoFeature::unsetupObject();
+}
+
 TopLoc_Location Feature::getLocation() const
 {
     Base::Placement pl = this->Placement.getValue();
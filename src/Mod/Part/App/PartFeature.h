@@ -71,6 +71,14 @@ public:
     virtual DocumentObject *getSubObject(const char *subname, PyObject **pyObj, 
             Base::Matrix4D *mat, bool transform, int depth) const override;
 
+    /** Returns the sub-element \a element of the shape, e.g. "Face3", located
+     * like the shape. The elements are kept in the shape cache until the shape
+     * changes, so that repeated lookups of the same element, e.g. by the many
+     * objects attached to it, do not map all sub-shapes again. Throws
+     * Standard_Failure if there is no such element.
+     */
+    TopoDS_Shape getElementShape(const char *element) const;
+
     /** Convenience function to extract shape from fully qualified subname 
      *
      * @param obj: the parent object
@@ -102,6 +110,16 @@ public:
 
     static void clearShapeCache();
 
+    /// Statistics of the shape cache used by getTopoShape()
+    struct ShapeCacheInfo {
+        std::size_t hits = 0;       ///< number of lookups that found a shape
+        std::size_t misses = 0;     ///< number of lookups that did not
+        std::size_t entries = 0;    ///< number of cached shapes
+        std::size_t memSize = 0;    ///< estimated memory of the cached shapes in bytes
+        std::size_t maxMemSize = 0; ///< memory limit of the cache in bytes
+    };
+    static ShapeCacheInfo getShapeCacheInfo();
+
     static App::DocumentObject *getShapeOwner(const App::DocumentObject *obj, const char *subname=0);
 
     static bool hasShapeOwner(const App::DocumentObject *obj, const char *subname=0) {
@@ -115,6 +133,7 @@ protected:
     /// recalculate the feature
     virtual App::DocumentObjectExecReturn *execute() override;
     virtual void onChanged(const App::Property* prop) override;
+    virtual void unsetupObject() override;
     /**
      * Build a history of changes
      * MakeShape: The operation that created the changes, e.g. BRepAlgoAPI_Common
@@ -125,6 +144,9 @@ protected:
     ShapeHistory buildHistory(BRepBuilderAPI_MakeShape&, TopAbs_ShapeEnum type,
         const TopoDS_Shape& newS, const TopoDS_Shape& oldS);
     ShapeHistory joinHistory(const ShapeHistory&, const ShapeHistory&);
+
+private:
+    TopoDS_Shape sharedShape; /**< The shape counted as an owner in the GeometryStore. */
 };
 
 class FilletBase : public Part::Feature
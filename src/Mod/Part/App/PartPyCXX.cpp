@@ -21,8 +21,10 @@
  ***************************************************************************/
 
 #include "PreCompiled.h"
+#include <cstring>
 #include "PartPyCXX.h"
 #include <CXX/Objects.hxx>
+#include <Base/GeometryPyCXX.h>
 #include <Mod/Part/App/TopoShapeFacePy.h>
 #include <Mod/Part/App/TopoShapeEdgePy.h>
 #include <Mod/Part/App/TopoShapeWirePy.h>
@@ -84,6 +86,93 @@ PartExport Py::Object shape2pyshape(const TopoDS_Shape &shape) {
     return shape2pyshape(TopoShape(shape));
 }
 
+PartExport bool getPyDoubles(PyObject *obj, std::vector<double> &values)
+{
+    if (PyObject_CheckBuffer(obj)) {
+        Py_buffer buf;
+        if (PyObject_GetBuffer(obj, &buf, PyBUF_C_CONTIGUOUS | PyBUF_FORMAT) < 0)
+            throw Py::Exception();
+        if (!buf.format || strcmp(buf.format, "d") != 0 || buf.itemsize != sizeof(double)) {
+            PyBuffer_Release(&buf);
+            throw Py::TypeError("Buffer must hold doubles");
+        }
+        const double* data = static_cast<const double*>(buf.buf);
+        values.assign(data, data + buf.len / sizeof(double));
+        PyBuffer_Release(&buf);
+        return true;
+    }
+
+    Py::Sequence list(obj);
+    values.reserve(values.size() + list.size());
+    for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+        if (PySequence_Check((*it).ptr())) {
+            Py::Sequence item(*it);
+            for (Py::Sequence::iterator jt = item.begin(); jt != item.end(); ++jt)
+                values.push_back(static_cast<double>(Py::Float(*jt)));
+        }
+        else {
+            values.push_back(static_cast<double>(Py::Float(*it)));
+        }
+    }
+    return false;
+}
+
+namespace {
+// Returns a memoryview of doubles with the given shape that owns a copy of the data
+Py::Object doubleBuffer(const double* data, std::size_t rows, std::size_t cols)
+{
+    std::size_t count = rows * cols;
+    Py::Object bytes(PyByteArray_FromStringAndSize(reinterpret_cast<const char*>(data),
+                     static_cast<Py_ssize_t>(count * sizeof(double))), true);
+    Py::Object view(PyMemoryView_FromObject(bytes.ptr()), true);
+    if (count == 0)
+        return view.callMemberFunction("cast", Py::TupleN(Py::String("d")));
+    Py::Tuple shape(cols > 1 ? 2 : 1);
+    shape.setItem(0, Py::Long(static_cast<long>(rows)));
+    if (cols > 1)
+        shape.setItem(1, Py::Long(static_cast<long>(cols)));
+    return view.callMemberFunction("cast", Py::TupleN(Py::String("d"), shape));
+}
+}
+
+PartExport Py::Object vectors2py(const std::vector<Base::Vector3d> &vecs, bool asBuffer)
+{
+#if PY_MAJOR_VERSION >= 3
+    if (asBuffer) {
+        std::vector<double> data;
+        data.reserve(3 * vecs.size());
+        for (std::vector<Base::Vector3d>::const_iterator it = vecs.begin(); it != vecs.end(); ++it) {
+            data.push_back(it->x);
+            data.push_back(it->y);
+            data.push_back(it->z);
+        }
+        return doubleBuffer(data.data(), vecs.size(), 3);
+    }
+#else
+    (void)asBuffer;
+#endif
+
+    Py::List list(vecs.size());
+    for (std::size_t i = 0; i < vecs.size(); i++)
+        list.setItem(i, Py::Vector(vecs[i]));
+    return list;
+}
+
+PartExport Py::Object doubles2py(const std::vector<double> &values, bool asBuffer)
+{
+#if PY_MAJOR_VERSION >= 3
+    if (asBuffer)
+        return doubleBuffer(values.data(), values.size(), 1);
+#else
+    (void)asBuffer;
+#endif
+
+    Py::List list(values.size());
+    for (std::size_t i = 0; i < values.size(); i++)
+        list.setItem(i, Py::Float(values[i]));
+    return list;
+}
+
 } //namespace Part
 
 
@@ -24,6 +24,7 @@
 #define PART_PYCXX_H
 
 #include <CXX/Extensions.hxx>
+#include <Base/Vector3D.h>
 #include <Mod/Part/App/TopoShapePy.h>
 
 namespace Py {
@@ -37,6 +38,15 @@ namespace Part {
     PartExport Py::Object shape2pyshape(const TopoDS_Shape &shape);
     PartExport void getPyShapes(PyObject *obj, std::vector<TopoShape> &shapes);
     PartExport std::vector<TopoShape> getPyShapes(PyObject *obj);
+
+    /// Reads the floats of a (nested) sequence or of a buffer of doubles into \a values.
+    /// Returns true if \a obj is a buffer.
+    PartExport bool getPyDoubles(PyObject *obj, std::vector<double> &values);
+    /// Returns the vectors as list of Base.Vector or, if \a asBuffer is true, as memoryview
+    /// of doubles of shape (n,3).
+    PartExport Py::Object vectors2py(const std::vector<Base::Vector3d> &vecs, bool asBuffer);
+    /// Returns the values as list of floats or, if \a asBuffer is true, as memoryview of doubles.
+    PartExport Py::Object doubles2py(const std::vector<double> &values, bool asBuffer);
 }
 
 #endif //PART_PYCXX_H
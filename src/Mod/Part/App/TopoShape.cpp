@@ -1951,11 +1951,8 @@ std::list<TopoDS_Wire> TopoShape::slice(const Base::Vector3d& dir, double d) con
 
 TopoDS_Compound TopoShape::slices(const Base::Vector3d& dir, const std::vector<double>& d) const
 {
-    std::vector< std::list<TopoDS_Wire> > wire_list;
     CrossSection cs(dir.x, dir.y, dir.z, this->_Shape);
-    for (std::vector<double>::const_iterator jt = d.begin(); jt != d.end(); ++jt) {
-        wire_list.push_back(cs.slice(*jt));
-    }
+    std::vector< std::list<TopoDS_Wire> > wire_list = cs.slices(d);
 
     std::vector< std::list<TopoDS_Wire> >::const_iterator ft;
     TopoDS_Compound comp;
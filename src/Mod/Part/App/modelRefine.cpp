@@ -25,6 +25,7 @@
 
 #ifndef _PreComp_
 # include <algorithm>
+# include <cmath>
 # include <iterator>
 # include <Geom_Surface.hxx>
 # include <Geom_RectangularTrimmedSurface.hxx>
@@ -73,6 +74,8 @@
 #include <Base/Console.h>
 #include <Base/Tools.h>
 
+#include <QtConcurrentMap>
+
 #include "modelRefine.h"
 
 
@@ -203,18 +206,18 @@ FaceAdjacencySplitter::FaceAdjacencySplitter(const TopoDS_Shell &shell)
 
 void FaceAdjacencySplitter::split(const FaceVectorType &facesIn)
 {
-    facesInMap.Clear();
-    processedMap.Clear();
     adjacencyArray.clear();
+    split(facesIn, adjacencyArray);
+}
+
+void FaceAdjacencySplitter::split(const FaceVectorType &facesIn, std::vector<FaceVectorType> &groupsOut) const
+{
+    TopTools_MapOfShape facesInMap;
+    TopTools_MapOfShape processedMap;
 
     FaceVectorType::const_iterator it;
     for (it = facesIn.begin(); it != facesIn.end(); ++it)
         facesInMap.Add(*it);
-    //the reserve call guarantees the vector will never get "pushed back" in the
-    //recursiveFind calls, thus invalidating the iterators. We can be sure of this as any one
-    //matched set can't be bigger than the set passed in. if we have seg faults, we will
-    //want to turn this tempFaces vector back into a std::list ensuring valid iterators
-    //at the expense of std::find speed.
     FaceVectorType tempFaces;
     tempFaces.reserve(facesIn.size() + 1);
 
@@ -226,33 +229,61 @@ void FaceAdjacencySplitter::split(const FaceVectorType &facesIn)
 
         tempFaces.clear();
         processedMap.Add(*it);
-        recursiveFind(*it, tempFaces);
+        findAdjacent(*it, facesInMap, processedMap, tempFaces);
         if (tempFaces.size() > 1)
         {
-            adjacencyArray.push_back(tempFaces);
+            groupsOut.push_back(tempFaces);
         }
     }
 }
 
-void FaceAdjacencySplitter::recursiveFind(const TopoDS_Face &face, FaceVectorType &outVector)
+void FaceAdjacencySplitter::findAdjacent(const TopoDS_Face &face, const TopTools_MapOfShape &facesInMap,
+                                         TopTools_MapOfShape &processedMap, FaceVectorType &outVector) const
 {
-    outVector.push_back(face);
-
-    const TopTools_ListOfShape &edges = faceToEdgeMap.FindFromKey(face);
-    TopTools_ListIteratorOfListOfShape edgeIt;
-    for (edgeIt.Initialize(edges); edgeIt.More(); edgeIt.Next())
+    //depth-first search with an explicit stack to not overflow the call stack for
+    //large groups. The faces are visited in the same order as by a recursive search.
+    struct Frame
     {
-        const TopTools_ListOfShape &faces = edgeToFaceMap.FindFromKey(edgeIt.Value());
+        TopTools_ListIteratorOfListOfShape edgeIt;
         TopTools_ListIteratorOfListOfShape faceIt;
-        for (faceIt.Initialize(faces); faceIt.More(); faceIt.Next())
+    };
+    auto pushFrame = [this](std::vector<Frame> &stack, const TopoDS_Shape &current)
+    {
+        Frame frame;
+        frame.edgeIt.Initialize(faceToEdgeMap.FindFromKey(current));
+        if (frame.edgeIt.More())
+            frame.faceIt.Initialize(edgeToFaceMap.FindFromKey(frame.edgeIt.Value()));
+        stack.push_back(frame);
+    };
+
+    outVector.push_back(face);
+    std::vector<Frame> stack;
+    pushFrame(stack, face);
+    while (!stack.empty())
+    {
+        Frame &frame = stack.back();
+        if (!frame.edgeIt.More())
         {
-            if (!facesInMap.Contains(faceIt.Value()))
-                continue;
-            if (processedMap.Contains(faceIt.Value()))
-                continue;
-            processedMap.Add(faceIt.Value());
-            recursiveFind(TopoDS::Face(faceIt.Value()), outVector);
+            stack.pop_back();
+            continue;
         }
+        if (!frame.faceIt.More())
+        {
+            frame.edgeIt.Next();
+            if (frame.edgeIt.More())
+                frame.faceIt.Initialize(edgeToFaceMap.FindFromKey(frame.edgeIt.Value()));
+            continue;
+        }
+
+        TopoDS_Shape next = frame.faceIt.Value();
+        frame.faceIt.Next();
+        if (!facesInMap.Contains(next))
+            continue;
+        if (processedMap.Contains(next))
+            continue;
+        processedMap.Add(next);
+        outVector.push_back(TopoDS::Face(next));
+        pushFrame(stack, next);
     }
 }
 
@@ -260,28 +291,66 @@ void FaceAdjacencySplitter::recursiveFind(const TopoDS_Face &face, FaceVectorTyp
 
 void FaceEqualitySplitter::split(const FaceVectorType &faces, FaceTypedBase *object)
 {
-    std::vector<FaceVectorType> tempVector;
-    tempVector.reserve(faces.size());
+    SurfaceVectorType surfaces;
+    surfaces.reserve(faces.size());
     FaceVectorType::const_iterator faceIt;
     for (faceIt = faces.begin(); faceIt != faces.end(); ++faceIt)
+        surfaces.push_back(BRep_Tool::Surface(*faceIt));
+    split(faces, surfaces, object);
+}
+
+void FaceEqualitySplitter::split(const FaceVectorType &faces, const SurfaceVectorType &surfaces, FaceTypedBase *object)
+{
+    //a face is added to the first group with an equal surface. The groups are sorted
+    //into buckets by the key of their first surface so that only groups in the same or
+    //the neighbouring buckets must be compared.
+    std::vector<FaceVectorType> tempVector;
+    std::vector<std::size_t> frontIndexes;
+    std::multimap<long long, std::size_t> buckets;
+    std::vector<std::size_t> candidates;
+    tempVector.reserve(faces.size());
+    for (std::size_t index = 0; index < faces.size(); ++index)
     {
+        double key, tolerance;
+        bool hasKey = object->getKey(surfaces[index], key, tolerance);
+        long long bucket = 0;
+        candidates.clear();
+        if (hasKey)
+        {
+            bucket = static_cast<long long>(std::floor(key / tolerance));
+            for (long long neighbour = bucket - 1; neighbour <= bucket + 1; ++neighbour)
+            {
+                auto range = buckets.equal_range(neighbour);
+                for (auto it = range.first; it != range.second; ++it)
+                    candidates.push_back(it->second);
+            }
+            std::sort(candidates.begin(), candidates.end());
+        }
+        else
+        {
+            for (std::size_t group = 0; group < tempVector.size(); ++group)
+                candidates.push_back(group);
+        }
+
         bool foundMatch(false);
-        std::vector<FaceVectorType>::iterator tempIt;
-        for (tempIt = tempVector.begin(); tempIt != tempVector.end(); ++tempIt)
+        std::vector<std::size_t>::iterator tempIt;
+        for (tempIt = candidates.begin(); tempIt != candidates.end(); ++tempIt)
         {
-            if (object->isEqual((*tempIt).front(), *faceIt))
+            if (object->isEqual(surfaces[frontIndexes[*tempIt]], surfaces[index]))
             {
-                (*tempIt).push_back(*faceIt);
+                tempVector[*tempIt].push_back(faces[index]);
                 foundMatch = true;
                 break;
             }
         }
         if (!foundMatch)
         {
+            if (hasKey)
+                buckets.insert(std::make_pair(bucket, tempVector.size()));
             FaceVectorType another;
-            another.reserve(faces.size());
-            another.push_back(*faceIt);
+            another.push_back(faces[index]);
             tempVector.push_back(another);
+            frontIndexes.push_back(index);
         }
     }
     std::vector<FaceVectorType>::iterator it;
@@ -295,6 +364,11 @@ void FaceEqualitySplitter::split(const FaceVectorType &faces, FaceTypedBase *obj
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool FaceTypedBase::getKey(const Handle(Geom_Surface) &, double &, double &) const
+{
+    return false;
+}
+
 GeomAbs_SurfaceType FaceTypedBase::getFaceType(const TopoDS_Face &faceIn)
 {
     Handle(Geom_Surface) surface = BRep_Tool::Surface(faceIn);
@@ -355,10 +429,9 @@ FaceTypedPlane::FaceTypedPlane() : FaceTypedBase(GeomAbs_Plane)
 {
 }
 
-static Handle(Geom_Plane) getGeomPlane(const TopoDS_Face &faceIn)
+static Handle(Geom_Plane) getGeomPlane(const Handle(Geom_Surface) &surface)
 {
   Handle(Geom_Plane) planeSurfaceOut;
-  Handle(Geom_Surface) surface = BRep_Tool::Surface(faceIn);
   if (!surface.IsNull())
   {
     planeSurfaceOut = Handle(Geom_Plane)::DownCast(surface);
@@ -375,8 +448,13 @@ static Handle(Geom_Plane) getGeomPlane(const TopoDS_Face &faceIn)
 
 bool FaceTypedPlane::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const
 {
-  Handle(Geom_Plane) planeSurfaceOne = getGeomPlane(faceOne);
-  Handle(Geom_Plane) planeSurfaceTwo = getGeomPlane(faceTwo);
+    return isEqual(BRep_Tool::Surface(faceOne), BRep_Tool::Surface(faceTwo));
+}
+
+bool FaceTypedPlane::isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const
+{
+  Handle(Geom_Plane) planeSurfaceOne = getGeomPlane(surfaceOne);
+  Handle(Geom_Plane) planeSurfaceTwo = getGeomPlane(surfaceTwo);
   if (planeSurfaceOne.IsNull() || planeSurfaceTwo.IsNull())
       return false;//error?
 
@@ -386,6 +464,21 @@ bool FaceTypedPlane::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &face
             planeOne.Distance(planeTwo.Position().Location()) < Precision::Confusion());
 }
 
+bool FaceTypedPlane::getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const
+{
+    //equal planes have parallel normals. The normal is projected onto a fixed direction that is
+    //not parallel to any axis, so that the key doesn't depend on the size of the model or the
+    //orientation of the normal. The distance to the origin is left out because it changes by
+    //the angular tolerance times the distance of the plane's location.
+    Handle(Geom_Plane) planeSurface = getGeomPlane(surface);
+    if (planeSurface.IsNull())
+        return false;
+    static const gp_Dir reference(1.0, 2.0, 3.0);
+    key = std::fabs(planeSurface->Pln().Axis().Direction().Dot(reference));
+    tolerance = 10.0 * Precision::Confusion();
+    return true;
+}
+
 GeomAbs_SurfaceType FaceTypedPlane::getType() const
 {
     return GeomAbs_Plane;
@@ -446,10 +539,9 @@ FaceTypedCylinder::FaceTypedCylinder() : FaceTypedBase(GeomAbs_Cylinder)
 {
 }
 
-static Handle(Geom_CylindricalSurface) getGeomCylinder(const TopoDS_Face &faceIn)
+static Handle(Geom_CylindricalSurface) getGeomCylinder(const Handle(Geom_Surface) &surface)
 {
   Handle(Geom_CylindricalSurface) cylinderSurfaceOut;
-  Handle(Geom_Surface) surface = BRep_Tool::Surface(faceIn);
   if (!surface.IsNull())
   {
     cylinderSurfaceOut = Handle(Geom_CylindricalSurface)::DownCast(surface);
@@ -466,12 +558,17 @@ static Handle(Geom_CylindricalSurface) getGeomCylinder(const TopoDS_Face &faceIn
 
 bool FaceTypedCylinder::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const
 {
-    Handle(Geom_CylindricalSurface) surfaceOne = getGeomCylinder(faceOne);
-    Handle(Geom_CylindricalSurface) surfaceTwo = getGeomCylinder(faceTwo);
-    if (surfaceOne.IsNull() || surfaceTwo.IsNull())
+    return isEqual(BRep_Tool::Surface(faceOne), BRep_Tool::Surface(faceTwo));
+}
+
+bool FaceTypedCylinder::isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const
+{
+    Handle(Geom_CylindricalSurface) cylinderSurfaceOne = getGeomCylinder(surfaceOne);
+    Handle(Geom_CylindricalSurface) cylinderSurfaceTwo = getGeomCylinder(surfaceTwo);
+    if (cylinderSurfaceOne.IsNull() || cylinderSurfaceTwo.IsNull())
         return false;//probably need an error
-    gp_Cylinder cylinderOne = surfaceOne->Cylinder();
-    gp_Cylinder cylinderTwo = surfaceTwo->Cylinder();
+    gp_Cylinder cylinderOne = cylinderSurfaceOne->Cylinder();
+    gp_Cylinder cylinderTwo = cylinderSurfaceTwo->Cylinder();
 
     if (fabs(cylinderOne.Radius() - cylinderTwo.Radius()) > Precision::Confusion())
         return false;
@@ -482,6 +579,17 @@ bool FaceTypedCylinder::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &f
     return true;
 }
 
+bool FaceTypedCylinder::getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const
+{
+    //equal cylinders have the same radius
+    Handle(Geom_CylindricalSurface) cylinderSurface = getGeomCylinder(surface);
+    if (cylinderSurface.IsNull())
+        return false;
+    key = cylinderSurface->Radius();
+    tolerance = Precision::Confusion();
+    return true;
+}
+
 GeomAbs_SurfaceType FaceTypedCylinder::getType() const
 {
     return GeomAbs_Cylinder;
@@ -651,7 +759,7 @@ TopoDS_Face FaceTypedCylinder::buildFace(const FaceVectorType &faces) const
 
     // Find outer boundary wires that cut the cylinder into segments. This will be the case f we
     // have removed the seam edges of a complete (360 degrees) cylindrical face
-    Handle(Geom_CylindricalSurface) surface = getGeomCylinder(faces.at(0));
+    Handle(Geom_CylindricalSurface) surface = getGeomCylinder(BRep_Tool::Surface(faces.at(0)));
     if (surface.IsNull())
       return dummy;
     std::vector<TopoDS_Wire> innerWires, encirclingWires;
@@ -817,11 +925,16 @@ FaceTypedBSpline::FaceTypedBSpline() : FaceTypedBase(GeomAbs_BSplineSurface)
 }
 
 bool FaceTypedBSpline::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const
+{
+    return isEqual(BRep_Tool::Surface(faceOne), BRep_Tool::Surface(faceTwo));
+}
+
+bool FaceTypedBSpline::isEqual(const Handle(Geom_Surface) &surfaceIn1, const Handle(Geom_Surface) &surfaceIn2) const
 {
   try
   {
-    Handle(Geom_BSplineSurface) surfaceOne = Handle(Geom_BSplineSurface)::DownCast(BRep_Tool::Surface(faceOne));
-    Handle(Geom_BSplineSurface) surfaceTwo = Handle(Geom_BSplineSurface)::DownCast(BRep_Tool::Surface(faceTwo));
+    Handle(Geom_BSplineSurface) surfaceOne = Handle(Geom_BSplineSurface)::DownCast(surfaceIn1);
+    Handle(Geom_BSplineSurface) surfaceTwo = Handle(Geom_BSplineSurface)::DownCast(surfaceIn2);
 
     if (surfaceOne.IsNull() || surfaceTwo.IsNull())
         return false;
@@ -952,6 +1065,17 @@ bool FaceTypedBSpline::isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &fa
   return false;
 }
 
+bool FaceTypedBSpline::getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const
+{
+    //equal surfaces have the same number of poles
+    Handle(Geom_BSplineSurface) bsplineSurface = Handle(Geom_BSplineSurface)::DownCast(surface);
+    if (bsplineSurface.IsNull())
+        return false;
+    key = static_cast<double>(bsplineSurface->NbUPoles()) * 65536.0 + bsplineSurface->NbVPoles();
+    tolerance = 0.5;
+    return true;
+}
+
 GeomAbs_SurfaceType FaceTypedBSpline::getType() const
 {
     return GeomAbs_BSplineSurface;
@@ -1044,38 +1168,65 @@ bool FaceUniter::process()
     ModelRefine::FaceVectorType facesToRemove;
     ModelRefine::FaceVectorType facesToSew;
 
-    ModelRefine::FaceAdjacencySplitter adjacencySplitter(workShell);
+    const ModelRefine::FaceAdjacencySplitter adjacencySplitter(workShell);
 
-    for(typeIt = typeObjects.begin(); typeIt != typeObjects.end(); ++typeIt)
+    //BRep_Tool::Surface() copies the surface of a located face, so the surfaces are
+    //computed once for all comparisons
+    struct TypedFaces
+    {
+        FaceTypedBase *object;
+        FaceVectorType faces;
+        SurfaceVectorType surfaces;
+        std::vector<FaceVectorType> groups;
+    };
+    std::vector<TypedFaces> typedFaces(typeObjects.size());
+    std::vector<std::pair<const TopoDS_Face*, Handle(Geom_Surface)*> > surfaceRefs;
+    for (std::size_t index = 0; index < typeObjects.size(); ++index)
+    {
+        TypedFaces &current = typedFaces[index];
+        current.object = typeObjects[index];
+        current.faces = splitter.getTypedFaceVector(current.object->getType());
+        current.surfaces.resize(current.faces.size());
+        for (std::size_t faceIndex = 0; faceIndex < current.faces.size(); ++faceIndex)
+            surfaceRefs.emplace_back(&current.faces[faceIndex], &current.surfaces[faceIndex]);
+    }
+    QtConcurrent::blockingMap(surfaceRefs, [](std::pair<const TopoDS_Face*, Handle(Geom_Surface)*> &ref)
+    {
+        *ref.second = BRep_Tool::Surface(*ref.first);
+    });
+
+    //the classification only reads the shell, so the face types are done concurrently.
+    //The new faces are built sequentially because that may update the shared edges.
+    QtConcurrent::blockingMap(typedFaces, [&adjacencySplitter](TypedFaces &current)
     {
-        ModelRefine::FaceVectorType typedFaces = splitter.getTypedFaceVector((*typeIt)->getType());
         ModelRefine::FaceEqualitySplitter equalitySplitter;
-        equalitySplitter.split(typedFaces, *typeIt);
+        equalitySplitter.split(current.faces, current.surfaces, current.object);
         for (std::size_t indexEquality(0); indexEquality < equalitySplitter.getGroupCount(); ++indexEquality)
+            adjacencySplitter.split(equalitySplitter.getGroup(indexEquality), current.groups);
+    });
+
+    for (std::vector<TypedFaces>::iterator typedIt = typedFaces.begin(); typedIt != typedFaces.end(); ++typedIt)
+    {
+        for (std::size_t adjacentIndex(0); adjacentIndex < typedIt->groups.size(); ++adjacentIndex)
         {
-            adjacencySplitter.split(equalitySplitter.getGroup(indexEquality));
-//            std::cout << "      adjacency group count: " << adjacencySplitter.getGroupCount() << std::endl;
-            for (std::size_t adjacentIndex(0); adjacentIndex < adjacencySplitter.getGroupCount(); ++adjacentIndex)
+            const FaceVectorType &group = typedIt->groups[adjacentIndex];
+            TopoDS_Face newFace = typedIt->object->buildFace(group);
+            if (!newFace.IsNull())
             {
-//                    std::cout << "         face count is: " << adjacencySplitter.getGroup(adjacentIndex).size() << std::endl;
-                TopoDS_Face newFace = (*typeIt)->buildFace(adjacencySplitter.getGroup(adjacentIndex));
-                if (!newFace.IsNull())
+                facesToSew.push_back(newFace);
+                if (facesToRemove.capacity() <= facesToRemove.size() + group.size())
+                    facesToRemove.reserve(facesToRemove.size() + group.size());
+                FaceVectorType temp = group;
+                facesToRemove.insert(facesToRemove.end(), temp.begin(), temp.end());
+                // the first shape will be marked as modified, i.e. replaced by newFace, all others are marked as deleted
+                // jrheinlaender: IMHO this is not correct because references to the deleted faces will be broken, whereas they should
+                // be replaced by references to the new face. To achieve this all shapes should be marked as
+                // modified, producing one single new face. This is the inverse behaviour to faces that are split e.g.
+                // by a boolean cut, where one old shape is marked as modified, producing multiple new shapes
+                if (!temp.empty())
                 {
-                    facesToSew.push_back(newFace);
-                    if (facesToRemove.capacity() <= facesToRemove.size() + adjacencySplitter.getGroup(adjacentIndex).size())
-                        facesToRemove.reserve(facesToRemove.size() + adjacencySplitter.getGroup(adjacentIndex).size());
-                    FaceVectorType temp = adjacencySplitter.getGroup(adjacentIndex);
-                    facesToRemove.insert(facesToRemove.end(), temp.begin(), temp.end());
-                    // the first shape will be marked as modified, i.e. replaced by newFace, all others are marked as deleted
-                    // jrheinlaender: IMHO this is not correct because references to the deleted faces will be broken, whereas they should
-                    // be replaced by references to the new face. To achieve this all shapes should be marked as
-                    // modified, producing one single new face. This is the inverse behaviour to faces that are split e.g.
-                    // by a boolean cut, where one old shape is marked as modified, producing multiple new shapes
-                    if (!temp.empty())
-                    {
-                        for (FaceVectorType::iterator f = temp.begin(); f != temp.end(); ++f)
-                              modifiedShapes.emplace_back(*f, newFace);
-                    }
+                    for (FaceVectorType::iterator f = temp.begin(); f != temp.end(); ++f)
+                          modifiedShapes.emplace_back(*f, newFace);
                 }
             }
         }
@@ -28,6 +28,7 @@
 #include <map>
 #include <list>
 #include <GeomAbs_SurfaceType.hxx>
+#include <Geom_Surface.hxx>
 #include <TopoDS_Shell.hxx>
 #include <TopoDS_Face.hxx>
 #include <TopoDS_Solid.hxx>
@@ -46,6 +47,7 @@ namespace ModelRefine
     typedef std::vector<TopoDS_Edge>  EdgeVectorType;
     typedef std::vector<TopoDS_Shape> ShapeVectorType;
     typedef std::pair<TopoDS_Shape, TopoDS_Shape> ShapePairType;
+    typedef std::vector<Handle(Geom_Surface)> SurfaceVectorType;
 
     void getFaceEdges(const TopoDS_Face &face, EdgeVectorType &edges);
     void boundaryEdges(const FaceVectorType &faces, EdgeVectorType &edgesOut);
@@ -59,6 +61,12 @@ namespace ModelRefine
         FaceTypedBase(const GeomAbs_SurfaceType &typeIn){surfaceType = typeIn;}
     public:
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const = 0;
+        /// Same as isEqual() for faces but with the surfaces returned by BRep_Tool::Surface()
+        virtual bool isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const = 0;
+        /** Computes a value that differs by at most \a tolerance for equal surfaces. It is used
+         * to skip comparisons. If no key is returned for a surface it must not be equal to any other.
+         */
+        virtual bool getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const;
         virtual GeomAbs_SurfaceType getType() const = 0;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const = 0;
 
@@ -75,6 +83,8 @@ namespace ModelRefine
         FaceTypedPlane();
     public:
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const;
+        virtual bool isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const;
+        virtual bool getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const;
         virtual GeomAbs_SurfaceType getType() const;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const;
         friend FaceTypedPlane& getPlaneObject();
@@ -87,6 +97,8 @@ namespace ModelRefine
         FaceTypedCylinder();
     public:
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const;
+        virtual bool isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const;
+        virtual bool getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const;
         virtual GeomAbs_SurfaceType getType() const;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const;
         friend FaceTypedCylinder& getCylinderObject();
@@ -102,6 +114,8 @@ namespace ModelRefine
         FaceTypedBSpline();
     public:
         virtual bool isEqual(const TopoDS_Face &faceOne, const TopoDS_Face &faceTwo) const;
+        virtual bool isEqual(const Handle(Geom_Surface) &surfaceOne, const Handle(Geom_Surface) &surfaceTwo) const;
+        virtual bool getKey(const Handle(Geom_Surface) &surface, double &key, double &tolerance) const;
         virtual GeomAbs_SurfaceType getType() const;
         virtual TopoDS_Face buildFace(const FaceVectorType &faces) const;
         friend FaceTypedBSpline& getBSplineObject();
@@ -128,15 +142,16 @@ namespace ModelRefine
     public:
         FaceAdjacencySplitter(const TopoDS_Shell &shell);
         void split(const FaceVectorType &facesIn);
+        /// Appends the groups of adjacent faces to \a groupsOut, can be called from several threads
+        void split(const FaceVectorType &facesIn, std::vector<FaceVectorType> &groupsOut) const;
         std::size_t getGroupCount() const {return adjacencyArray.size();}
         const FaceVectorType& getGroup(const std::size_t &index) const {return adjacencyArray[index];}
 
     private:
         FaceAdjacencySplitter(){}
-        void recursiveFind(const TopoDS_Face &face, FaceVectorType &outVector);
+        void findAdjacent(const TopoDS_Face &face, const TopTools_MapOfShape &facesInMap,
+                          TopTools_MapOfShape &processedMap, FaceVectorType &outVector) const;
         std::vector<FaceVectorType> adjacencyArray;
-        TopTools_MapOfShape processedMap;
-        TopTools_MapOfShape facesInMap;
 
         TopTools_IndexedDataMapOfShapeListOfShape faceToEdgeMap;
         TopTools_IndexedDataMapOfShapeListOfShape edgeToFaceMap;
@@ -147,6 +162,8 @@ namespace ModelRefine
     public:
         FaceEqualitySplitter(){}
         void split(const FaceVectorType &faces,  FaceTypedBase *object);
+        /// Same as above with the surfaces of the faces already computed
+        void split(const FaceVectorType &faces, const SurfaceVectorType &surfaces, FaceTypedBase *object);
         std::size_t getGroupCount() const {return equalityVector.size();}
         const FaceVectorType& getGroup(const std::size_t &index) const {return equalityVector[index];}
 
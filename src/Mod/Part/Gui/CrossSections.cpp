@@ -35,6 +35,7 @@
 # include <QFuture>
 # include <QFutureWatcher>
 # include <QKeyEvent>
+# include <QStringList>
 # include <QtConcurrentMap>
 # include <boost_bind_bind.hpp>
 # include <Python.h>
@@ -243,7 +244,12 @@ void CrossSections::apply()
         section->purgeTouched();
     }
 #else
-    Base::SequencerLauncher seq("Cross-sections...", obj.size() * (d.size() +1));
+    // all planes of an object are sliced at once by Shape.slices()
+    QStringList dist;
+    for (std::vector<double>::iterator jt = d.begin(); jt != d.end(); ++jt)
+        dist << QString::number(*jt, 'g', 17);
+
+    Base::SequencerLauncher seq("Cross-sections...", obj.size());
     Gui::Command::runCommand(Gui::Command::App, "import Part\n");
     Gui::Command::runCommand(Gui::Command::App, "from FreeCAD import Base\n");
     for (std::vector<App::DocumentObject*>::iterator it = obj.begin(); it != obj.end(); ++it) {
@@ -251,26 +257,16 @@ void CrossSections::apply()
         std::string s = (*it)->getNameInDocument();
         s += "_cs";
         Gui::Command::runCommand(Gui::Command::App, QString::fromLatin1(
-            "wires=list()\n"
-            "shape=FreeCAD.getDocument(\"%1\").%2.Shape\n")
-            .arg(QLatin1String(doc->getName()))
-            .arg(QLatin1String((*it)->getNameInDocument())).toLatin1());
-
-        for (std::vector<double>::iterator jt = d.begin(); jt != d.end(); ++jt) {
-            Gui::Command::runCommand(Gui::Command::App, QString::fromLatin1(
-                "for i in shape.slice(Base.Vector(%1,%2,%3),%4):\n"
-                "    wires.append(i)\n"
-                ).arg(a).arg(b).arg(c).arg(*jt).toLatin1());
-            seq.next();
-        }
-
-        Gui::Command::runCommand(Gui::Command::App, QString::fromLatin1(
-            "comp=Part.Compound(wires)\n"
-            "slice=FreeCAD.getDocument(\"%1\").addObject(\"Part::Feature\",\"%2\")\n"
+            "shape=FreeCAD.getDocument(\"%1\").%2.Shape\n"
+            "comp=shape.slices(Base.Vector(%3,%4,%5),[%6])\n"
+            "slice=FreeCAD.getDocument(\"%1\").addObject(\"Part::Feature\",\"%7\")\n"
             "slice.Shape=comp\n"
             "slice.purgeTouched()\n"
-            "del slice,comp,wires,shape")
+            "del slice,comp,shape")
             .arg(QLatin1String(doc->getName()))
+            .arg(QLatin1String((*it)->getNameInDocument()))
+            .arg(a).arg(b).arg(c)
+            .arg(dist.join(QLatin1String(",")))
             .arg(QLatin1String(s.c_str())).toLatin1());
 
         seq.next();
@@ -0,0 +1,238 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+#endif
+
+#include <Base/Reader.h>
+#include <Base/Stream.h>
+#include <Base/Writer.h>
+
+#include "PropertyTessellation.h"
+
+using namespace PartGui;
+
+namespace {
+// The counts of a damaged file must not allocate more memory than the file holds,
+// so only this many elements are reserved in advance
+const uint32_t maxReserve = 1 << 16;
+
+void readVectors(Base::InputStream& str, Base::Reader& reader, uint32_t count, std::vector<SbVec3f>& list)
+{
+    list.reserve(std::min(count, maxReserve));
+    for (uint32_t i = 0; i < count && reader.good(); i++) {
+        float x=0, y=0, z=0;
+        str >> x >> y >> z;
+        list.emplace_back(x, y, z);
+    }
+}
+
+void readIndexes(Base::InputStream& str, Base::Reader& reader, uint32_t count, std::vector<int32_t>& list)
+{
+    list.reserve(std::min(count, maxReserve));
+    for (uint32_t i = 0; i < count && reader.good(); i++) {
+        int32_t index = 0;
+        str >> index;
+        list.push_back(index);
+    }
+}
+}
+
+TessellationData::TessellationData()
+  : nodeIndex(0), numEdges(0), time(0.0), valid(false)
+{
+}
+
+bool TessellationData::isConsistent() const
+{
+    int32_t numPoints = static_cast<int32_t>(verts.size());
+    int32_t numNorms = static_cast<int32_t>(norms.size());
+    if (nodeIndex < 0 || nodeIndex > numPoints)
+        return false;
+    if (faceIndex.size() % 4 != 0)
+        return false;
+    for (std::size_t i = 0; i < faceIndex.size(); i++) {
+        // every fourth index is the end delimiter
+        int32_t index = faceIndex[i];
+        if (i % 4 == 3) {
+            if (index != -1)
+                return false;
+        }
+        else if (index < 0 || index >= numPoints || index >= numNorms) {
+            return false;
+        }
+    }
+    for (int32_t index : lineIndex) {
+        if (index < -1 || index >= numPoints)
+            return false;
+    }
+    int32_t numTriangles = 0;
+    for (int32_t count : partIndex) {
+        if (count < 0)
+            return false;
+        numTriangles += count;
+    }
+    return numTriangles * 4 == static_cast<int32_t>(faceIndex.size());
+}
+
+unsigned int TessellationData::getMemSize() const
+{
+    return static_cast<unsigned int>((verts.size() + norms.size()) * sizeof(SbVec3f) +
+        (faceIndex.size() + partIndex.size() + lineIndex.size()) * sizeof(int32_t));
+}
+
+// ----------------------------------------------------------------------------
+
+TYPESYSTEM_SOURCE(PartGui::PropertyTessellation, App::Property)
+
+PropertyTessellation::PropertyTessellation()
+{
+}
+
+PropertyTessellation::~PropertyTessellation()
+{
+}
+
+void PropertyTessellation::setValue(const std::string& key, const std::shared_ptr<const TessellationData>& data)
+{
+    _key = key;
+    _data = data;
+}
+
+std::shared_ptr<const TessellationData> PropertyTessellation::getValue() const
+{
+    return _data;
+}
+
+const std::string& PropertyTessellation::getKey() const
+{
+    return _key;
+}
+
+bool PropertyTessellation::isEmpty() const
+{
+    return !_data || _key.empty();
+}
+
+void PropertyTessellation::Save (Base::Writer &writer) const
+{
+    // the element is always written because Restore() reads it, but the data
+    // can only be saved to a file
+    bool empty = writer.isForceXML() || isEmpty() || !_data->valid;
+    writer.Stream() << writer.ind() << "<Tessellation key=\"" << (empty ? "" : _key)
+                    << "\" file=\"" << (empty ? "" : writer.addFile(getName(), this))
+                    << "\"/>" << std::endl;
+}
+
+void PropertyTessellation::Restore(Base::XMLReader &reader)
+{
+    reader.readElement("Tessellation");
+    _key = reader.getAttribute("key");
+    _data.reset();
+    if (reader.hasAttribute("file")) {
+        std::string file (reader.getAttribute("file"));
+
+        if (!file.empty()) {
+            // initiate a file read
+            reader.addFile(file.c_str(),this);
+        }
+    }
+}
+
+void PropertyTessellation::SaveDocFile (Base::Writer &writer) const
+{
+    Base::OutputStream str(writer.Stream());
+    const TessellationData& data = *_data;
+
+    str << static_cast<uint32_t>(data.verts.size());
+    for (const SbVec3f& v : data.verts)
+        str << v[0] << v[1] << v[2];
+    str << static_cast<uint32_t>(data.norms.size());
+    for (const SbVec3f& v : data.norms)
+        str << v[0] << v[1] << v[2];
+
+    const std::vector<int32_t>* lists[] = {&data.faceIndex, &data.partIndex, &data.lineIndex};
+    for (const std::vector<int32_t>* list : lists) {
+        str << static_cast<uint32_t>(list->size());
+        for (int32_t index : *list)
+            str << index;
+    }
+
+    str << static_cast<int32_t>(data.nodeIndex) << static_cast<int32_t>(data.numEdges);
+}
+
+void PropertyTessellation::RestoreDocFile(Base::Reader &reader)
+{
+    Base::InputStream str(reader);
+    std::shared_ptr<TessellationData> data = std::make_shared<TessellationData>();
+
+    uint32_t count = 0;
+    str >> count;
+    readVectors(str, reader, count, data->verts);
+    count = 0;
+    str >> count;
+    readVectors(str, reader, count, data->norms);
+
+    std::vector<int32_t>* lists[] = {&data->faceIndex, &data->partIndex, &data->lineIndex};
+    for (std::vector<int32_t>* list : lists) {
+        count = 0;
+        str >> count;
+        readIndexes(str, reader, count, *list);
+    }
+
+    int32_t nodeIndex = 0, numEdges = 0;
+    str >> nodeIndex >> numEdges;
+    data->nodeIndex = nodeIndex;
+    data->numEdges = numEdges;
+
+    // a truncated or damaged file is silently dropped, the shape is tessellated again
+    data->valid = reader.good() && data->isConsistent();
+    if (data->valid)
+        _data = data;
+    else
+        _key.clear();
+}
+
+App::Property *PropertyTessellation::Copy(void) const
+{
+    PropertyTessellation *p = new PropertyTessellation();
+    p->_key = _key;
+    p->_data = _data;
+    return p;
+}
+
+void PropertyTessellation::Paste(const App::Property &from)
+{
+    const PropertyTessellation& prop = dynamic_cast<const PropertyTessellation&>(from);
+    _key = prop._key;
+    _data = prop._data;
+}
+
+unsigned int PropertyTessellation::getMemSize (void) const
+{
+    return _data ? _data->getMemSize() : 0;
+}
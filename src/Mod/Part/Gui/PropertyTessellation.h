@@ -0,0 +1,97 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef PARTGUI_PROPERTYTESSELLATION_H
+#define PARTGUI_PROPERTYTESSELLATION_H
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <Inventor/SbVec3f.h>
+#include <App/Property.h>
+
+namespace PartGui {
+
+/// Tessellation of a shape ready to be copied into the Inventor nodes
+struct PartGuiExport TessellationData
+{
+    std::vector<SbVec3f> verts;
+    std::vector<SbVec3f> norms;
+    std::vector<int32_t> faceIndex;
+    std::vector<int32_t> partIndex;
+    std::vector<int32_t> lineIndex;
+    int nodeIndex;  /**< Index of the first vertex point. */
+    int numEdges;
+    double time;
+    bool valid;     /**< False if the tessellation failed or was canceled. */
+
+    TessellationData();
+    /// Checks that all indices refer to existing points
+    bool isConsistent() const;
+    unsigned int getMemSize() const;
+};
+
+/** Stores the tessellation of a shape in the project file.
+ * The tessellation is saved together with a key that identifies the shape and
+ * the tessellation settings. When the document is opened again the view provider
+ * can reuse the data if the key still matches.
+ *
+ * The property is a cache, therefore setting a value doesn't notify the container.
+ */
+class PartGuiExport PropertyTessellation : public App::Property
+{
+    TYPESYSTEM_HEADER_WITH_OVERRIDE();
+
+public:
+    PropertyTessellation();
+    virtual ~PropertyTessellation();
+
+    /** @name Getter/setter */
+    //@{
+    void setValue(const std::string& key, const std::shared_ptr<const TessellationData>& data);
+    std::shared_ptr<const TessellationData> getValue() const;
+    const std::string& getKey() const;
+    bool isEmpty() const;
+    //@}
+
+    /** @name Save/restore */
+    //@{
+    virtual void Save (Base::Writer &writer) const override;
+    virtual void Restore(Base::XMLReader &reader) override;
+
+    virtual void SaveDocFile (Base::Writer &writer) const override;
+    virtual void RestoreDocFile(Base::Reader &reader) override;
+
+    virtual App::Property *Copy(void) const override;
+    virtual void Paste(const App::Property &from) override;
+    virtual unsigned int getMemSize (void) const override;
+    //@}
+
+private:
+    std::string _key;
+    std::shared_ptr<const TessellationData> _data;
+};
+
+} //namespace PartGui
+
+#endif // PARTGUI_PROPERTYTESSELLATION_H
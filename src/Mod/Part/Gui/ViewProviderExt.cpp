@@ -24,14 +24,24 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <iomanip>
 # include <sstream>
+# include <tuple>
 # include <Bnd_Box.hxx>
 # include <Poly_Polygon3D.hxx>
 # include <BRepBndLib.hxx>
+# include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBuilderAPI_MakeVertex.hxx>
 # include <BRepExtrema_DistShapeShape.hxx>
 # include <BRepMesh_IncrementalMesh.hxx>
+# include <BRep_Builder.hxx>
 # include <BRep_Tool.hxx>
+# include <Geom_Surface.hxx>
+# include <Geom_Curve.hxx>
+# include <Geom2d_Curve.hxx>
+# include <GeomTools_Curve2dSet.hxx>
+# include <GeomTools_CurveSet.hxx>
+# include <GeomTools_SurfaceSet.hxx>
 # include <BRepTools.hxx>
 # include <BRepAdaptor_Curve.hxx>
 # include <BRepAdaptor_Surface.hxx>
@@ -97,7 +107,11 @@
 # include <QMenu>
 #endif
 
+#include <QFutureWatcher>
+#include <QtConcurrentRun>
 #include <boost/algorithm/string/predicate.hpp>
+#include <boost/functional/hash.hpp>
+#include <boost_bind_bind.hpp>
 
 /// Here the FreeCAD includes sorted by Base,App,Gui......
 #include <Base/Console.h>
@@ -108,6 +122,7 @@
 #include <App/Application.h>
 #include <App/Document.h>
 
+#include <Gui/ActionFunction.h>
 #include <Gui/SoFCUnifiedSelection.h>
 #include <Gui/SoFCSelectionAction.h>
 #include <Gui/Selection.h>
@@ -123,6 +138,7 @@
 #include "SoBrepFaceSet.h"
 #include "TaskFaceColors.h"
 
+#include <Mod/Part/App/GeometryStore.h>
 #include <Mod/Part/App/PartFeature.h>
 #include <Mod/Part/App/PrimitiveFeature.h>
 
@@ -235,6 +251,10 @@ ViewProviderPartExt::ViewProviderPartExt()
     VisualTouched = true;
     forceUpdateCount = 0;
     NormalsFromUV = true;
+    BackgroundTessellation = false;
+    SaveTessellation = false;
+    restoringVisual = false;
+    visualJob = 0;
 
     unsigned long lcol = Gui::ViewParams::instance()->getDefaultShapeLineColor(); // dark grey (25,25,25)
     float r,g,b;
@@ -288,6 +308,8 @@ ViewProviderPartExt::ViewProviderPartExt()
     Lighting.setEnums(LightingEnums);
     ADD_PROPERTY_TYPE(DrawStyle,((long int)0), osgroup, App::Prop_None, "Defines the style of the edges in the 3D view.");
     DrawStyle.setEnums(DrawStyleEnums);
+    ADD_PROPERTY_TYPE(TessellationCache,(std::string(), std::shared_ptr<const TessellationData>()),
+            osgroup, App::Prop_Hidden, "Tessellation of the shape saved in the project file.");
 
     coords = new SoCoordinate3();
     coords->ref();
@@ -340,6 +362,7 @@ ViewProviderPartExt::ViewProviderPartExt()
 
 ViewProviderPartExt::~ViewProviderPartExt()
 {
+    cancelVisualUpdate();
     pcFaceBind->unref();
     pcLineBind->unref();
     pcPointBind->unref();
@@ -363,13 +386,13 @@ void ViewProviderPartExt::onChanged(const App::Property* prop)
     // https://forum.freecadweb.org/viewtopic.php?f=3&t=24912&p=195613
     if (prop == &Deviation) {
         if(isUpdateForced()||Visibility.getValue()) 
-            updateVisual();
+            updateVisualInBackground();
         else
             VisualTouched = true;
     }
     if (prop == &AngularDeflection) {
         if(isUpdateForced()||Visibility.getValue()) 
-            updateVisual();
+            updateVisualInBackground();
         else
             VisualTouched = true;
     }
@@ -471,7 +494,7 @@ void ViewProviderPartExt::onChanged(const App::Property* prop)
     else {
         // if the object was invisible and has been changed, recreate the visual
         if (prop == &Visibility && (isUpdateForced() || Visibility.getValue()) && VisualTouched) {
-            updateVisual();
+            updateVisualInBackground();
             // The material has to be checked again (#0001736)
             onChanged(&DiffuseColor);
         }
@@ -590,8 +613,10 @@ std::vector<std::string> ViewProviderPartExt::getDisplayModes(void) const
 
 std::string ViewProviderPartExt::getElement(const SoDetail* detail) const
 {
+    // While a background tessellation is pending the shown visual belongs to
+    // the previous shape, so its indices don't match the current elements
     std::stringstream str;
-    if (detail) {
+    if (detail && !visualJob) {
         if (detail->getTypeId() == SoFaceDetail::getClassTypeId()) {
             const SoFaceDetail* face_detail = static_cast<const SoFaceDetail*>(detail);
             int face = face_detail->getPartIndex() + 1;
@@ -623,7 +648,7 @@ SoDetail* ViewProviderPartExt::getDetail(const char* subelement) const
     }
 
     SoDetail* detail = 0;
-    if (index < 0)
+    if (index < 0 || visualJob)
         return detail;
     if (element == "Face") {
         detail = new SoFaceDetail();
@@ -917,6 +942,8 @@ bool ViewProviderPartExt::loadParameter()
     float deviation = hGrp->GetFloat("MeshDeviation",0.2);
     float angularDeflection = hGrp->GetFloat("MeshAngularDeflection",28.65);
     NormalsFromUV = hGrp->GetBool("NormalsFromUVNodes", NormalsFromUV);
+    BackgroundTessellation = hGrp->GetBool("BackgroundTessellation", BackgroundTessellation);
+    SaveTessellation = hGrp->GetBool("SaveTessellation", SaveTessellation);
 
     if (Deviation.getValue() != deviation) {
         Deviation.setValue(deviation);
@@ -932,7 +959,7 @@ bool ViewProviderPartExt::loadParameter()
 void ViewProviderPartExt::reload()
 {
     if (loadParameter()) 
-        updateVisual();
+        updateVisualInBackground();
 }
 
 void ViewProviderPartExt::updateData(const App::Property* prop)
@@ -941,7 +968,7 @@ void ViewProviderPartExt::updateData(const App::Property* prop)
     if (propName && (strcmp(propName, "Shape") == 0 || strstr(propName, "Touched") != nullptr)) {
         // calculate the visual only if visible
         if (isUpdateForced() || Visibility.getValue())
-            updateVisual();
+            updateVisualInBackground();
         else 
             VisualTouched = true;
 
@@ -998,38 +1025,426 @@ void ViewProviderPartExt::unsetEdit(int ModNum)
     }
 }
 
+namespace PartGui {
+/// A tessellation running in the global thread pool
+struct ViewProviderPartExt::VisualJob
+{
+    std::shared_ptr< std::atomic<bool> > canceled;
+    std::string key;
+    TopoDS_Shape shape;
+    std::shared_ptr<FaceMeshes> faceMeshes; // filled by the worker
+    Gui::TimerFunction* func;
+    QFutureWatcher< std::shared_ptr<TessellationData> >* watcher;
+};
+
+/** The face triangulations of the shape last tessellated in the background.
+ * The worker meshes a private copy of the shape, so the triangulations are
+ * not stored in the faces of the shown shape. A face of the next shape with
+ * the same TShape, location and surface gets the stored triangulation and
+ * BRepMesh only meshes the other faces. Only the triangulations and the edge
+ * polygons are kept, not the meshed copy.
+ */
+struct ViewProviderPartExt::FaceMeshes
+{
+    struct Face
+    {
+        /// The polygon of an edge on the triangulation, a seam edge has one for either orientation
+        typedef std::pair<Handle(Poly_PolygonOnTriangulation), Handle(Poly_PolygonOnTriangulation)> Polygons;
+
+        TopoDS_Face face;              // face of the shown shape, keeps the TShape alive
+        Handle(Geom_Surface) surface;  // surface of the face when it was meshed
+        Handle(Poly_Triangulation) mesh;
+        std::vector<Polygons> edges;   // in the order the edges of the face are explored
+    };
+
+    double deflection;
+    double angularDeflection;
+    std::map<const void*, Face> faces; // keyed by the TShape of the shown face
+
+    /// Copies the triangulations of the known faces of \a shape to \a copy
+    int reuse(const TopTools_IndexedMapOfShape& shape, const TopTools_IndexedMapOfShape& copy) const;
+    /// Remembers the triangulations and edge polygons of the meshed faces of \a copy
+    void store(const TopTools_IndexedMapOfShape& shape, const TopTools_IndexedMapOfShape& copy);
+};
+
+int ViewProviderPartExt::FaceMeshes::reuse(const TopTools_IndexedMapOfShape& shape,
+                                           const TopTools_IndexedMapOfShape& copy) const
+{
+    int count = 0;
+    BRep_Builder builder;
+    for (int i=1; i <= shape.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(shape(i));
+        auto it = faces.find(face.TShape().operator->());
+        if (it == faces.end() || !it->second.face.Location().IsEqual(face.Location()))
+            continue;
+        TopLoc_Location aLoc;
+        if (BRep_Tool::Surface(face, aLoc) != it->second.surface)
+            continue;
+
+        const Face& oldFace = it->second;
+
+        // The edges need their polygons on the triangulation, otherwise BRepMesh
+        // considers the triangulation inconsistent and meshes the face again.
+        // Both faces have the same structure, so the edges are explored in the
+        // same order.
+        const TopoDS_Face& newFace = TopoDS::Face(copy(i));
+        builder.UpdateFace(newFace, oldFace.mesh);
+        std::size_t index = 0;
+        for (TopExp_Explorer xp(newFace, TopAbs_EDGE); xp.More() && index < oldFace.edges.size(); xp.Next(), index++) {
+            const TopoDS_Edge& newEdge = TopoDS::Edge(xp.Current());
+            const Face::Polygons& polygons = oldFace.edges[index];
+            if (polygons.first.IsNull())
+                continue;
+            if (!polygons.second.IsNull())
+                builder.UpdateEdge(TopoDS::Edge(newEdge.Oriented(TopAbs_FORWARD)), polygons.first,
+                                   polygons.second, oldFace.mesh, newFace.Location());
+            else
+                builder.UpdateEdge(newEdge, polygons.first, oldFace.mesh, newFace.Location());
+        }
+        count++;
+    }
+
+    return count;
+}
+
+void ViewProviderPartExt::FaceMeshes::store(const TopTools_IndexedMapOfShape& shape,
+                                            const TopTools_IndexedMapOfShape& copy)
+{
+    faces.clear();
+    for (int i=1; i <= shape.Extent(); i++) {
+        Face face;
+        face.face = TopoDS::Face(shape(i));
+        TopLoc_Location aLoc;
+        face.surface = BRep_Tool::Surface(face.face, aLoc);
+
+        const TopoDS_Face& meshed = TopoDS::Face(copy(i));
+        face.mesh = BRep_Tool::Triangulation(meshed, aLoc);
+        if (face.mesh.IsNull())
+            continue;
+        for (TopExp_Explorer xp(meshed, TopAbs_EDGE); xp.More(); xp.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(xp.Current());
+            Face::Polygons polygons;
+            if (BRep_Tool::IsClosed(edge, meshed)) {
+                polygons.first = BRep_Tool::PolygonOnTriangulation(
+                    TopoDS::Edge(edge.Oriented(TopAbs_FORWARD)), face.mesh, aLoc);
+                polygons.second = BRep_Tool::PolygonOnTriangulation(
+                    TopoDS::Edge(edge.Oriented(TopAbs_REVERSED)), face.mesh, aLoc);
+                if (polygons.second.IsNull())
+                    polygons.first.Nullify();
+            }
+            else {
+                polygons.first = BRep_Tool::PolygonOnTriangulation(edge, face.mesh, aLoc);
+            }
+            face.edges.push_back(polygons);
+        }
+        faces[face.face.TShape().operator->()] = face;
+    }
+}
+
+/// The tessellation of a shape shared by several objects, see Part::GeometryStore
+struct ViewProviderPartExt::SharedVisual
+{
+    TopoDS_Shape shape; // keeps the TShape and thus the key alive
+    std::shared_ptr<const TessellationData> data;
+
+    /// TShape, orientation, deviation, angular deflection and normals from UV
+    typedef std::tuple<const void*, int, double, double, bool> Key;
+    static std::map<Key, std::weak_ptr<SharedVisual> > registry;
+};
+
+std::map<ViewProviderPartExt::SharedVisual::Key, std::weak_ptr<ViewProviderPartExt::SharedVisual> >
+    ViewProviderPartExt::SharedVisual::registry;
+}
+
 void ViewProviderPartExt::updateVisual()
 {
-    Gui::SoUpdateVBOAction action;
-    action.apply(this->faceset);
+    cancelVisualUpdate();
 
-    // Clear selection
-    Gui::SoSelectionElementAction saction(Gui::SoSelectionElementAction::None);
-    saction.apply(this->faceset);
-    saction.apply(this->lineset);
-    saction.apply(this->nodeset);
+    TopoDS_Shape cShape = Part::Feature::getShape(getObject());
+    if (applySharedVisual(cShape))
+        return;
 
-    // Clear highlighting
-    Gui::SoHighlightElementAction haction;
-    haction.apply(this->faceset);
-    haction.apply(this->lineset);
-    haction.apply(this->nodeset);
+    std::string key = tessellationKey(cShape);
+    if (restoringVisual && applyCachedVisual(key)) {
+        storeSharedVisual(cShape, TessellationCache.getValue());
+        return;
+    }
+
+    std::shared_ptr<TessellationData> data = tessellate(cShape, Deviation.getValue(),
+        AngularDeflection.getValue(), NormalsFromUV, std::shared_ptr< std::atomic<bool> >());
+    applyVisual(*data);
+    storeCachedVisual(key, data);
+    storeSharedVisual(cShape, data);
+    VisualTouched = false;
+}
+
+void ViewProviderPartExt::updateVisualInBackground()
+{
+    // wait until the tessellation cache is restored, see finishRestoring()
+    if (isRestoring() && !isUpdateForced()) {
+        VisualTouched = true;
+        return;
+    }
 
     TopoDS_Shape cShape = Part::Feature::getShape(getObject());
-    if (cShape.IsNull()) {
-        coords  ->point      .setNum(0);
-        norm    ->vector     .setNum(0);
-        faceset ->coordIndex .setNum(0);
-        faceset ->partIndex  .setNum(0);
-        lineset ->coordIndex .setNum(0);
-        nodeset ->startIndex .setValue(0);
-        VisualTouched = false;
+    if (isUpdateForced() || !BackgroundTessellation || cShape.IsNull()) {
+        updateVisual();
+        return;
+    }
+
+    cancelVisualUpdate();
+    if (applySharedVisual(cShape))
+        return;
+
+    std::string key = tessellationKey(cShape);
+    if (restoringVisual && applyCachedVisual(key)) {
+        storeSharedVisual(cShape, TessellationCache.getValue());
+        return;
+    }
+
+    visualJob = new VisualJob();
+    visualJob->canceled = std::make_shared< std::atomic<bool> >(false);
+    visualJob->key = key;
+    visualJob->shape = cShape;
+    visualJob->faceMeshes = std::make_shared<FaceMeshes>();
+
+    // The triangulation is stored in the shape which may be shared with other
+    // objects that are meshed at the same time. So, the worker gets its own copy.
+    // Only the topology is copied, the geometry is shared with the shape.
+    TopoDS_Shape copy = BRepBuilderAPI_Copy(cShape, Standard_False).Shape();
+
+    visualJob->func = new Gui::TimerFunction();
+    visualJob->func->setFunction(boost::bind(&ViewProviderPartExt::finishVisualUpdate, this));
+    visualJob->watcher = new QFutureWatcher< std::shared_ptr<TessellationData> >(visualJob->func);
+    QObject::connect(visualJob->watcher, SIGNAL(finished()), visualJob->func, SLOT(timeout()));
+
+    double deviation = Deviation.getValue();
+    double angularDeflection = AngularDeflection.getValue();
+    bool normalsFromUV = NormalsFromUV;
+    std::shared_ptr< std::atomic<bool> > canceled = visualJob->canceled;
+    std::shared_ptr<const FaceMeshes> previous = faceMeshes;
+    std::shared_ptr<FaceMeshes> result = visualJob->faceMeshes;
+    visualJob->watcher->setFuture(QtConcurrent::run([=]() {
+        return tessellate(copy, deviation, angularDeflection, normalsFromUV, canceled,
+                          cShape, previous, result);
+    }));
+    VisualTouched = false;
+}
+
+void ViewProviderPartExt::finishRestoring()
+{
+    // The data files of the view providers are read after their XML part.
+    // So, the visual is created once the tessellation cache is available.
+    // The cache is only used for the shape that was restored with it.
+    if (VisualTouched && (isUpdateForced() || Visibility.getValue())) {
+        restoringVisual = true;
+        updateVisualInBackground();
+        restoringVisual = false;
+        onChanged(&DiffuseColor);
+    }
+
+    Gui::ViewProviderGeometryObject::finishRestoring();
+}
+
+void ViewProviderPartExt::finishVisualUpdate()
+{
+    if (!visualJob)
+        return;
+
+    std::shared_ptr<TessellationData> data = visualJob->watcher->result();
+    std::string key = visualJob->key;
+    TopoDS_Shape shape = visualJob->shape;
+    if (data->valid)
+        faceMeshes = visualJob->faceMeshes;
+    visualJob->func->deleteLater();
+    delete visualJob;
+    visualJob = 0;
+
+    applyVisual(*data);
+    storeCachedVisual(key, data);
+    storeSharedVisual(shape, data);
+
+    // The number of faces may have changed, so the material has to be checked again
+    onChanged(&DiffuseColor);
+    if (this->faceset->partIndex.getNum() > this->pcShapeMaterial->diffuseColor.getNum())
+        this->pcFaceBind->value = SoMaterialBinding::OVERALL;
+}
+
+void ViewProviderPartExt::cancelVisualUpdate()
+{
+    if (!visualJob)
+        return;
+
+    // the worker stops at the next check, its result is dropped with the watcher
+    *visualJob->canceled = true;
+    QObject::disconnect(visualJob->watcher, SIGNAL(finished()), visualJob->func, SLOT(timeout()));
+    visualJob->func->deleteLater();
+    delete visualJob;
+    visualJob = 0;
+}
+
+std::string ViewProviderPartExt::tessellationKey(const TopoDS_Shape& shape) const
+{
+    // computing the key is cheap compared to the tessellation but not for free
+    if (shape.IsNull() || (!SaveTessellation && TessellationCache.isEmpty()))
+        return std::string();
+
+    // The key covers the complete B-rep data that the tessellation depends on:
+    // the surfaces and curves of all faces and edges, the pcurves and parameter
+    // ranges, the sub-shape locations and orientations, and the vertices.
+    // The placement of the shape is not part of the tessellation and is left out.
+    // The numbers are written with 15 digits like in a BRep file, so a shape read
+    // back from the project file gives the same key.
+    TopoDS_Shape cShape = shape;
+    cShape.Location(TopLoc_Location());
+
+    std::ostringstream data;
+    data.precision(15);
+    auto writeLocation = [&data](const TopLoc_Location& loc) {
+        gp_Trsf trsf = loc.Transformation();
+        for (int r=1; r <= 3; r++) {
+            for (int c=1; c <= 4; c++)
+                data << trsf.Value(r,c) << ' ';
+        }
+    };
+
+    TopTools_IndexedMapOfShape faceMap, edgeMap, vertexMap;
+    TopExp::MapShapes(cShape, TopAbs_FACE, faceMap);
+    TopExp::MapShapes(cShape, TopAbs_EDGE, edgeMap);
+    TopExp::MapShapes(cShape, TopAbs_VERTEX, vertexMap);
+    data << faceMap.Extent() << ' ' << edgeMap.Extent() << ' ' << vertexMap.Extent() << '\n';
+    for (int i=1; i <= faceMap.Extent(); i++) {
+        const TopoDS_Face& face = TopoDS::Face(faceMap(i));
+        TopLoc_Location loc;
+        const Handle(Geom_Surface)& surface = BRep_Tool::Surface(face, loc);
+        data << "F " << static_cast<int>(face.Orientation()) << ' ';
+        writeLocation(loc);
+        if (!surface.IsNull())
+            GeomTools_SurfaceSet::PrintSurface(surface, data, Standard_True);
+        for (TopExp_Explorer xp(face, TopAbs_EDGE); xp.More(); xp.Next()) {
+            const TopoDS_Edge& edge = TopoDS::Edge(xp.Current());
+            Standard_Real first = 0, last = 0;
+            Handle(Geom2d_Curve) pcurve = BRep_Tool::CurveOnSurface(edge, face, first, last);
+            data << "P " << edgeMap.FindIndex(edge) << ' ' << static_cast<int>(edge.Orientation())
+                 << ' ' << first << ' ' << last << ' ';
+            if (!pcurve.IsNull())
+                GeomTools_Curve2dSet::PrintCurve2d(pcurve, data, Standard_True);
+        }
+    }
+    for (int i=1; i <= edgeMap.Extent(); i++) {
+        const TopoDS_Edge& edge = TopoDS::Edge(edgeMap(i));
+        TopLoc_Location loc;
+        Standard_Real first = 0, last = 0;
+        Handle(Geom_Curve) curve = BRep_Tool::Curve(edge, loc, first, last);
+        data << "E " << first << ' ' << last << ' ';
+        writeLocation(loc);
+        if (!curve.IsNull())
+            GeomTools_CurveSet::PrintCurve(curve, data, Standard_True);
+        for (TopExp_Explorer xp(edge, TopAbs_VERTEX); xp.More(); xp.Next())
+            data << vertexMap.FindIndex(xp.Current()) << ' ';
+    }
+    for (int i=1; i <= vertexMap.Extent(); i++) {
+        gp_Pnt pnt = BRep_Tool::Pnt(TopoDS::Vertex(vertexMap(i)));
+        data << "V " << pnt.X() << ' ' << pnt.Y() << ' ' << pnt.Z() << '\n';
+    }
+
+    std::size_t seed = boost::hash<std::string>()(data.str());
+    std::stringstream str;
+    str << std::hex << seed << std::dec << std::setprecision(6)
+        << ";" << Deviation.getValue()
+        << ";" << AngularDeflection.getValue()
+        << ";" << (NormalsFromUV ? 1 : 0);
+    return str.str();
+}
+
+bool ViewProviderPartExt::applyCachedVisual(const std::string& key)
+{
+    std::shared_ptr<const TessellationData> data = TessellationCache.getValue();
+    if (key.empty() || !data || TessellationCache.getKey() != key)
+        return false;
+
+    applyVisual(*data);
+    VisualTouched = false;
+    return true;
+}
+
+void ViewProviderPartExt::storeCachedVisual(const std::string& key, const std::shared_ptr<const TessellationData>& data)
+{
+    // keep the data only if it will be saved because it doubles the memory of the visual
+    if (SaveTessellation && data->valid)
+        TessellationCache.setValue(key, data);
+    else if (!TessellationCache.isEmpty())
+        TessellationCache.setValue(std::string(), std::shared_ptr<const TessellationData>());
+}
+
+bool ViewProviderPartExt::applySharedVisual(const TopoDS_Shape& shape)
+{
+    sharedVisual.reset();
+    if (shape.IsNull())
+        return false;
+
+    SharedVisual::Key key(shape.TShape().operator->(), static_cast<int>(shape.Orientation()),
+                        Deviation.getValue(), AngularDeflection.getValue(), NormalsFromUV);
+    auto it = SharedVisual::registry.find(key);
+    if (it == SharedVisual::registry.end())
+        return false;
+
+    std::shared_ptr<SharedVisual> visual = it->second.lock();
+    if (!visual) {
+        SharedVisual::registry.erase(it);
+        return false;
+    }
+
+    applyVisual(*visual->data);
+    sharedVisual = visual;
+    VisualTouched = false;
+    return true;
+}
+
+void ViewProviderPartExt::storeSharedVisual(const TopoDS_Shape& shape, const std::shared_ptr<const TessellationData>& data)
+{
+    // Only the tessellation of a shape with several instances is kept because
+    // it doubles the memory of the visual otherwise
+    sharedVisual.reset();
+    if (shape.IsNull() || !data || !data->valid || !getObject() ||
+        Part::GeometryStore::instance().countInstances(getObject()->getDocument(), shape) < 2)
         return;
+
+    // drop the entries of shapes that are not shown any more
+    for (auto it = SharedVisual::registry.begin(); it != SharedVisual::registry.end();) {
+        if (it->second.expired())
+            it = SharedVisual::registry.erase(it);
+        else
+            ++it;
+    }
+
+    SharedVisual::Key key(shape.TShape().operator->(), static_cast<int>(shape.Orientation()),
+                        Deviation.getValue(), AngularDeflection.getValue(), NormalsFromUV);
+    sharedVisual = std::make_shared<SharedVisual>();
+    sharedVisual->shape = shape;
+    sharedVisual->data = data;
+    SharedVisual::registry[key] = sharedVisual;
+}
+
+std::shared_ptr<TessellationData>
+ViewProviderPartExt::tessellate(TopoDS_Shape cShape, double deviation, double angularDeflection,
+                                bool NormalsFromUV, std::shared_ptr< std::atomic<bool> > canceled,
+                                TopoDS_Shape original, std::shared_ptr<const FaceMeshes> previous,
+                                std::shared_ptr<FaceMeshes> result)
+{
+    std::shared_ptr<TessellationData> data = std::make_shared<TessellationData>();
+    auto isCanceled = [&canceled]() {
+        return canceled && *canceled;
+    };
+
+    if (cShape.IsNull()) {
+        data->valid = true;
+        return data;
     }
 
     // time measurement and book keeping
     Base::TimeInfo start_time;
-    int numTriangles=0,numNodes=0,numNorms=0,numFaces=0,numEdges=0,numLines=0;
+    int numTriangles=0,numNodes=0,numNorms=0,numFaces=0,numEdges=0;
     std::set<int> faceEdges;
 
     try {
@@ -1040,16 +1455,38 @@ void ViewProviderPartExt::updateVisual()
         Standard_Real xMin, yMin, zMin, xMax, yMax, zMax;
         bounds.Get(xMin, yMin, zMin, xMax, yMax, zMax);
         Standard_Real deflection = ((xMax-xMin)+(yMax-yMin)+(zMax-zMin))/300.0 *
-            Deviation.getValue();
+            deviation;
+
+        // cShape is a copy of original, see FaceMeshes
+        TopTools_IndexedMapOfShape originalFaces, copyFaces;
+        if (result) {
+            TopExp::MapShapes(original, TopAbs_FACE, originalFaces);
+            TopExp::MapShapes(cShape, TopAbs_FACE, copyFaces);
+            if (previous && previous->deflection == deflection &&
+                            previous->angularDeflection == angularDeflection) {
+                int count = previous->reuse(originalFaces, copyFaces);
+                FC_LOG("Reused the triangulation of " << count << " of "
+                       << copyFaces.Extent() << " faces");
+            }
+        }
 
         // create or use the mesh on the data structure
 #if OCC_VERSION_HEX >= 0x060600
-        Standard_Real AngDeflectionRads = AngularDeflection.getValue() / 180.0 * M_PI;
+        Standard_Real AngDeflectionRads = angularDeflection / 180.0 * M_PI;
         BRepMesh_IncrementalMesh(cShape,deflection,Standard_False,
                 AngDeflectionRads,Standard_True);
 #else
         BRepMesh_IncrementalMesh(cShape,deflection);
 #endif
+        if (isCanceled())
+            return data;
+
+        if (result) {
+            result->deflection = deflection;
+            result->angularDeflection = angularDeflection;
+            result->store(originalFaces, copyFaces);
+        }
+
         // We must reset the location here because the transformation data
         // are set in the placement property
         TopLoc_Location aLoc;
@@ -1113,15 +1550,15 @@ void ViewProviderPartExt::updateVisual()
         numNodes += vertexMap.Extent();
 
         // create memory for the nodes and indexes
-        coords  ->point      .setNum(numNodes);
-        norm    ->vector     .setNum(numNorms);
-        faceset ->coordIndex .setNum(numTriangles*4);
-        faceset ->partIndex  .setNum(numFaces);
+        data->verts     .resize(numNodes);
+        data->norms     .resize(numNorms);
+        data->faceIndex .resize(numTriangles*4);
+        data->partIndex .resize(numFaces);
         // get the raw memory for fast fill up
-        SbVec3f* verts = coords  ->point       .startEditing();
-        SbVec3f* norms = norm    ->vector      .startEditing();
-        int32_t* index = faceset ->coordIndex  .startEditing();
-        int32_t* parts = faceset ->partIndex   .startEditing();
+        SbVec3f* verts = data->verts     .data();
+        SbVec3f* norms = data->norms     .data();
+        int32_t* index = data->faceIndex .data();
+        int32_t* parts = data->partIndex .data();
 
         // preset the normal vector with null vector
         for (int i=0;i < numNorms;i++)
@@ -1129,6 +1566,9 @@ void ViewProviderPartExt::updateVisual()
 
         int ii = 0,faceNodeOffset=0,faceTriaOffset=0;
         for (int i=1; i <= faceMap.Extent(); i++, ii++) {
+            if (isCanceled())
+                return data;
+
             TopLoc_Location aLoc;
             const TopoDS_Face &actFace = TopoDS::Face(faceMap(i));
             // get the mesh of the shape
@@ -1300,7 +1740,7 @@ void ViewProviderPartExt::updateVisual()
             }
         }
 
-        nodeset->startIndex.setValue(faceNodeOffset);
+        data->nodeIndex = faceNodeOffset;
         for (int i=0; i<vertexMap.Extent(); i++) {
             const TopoDS_Vertex& aVertex = TopoDS::Vertex(vertexMap(i+1));
             gp_Pnt pnt = BRep_Tool::Pnt(aVertex);
@@ -1311,39 +1751,72 @@ void ViewProviderPartExt::updateVisual()
         for (int i = 0; i< numNorms ;i++)
             norms[i].normalize();
         
-        std::vector<int32_t> lineSetCoords;
+        std::vector<int32_t>& lineSetCoords = data->lineIndex;
         for (std::map<int, std::vector<int32_t> >::iterator it = lineSetMap.begin(); it != lineSetMap.end(); ++it) {
             lineSetCoords.insert(lineSetCoords.end(), it->second.begin(), it->second.end());
             lineSetCoords.push_back(-1);
         }
 
-        // preset the index vector size
-        numLines =  lineSetCoords.size();
-        lineset ->coordIndex .setNum(numLines);
-        int32_t* lines = lineset ->coordIndex  .startEditing();
-
-        int l=0;
-        for (std::vector<int32_t>::const_iterator it=lineSetCoords.begin();it!=lineSetCoords.end();++it,l++)
-            lines[l] = *it;
-
-        // end the editing of the nodes
-        coords  ->point       .finishEditing();
-        norm    ->vector      .finishEditing();
-        faceset ->coordIndex  .finishEditing();
-        faceset ->partIndex   .finishEditing();
-        lineset ->coordIndex  .finishEditing();
+        data->numEdges = numEdges;
+        data->time = Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo());
+        data->valid = true;
     }
     catch (...) {
+        data->valid = false;
+    }
+
+    return data;
+}
+
+void ViewProviderPartExt::applyVisual(const TessellationData& data)
+{
+    if (!data.valid) {
         FC_ERR("Cannot compute Inventor representation for the shape of " << pcObject->getFullName());
+        return;
     }
 
+    Gui::SoUpdateVBOAction action;
+    action.apply(this->faceset);
+
+    // Clear selection
+    Gui::SoSelectionElementAction saction(Gui::SoSelectionElementAction::None);
+    saction.apply(this->faceset);
+    saction.apply(this->lineset);
+    saction.apply(this->nodeset);
+
+    // Clear highlighting
+    Gui::SoHighlightElementAction haction;
+    haction.apply(this->faceset);
+    haction.apply(this->lineset);
+    haction.apply(this->nodeset);
+
+    // copy the buffers at once so that the old and new visual are never mixed
+    coords  ->point      .setNum(static_cast<int>(data.verts.size()));
+    norm    ->vector     .setNum(static_cast<int>(data.norms.size()));
+    faceset ->coordIndex .setNum(static_cast<int>(data.faceIndex.size()));
+    faceset ->partIndex  .setNum(static_cast<int>(data.partIndex.size()));
+    lineset ->coordIndex .setNum(static_cast<int>(data.lineIndex.size()));
+    if (!data.verts.empty())
+        coords  ->point      .setValues(0, static_cast<int>(data.verts.size()), data.verts.data());
+    if (!data.norms.empty())
+        norm    ->vector     .setValues(0, static_cast<int>(data.norms.size()), data.norms.data());
+    if (!data.faceIndex.empty())
+        faceset ->coordIndex .setValues(0, static_cast<int>(data.faceIndex.size()), data.faceIndex.data());
+    if (!data.partIndex.empty())
+        faceset ->partIndex  .setValues(0, static_cast<int>(data.partIndex.size()), data.partIndex.data());
+    if (!data.lineIndex.empty())
+        lineset ->coordIndex .setValues(0, static_cast<int>(data.lineIndex.size()), data.lineIndex.data());
+    nodeset ->startIndex .setValue(data.nodeIndex);
+
 #   ifdef FC_DEBUG
         // printing some information
-        Base::Console().Log("ViewProvider update time: %f s\n",Base::TimeInfo::diffTimeF(start_time,Base::TimeInfo()));
-        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",numFaces,numEdges,numNodes,numTriangles,numLines);
+        Base::Console().Log("ViewProvider update time: %f s\n",data.time);
+        Base::Console().Log("Shape tria info: Faces:%d Edges:%d Nodes:%d Triangles:%d IdxVec:%d\n",
+            static_cast<int>(data.partIndex.size()), data.numEdges, static_cast<int>(data.verts.size()),
+            static_cast<int>(data.faceIndex.size()/4), static_cast<int>(data.lineIndex.size()));
 #   endif
-    VisualTouched = false;
 }
+
 void ViewProviderPartExt::forceUpdate(bool enable) {
     if(enable) {
         if(++forceUpdateCount == 1) {
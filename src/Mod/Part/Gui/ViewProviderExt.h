@@ -32,8 +32,11 @@
 #include <TColgp_Array1OfDir.hxx>
 #include <App/PropertyUnits.h>
 #include <Gui/ViewProviderGeometryObject.h>
+#include <atomic>
 #include <map>
+#include <memory>
 #include <Mod/Part/App/PartFeature.h>
+#include "PropertyTessellation.h"
 
 class TopoDS_Shape;
 class TopoDS_Edge;
@@ -90,6 +93,8 @@ public:
     App::PropertyColorList LineColorArray;
     // Faces (Gui::ViewProviderGeometryObject::ShapeColor and Gui::ViewProviderGeometryObject::ShapeMaterial apply)
     App::PropertyColorList DiffuseColor;
+    // Tessellation saved in the project file
+    PropertyTessellation TessellationCache;
 
     virtual void attach(App::DocumentObject *) override;
     virtual void setDisplayMode(const char* ModeName) override;
@@ -101,6 +106,7 @@ public:
     bool changeFaceColors();
 
     virtual void updateData(const App::Property*) override;
+    virtual void finishRestoring() override;
 
     /** @name Selection handling
      * This group of methods do the selection handling.
@@ -157,9 +163,16 @@ protected:
     /// get called by the container whenever a property has been changed
     virtual void onChanged(const App::Property* prop) override;
     bool loadParameter();
+    /// Tessellates the shape and updates the nodes at once
     void updateVisual();
-    void getNormals(const TopoDS_Face&  theFace, const Handle(Poly_Triangulation)& aPolyTri,
-                    TColgp_Array1OfDir& theNormals);
+    /** Tessellates the shape in the global thread pool and swaps in the new
+     * visual when it's ready. The previous visual is shown until then. A
+     * pending tessellation is canceled if the shape changes again.
+     * Falls back to updateVisual() if an update is forced.
+     */
+    void updateVisualInBackground();
+    static void getNormals(const TopoDS_Face&  theFace, const Handle(Poly_Triangulation)& aPolyTri,
+                           TColgp_Array1OfDir& theNormals);
 
     // nodes for the data representation
     SoMaterialBinding * pcFaceBind;
@@ -180,8 +193,37 @@ protected:
 
     bool VisualTouched;
     bool NormalsFromUV;
+    bool BackgroundTessellation;
+    bool SaveTessellation;
 
 private:
+    struct VisualJob;
+    struct SharedVisual;
+    struct FaceMeshes;
+    /** Meshes \a shape and converts the triangulation. If \a result is given, \a shape must
+     * be a copy of \a original. The faces meshed before are then taken from \a previous and
+     * the meshed faces are stored in \a result.
+     */
+    static std::shared_ptr<TessellationData> tessellate(TopoDS_Shape shape, double deviation,
+        double angularDeflection, bool normalsFromUV, std::shared_ptr< std::atomic<bool> > canceled,
+        TopoDS_Shape original = TopoDS_Shape(), std::shared_ptr<const FaceMeshes> previous = nullptr,
+        std::shared_ptr<FaceMeshes> result = nullptr);
+    void applyVisual(const TessellationData&);
+    /// Returns the key of the tessellation cache or an empty string if the cache is not used
+    std::string tessellationKey(const TopoDS_Shape&) const;
+    /// Shows the cached tessellation if it matches \a key, only used for the restored shape
+    bool applyCachedVisual(const std::string& key);
+    void storeCachedVisual(const std::string& key, const std::shared_ptr<const TessellationData>&);
+    /// Shows the tessellation of another view provider with the same shared shape
+    bool applySharedVisual(const TopoDS_Shape&);
+    void storeSharedVisual(const TopoDS_Shape&, const std::shared_ptr<const TessellationData>&);
+    void finishVisualUpdate();
+    void cancelVisualUpdate();
+
+    VisualJob* visualJob;
+    bool restoringVisual;
+    std::shared_ptr<SharedVisual> sharedVisual;
+    std::shared_ptr<const FaceMeshes> faceMeshes;
     // settings stuff
     int forceUpdateCount;
     static App::PropertyFloatConstraint::Constraints sizeRange;
@@ -20,6 +20,7 @@
 #**************************************************************************
 
 import FreeCAD, os, sys, unittest, Part
+import array, math
 import copy 
 from FreeCAD import Units
 App = FreeCAD
@@ -151,3 +152,273 @@ class PartTestBSplineCurve(unittest.TestCase):
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartTest")
+
+class PartTestRefine(unittest.TestCase):
+    def makeBoxes(self, count):
+        boxes = []
+        for i in range(count):
+            for j in range(count):
+                boxes.append(Part.makeBox(1, 1, 1, App.Vector(i, j, 0)))
+        return boxes[0].multiFuse(boxes[1:])
+
+    def testCoplanarFaces(self):
+        shape = self.makeBoxes(5).removeSplitter()
+        self.assertTrue(shape.isValid())
+        self.assertEqual(len(shape.Faces), 6)
+        self.assertAlmostEqual(shape.Volume, 25, 6)
+
+    def testCylindricalFaces(self):
+        # stacked cylinders of the same axis and radius plus a coaxial one of another radius
+        shape = Part.makeCylinder(1, 1).fuse(Part.makeCylinder(1, 1, App.Vector(0, 0, 1)))
+        shape = shape.fuse(Part.makeCylinder(0.5, 1, App.Vector(0, 0, 2)))
+        shape = shape.removeSplitter()
+        self.assertTrue(shape.isValid())
+        self.assertEqual(len([f for f in shape.Faces if isinstance(f.Surface, Part.Cylinder)]), 2)
+
+class PartTestMultiFuse(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PartMultiFuse")
+
+    def makeFuse(self, count, method):
+        # a grid of overlapping cylinders
+        cylinders = []
+        for i in range(count):
+            for j in range(count):
+                cylinders.append(Part.makeCylinder(0.6, 1, App.Vector(i, j, 0)))
+        comp = self.Doc.addObject("Part::Feature", "Cylinders")
+        comp.Shape = Part.Compound(cylinders)
+        fuse = self.Doc.addObject("Part::MultiFuse", "Fusion")
+        fuse.Shapes = [comp]
+        fuse.Method = method
+        return fuse
+
+    def testHierarchical(self):
+        fuse1 = self.makeFuse(6, "Simultaneous")
+        fuse2 = self.makeFuse(6, "Hierarchical")
+        self.Doc.recompute()
+        self.assertTrue(fuse2.Shape.isValid())
+        self.assertEqual(len(fuse2.Shape.Solids), 1)
+        self.assertAlmostEqual(fuse1.Shape.Volume, fuse2.Shape.Volume, 6)
+        self.assertEqual(len(fuse1.History), len(fuse2.History))
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
+
+class PartTestGeometryStore(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PartGeometryStore")
+        self.Param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/Part/General")
+        self.Share = self.Param.GetBool("ShareIdenticalShapes", False)
+        self.Param.SetBool("ShareIdenticalShapes", True)
+
+    def testIdenticalShapes(self):
+        # independent copies of the same part at different places
+        shape = Part.makeCylinder(1, 5).fuse(Part.makeBox(2, 2, 2))
+        features = []
+        for i in range(3):
+            copy = shape.copy()
+            copy.Placement = App.Placement(App.Vector(5 * i, 0, 0), App.Rotation(App.Vector(0, 0, 1), 30 * i))
+            obj = self.Doc.addObject("Part::Feature", "Fastener")
+            obj.Shape = copy
+            features.append(obj)
+        other = self.Doc.addObject("Part::Feature", "Other")
+        other.Shape = Part.makeBox(2, 2, 2)
+
+        for obj in features[1:]:
+            self.assertTrue(obj.Shape.isPartner(features[0].Shape))
+            self.assertFalse(obj.Shape.isSame(features[0].Shape))
+        self.assertFalse(other.Shape.isPartner(features[0].Shape))
+        self.assertEqual(features[2].Placement.Base, App.Vector(10, 0, 0))
+        self.assertAlmostEqual(features[2].Shape.Volume, shape.Volume, 6)
+
+    def testParametricShapes(self):
+        # the shapes of parametric features are left alone
+        box1 = self.Doc.addObject("Part::Box", "Box")
+        box2 = self.Doc.addObject("Part::Box", "Box")
+        self.Doc.recompute()
+        self.assertFalse(box1.Shape.isPartner(box2.Shape))
+
+    def tearDown(self):
+        self.Param.SetBool("ShareIdenticalShapes", self.Share)
+        FreeCAD.closeDocument(self.Doc.Name)
+
+class PartTestCrossSection(unittest.TestCase):
+    def compareSlices(self, shape, direction, dists):
+        compound = shape.slices(direction, dists)
+        wires = []
+        for d in dists:
+            wires.extend(shape.slice(direction, d))
+        self.assertEqual(len(compound.Wires), len(wires))
+        self.assertAlmostEqual(compound.Length, sum(w.Length for w in wires), 6)
+
+    def testSolids(self):
+        shape = Part.makeTorus(10, 2).fuse(Part.makeBox(5, 5, 5, App.Vector(20, 0, -2)))
+        self.compareSlices(shape, App.Vector(0, 0, 1), [0.5 * i - 3 for i in range(13)])
+
+    def testShells(self):
+        shape = Part.makeSphere(5).Shells[0].cut(Part.makeBox(10, 10, 10))
+        shape = Part.Compound([shape, Part.makePlane(4, 4, App.Vector(10, 0, 0), App.Vector(1, 0, 0))])
+        self.compareSlices(shape, App.Vector(0, 1, 1), [0.5 * i - 6 for i in range(25)])
+
+class PartTestFaceMaker(unittest.TestCase):
+    def makePanel(self, count, origin=App.Vector()):
+        points = [App.Vector(0, 0, 0), App.Vector(count, 0, 0), App.Vector(count, count, 0), App.Vector(0, count, 0)]
+        wires = [Part.makePolygon([origin + p for p in points + points[:1]])]
+        for i in range(count):
+            for j in range(count):
+                wires.append(Part.Wire(Part.makeCircle(0.25, origin + App.Vector(i + 0.5, j + 0.5, 0))))
+        return wires
+
+    def testPanel(self):
+        for maker in ("Part::FaceMakerBullseye", "Part::FaceMakerCheese"):
+            face = Part.makeFace(self.makePanel(10), maker)
+            self.assertEqual(len(face.Faces), 1)
+            self.assertEqual(len(face.Faces[0].Wires), 101)
+            self.assertAlmostEqual(face.Area, 100 - 100 * math.pi * 0.0625, 6)
+
+    def testSeparatePanels(self):
+        wires = self.makePanel(3) + self.makePanel(3, App.Vector(5, 0, 0)) + self.makePanel(3, App.Vector(0, 5, 0))
+        for maker in ("Part::FaceMakerBullseye", "Part::FaceMakerCheese"):
+            face = Part.makeFace(wires, maker)
+            self.assertEqual(len(face.Faces), 3)
+            self.assertAlmostEqual(face.Area, 3 * (9 - 9 * math.pi * 0.0625), 6)
+
+    def testIslands(self):
+        wires = self.makePanel(4)
+        wires += [Part.Wire(Part.makeCircle(0.1, App.Vector(i + 0.5, 0.5, 0))) for i in range(4)]
+        face = Part.makeFace(wires, "Part::FaceMakerBullseye")
+        self.assertEqual(len(face.Faces), 5)
+        self.assertAlmostEqual(face.Area, 16 - 16 * math.pi * 0.0625 + 4 * math.pi * 0.01, 6)
+
+class PartTestAttachment(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PartAttachment")
+        self.Box = self.Doc.addObject("Part::Box", "Box")
+        self.Doc.recompute()
+
+    def makeAttached(self, support, mode):
+        obj = self.Doc.addObject("Part::Box", "Attached")
+        obj.Support = support
+        obj.MapMode = mode
+        return obj
+
+    def testPositionBySupport(self):
+        top = [self.makeAttached([(self.Box, "Face6")], "FlatFace") for i in range(20)]
+        chain = [top[0]]
+        for i in range(5):
+            chain.append(self.makeAttached([(chain[-1], "")], "ObjectXY"))
+        self.Doc.recompute()
+        self.assertAlmostEqual(chain[-1].Placement.Base.z, 10, 6)
+
+        # only the box is recomputed, the attached objects are placed at once
+        self.Box.Height = 20
+        self.Box.recompute()
+        objs = list(reversed(top + chain[1:]))
+        info = Part.getShapeCacheInfo()
+        self.assertEqual(Part.positionBySupport(objs), len(objs))
+        self.assertGreater(Part.getShapeCacheInfo()["Hits"], info["Hits"])
+        for obj in objs:
+            self.assertAlmostEqual(obj.Placement.Base.z, 20, 6)
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
+
+class PartTestBatchEvaluation(unittest.TestCase):
+    def setUp(self):
+        poles = [App.Vector(i, (i % 3) * 2, i % 2) for i in range(20)]
+        self.Curve = Part.BSplineCurve()
+        self.Curve.buildFromPoles(poles)
+        self.Surface = Part.Sphere()
+        self.Surface.Radius = 3
+
+    def testCurve(self):
+        u0, u1 = self.Curve.FirstParameter, self.Curve.LastParameter
+        params = [u0 + (u1 - u0) * i / 5000.0 for i in range(5001)]
+        points, normals, curvatures = self.Curve.evaluate(params, Normals=True, Curvature=True)
+        for i in range(0, len(params), 97):
+            self.assertTrue(points[i].isEqual(self.Curve.value(params[i]), 1e-9))
+            self.assertTrue(normals[i].isEqual(self.Curve.normal(params[i]), 1e-9))
+            self.assertAlmostEqual(curvatures[i], self.Curve.curvature(params[i]), 9)
+
+        # a line has no normal
+        line = Part.LineSegment(App.Vector(), App.Vector(1, 0, 0))
+        normals = line.evaluate([0.2, 0.5], Normals=True)[1]
+        self.assertEqual(normals[0], App.Vector())
+
+    def testSurface(self):
+        params = [(0.01 * i, 0.001 * i - 1.0) for i in range(2000)]
+        points, normals, curvatures = self.Surface.evaluate(params, Normals=True, Curvature="Gauss")
+        for i in range(0, len(params), 53):
+            self.assertTrue(points[i].isEqual(self.Surface.value(*params[i]), 1e-9))
+            self.assertTrue(normals[i].isEqual(self.Surface.normal(*params[i]), 1e-9))
+            self.assertAlmostEqual(curvatures[i], self.Surface.curvature(params[i][0], params[i][1], "Gauss"), 9)
+        with self.assertRaises(ValueError):
+            self.Surface.evaluate(params, Curvature="Foo")
+
+    def testBuffer(self):
+        u0, u1 = self.Curve.FirstParameter, self.Curve.LastParameter
+        params = array.array('d', [u0 + (u1 - u0) * 0.001 * i for i in range(1000)])
+        points, curvatures = self.Curve.evaluate(params, Curvature=True)
+        self.assertEqual(points.shape, (1000, 3))
+        self.assertEqual(curvatures.shape, (1000,))
+        self.assertAlmostEqual(points[500, 1], self.Curve.value(params[500]).y, 9)
+        self.assertAlmostEqual(curvatures[500], self.Curve.curvature(params[500]), 9)
+
+        uv = array.array('d', [0.5, 0.25, 1.0, -0.5])
+        points = self.Surface.evaluate(uv)
+        self.assertEqual(points.shape, (2, 3))
+        self.assertAlmostEqual(points[1, 2], self.Surface.value(1.0, -0.5).z, 9)
+        with self.assertRaises(TypeError):
+            self.Curve.evaluate(array.array('f', [0.5]))
+
+class PartTestShapeCache(unittest.TestCase):
+    def setUp(self):
+        self.Doc = FreeCAD.newDocument("PartShapeCache")
+        Part.clearShapeCache()
+
+    def testSubElement(self):
+        box = self.Doc.addObject("Part::Box", "Box")
+        self.Doc.recompute()
+        face = Part.getShape(box, "Face6", needSubElement=True)
+        info = Part.getShapeCacheInfo()
+        face = Part.getShape(box, "Face6", needSubElement=True)
+        self.assertGreater(Part.getShapeCacheInfo()["Hits"], info["Hits"])
+        self.assertTrue(face.isEqual(box.Shape.Face6))
+
+        # changing the shape invalidates the cached elements
+        box.Height = 20
+        self.Doc.recompute()
+        face = Part.getShape(box, "Face6", needSubElement=True)
+        self.assertAlmostEqual(face.CenterOfMass.z, 20, 6)
+
+    def testTransformedSubElement(self):
+        part = self.Doc.addObject("App::Part", "Part")
+        box = self.Doc.addObject("Part::Box", "Box")
+        part.addObject(box)
+        part.Placement.Base = App.Vector(0, 0, 10)
+        box.Placement.Base = App.Vector(5, 0, 0)
+        self.Doc.recompute()
+        for i in range(2):
+            face = Part.getShape(part, "Box.Face6", needSubElement=True)
+            self.assertAlmostEqual(face.CenterOfMass.x, 10, 6)
+            self.assertAlmostEqual(face.CenterOfMass.z, 20, 6)
+        face = Part.getShape(box, "Face6", needSubElement=True)
+        self.assertTrue(face.isEqual(box.Shape.Face6))
+
+    def testLimit(self):
+        info = Part.getShapeCacheInfo()
+        self.assertLessEqual(info["MemSize"], info["MaxMemSize"])
+        for i in range(10):
+            box = self.Doc.addObject("Part::Box", "Box")
+        self.Doc.recompute()
+        for obj in self.Doc.Objects:
+            for i in range(6):
+                Part.getShape(obj, "Face{}".format(i + 1), needSubElement=True)
+        info = Part.getShapeCacheInfo()
+        self.assertGreaterEqual(info["Entries"], 60)
+        self.assertLessEqual(info["MemSize"], info["MaxMemSize"])
+        Part.clearShapeCache()
+        self.assertEqual(Part.getShapeCacheInfo()["Entries"], 0)
+
+    def tearDown(self):
+        FreeCAD.closeDocument(self.Doc.Name)
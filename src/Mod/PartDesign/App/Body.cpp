@@ -24,9 +24,17 @@
 #include "PreCompiled.h"
 
 #ifndef _PreComp_
+# include <limits>
+# include <sstream>
+# include <BRepTools_ShapeSet.hxx>
+# include <gp_Trsf.hxx>
+# include <TopExp.hxx>
+# include <TopTools_IndexedMapOfShape.hxx>
+# include <TopoDS_TShape.hxx>
 #endif
 
 #include <Base/Console.h>
+#include <Base/Parameter.h>
 #include <Base/Placement.h>
 
 #include <App/Application.h>
@@ -51,6 +59,52 @@
 
 using namespace PartDesign;
 
+namespace {
+// The BRep data of the shape. The full precision is needed so that only
+// identical shapes get the same data.
+std::string shapeData(const TopoDS_Shape& shape)
+{
+    std::ostringstream str;
+    str.precision(std::numeric_limits<double>::digits10 + 1);
+    BRepTools_ShapeSet set(Standard_False);
+    set.Add(shape);
+    set.Write(str);
+    set.Write(shape, str);
+    return str.str();
+}
+
+// A rough estimate of the memory held by the sub-shapes and their geometry
+std::size_t estimateSize(const TopoDS_Shape& shape)
+{
+    TopTools_IndexedMapOfShape map;
+    TopExp::MapShapes(shape, map);
+    return map.Extent() * (sizeof(TopoDS_Shape) + sizeof(TopoDS_TShape) + 64);
+}
+
+// Checks if both shapes are the same shape at the same place. Unlike TopoDS_Shape::IsEqual
+// the locations are compared by their values because every recompute moves the base shape
+// with a new location.
+bool isSameBase(const TopoDS_Shape& shape1, const TopoDS_Shape& shape2)
+{
+    if (shape1.IsNull() || shape2.IsNull())
+        return shape1.IsNull() && shape2.IsNull();
+    if (!shape1.IsPartner(shape2) || shape1.Orientation() != shape2.Orientation())
+        return false;
+
+    gp_Trsf trsf1 = shape1.Location().Transformation();
+    gp_Trsf trsf2 = shape2.Location().Transformation();
+    if (trsf1.ScaleFactor() != trsf2.ScaleFactor())
+        return false;
+    for (int row = 1; row <= 3; ++row) {
+        for (int col = 1; col <= 4; ++col) {
+            if (trsf1.Value(row, col) != trsf2.Value(row, col))
+                return false;
+        }
+    }
+    return true;
+}
+}
+
 
 PROPERTY_SOURCE(PartDesign::Body, Part::BodyBase)
 
@@ -383,10 +437,82 @@ std::vector<App::DocumentObject*> Body::removeObject(App::DocumentObject* featur
         model.erase(it);
         Group.setValues(model);
     }
+    clearCachedResults(feature);
     std::vector<App::DocumentObject*> result = {feature};
     return result;
 }
 
+TopoDS_Shape Body::getCachedResult(const App::DocumentObject* feature, int variant,
+                                   const TopoDS_Shape& base, const TopoDS_Shape& tool)
+{
+    if (tool.IsNull())
+        return TopoDS_Shape();
+
+    // the BRep data of the tools is only written for entries with the same base
+    std::string data;
+    for (auto it = cachedResults.begin(); it != cachedResults.end(); ++it) {
+        if (it->feature != feature || it->variant != variant || !isSameBase(it->base, base))
+            continue;
+        if (data.empty())
+            data = shapeData(tool);
+        if (it->toolData.empty()) {
+            it->toolData = shapeData(it->tool);
+            it->memSize += it->toolData.size();
+            cachedResultsSize += it->toolData.size();
+        }
+        if (it->toolData != data)
+            continue;
+        cachedResults.splice(cachedResults.begin(), cachedResults, it);
+        return it->result;
+    }
+
+    return TopoDS_Shape();
+}
+
+void Body::setCachedResult(const App::DocumentObject* feature, int variant,
+                           const TopoDS_Shape& base, const TopoDS_Shape& tool,
+                           const TopoDS_Shape& result)
+{
+    long maxSize = App::GetApplication().GetParameterGroupByPath
+        ("User parameter:BaseApp/Preferences/Mod/PartDesign")->GetInt("ResultCacheSize", 0);
+    if (maxSize <= 0) {
+        clearCachedResults();
+        return;
+    }
+    if (tool.IsNull() || result.IsNull())
+        return;
+
+    CachedResult entry;
+    entry.feature = feature;
+    entry.variant = variant;
+    entry.base = base;
+    entry.tool = tool;
+    entry.result = result;
+    // the base shapes are mostly the results of the previous features, so
+    // only the tools and results are counted
+    entry.memSize = estimateSize(result) + estimateSize(tool);
+    cachedResultsSize += entry.memSize;
+    cachedResults.push_front(std::move(entry));
+
+    std::size_t limit = static_cast<std::size_t>(maxSize) << 20;
+    while (cachedResultsSize > limit && !cachedResults.empty()) {
+        cachedResultsSize -= cachedResults.back().memSize;
+        cachedResults.pop_back();
+    }
+}
+
+void Body::clearCachedResults(const App::DocumentObject* feature)
+{
+    for (auto it = cachedResults.begin(); it != cachedResults.end();) {
+        if (feature && it->feature != feature) {
+            ++it;
+            continue;
+        }
+        cachedResultsSize -= it->memSize;
+        it = cachedResults.erase(it);
+    }
+}
+
 
 App::DocumentObjectExecReturn *Body::execute(void)
 {
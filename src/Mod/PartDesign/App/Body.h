@@ -24,6 +24,8 @@
 #ifndef PARTDESIGN_Body_H
 #define PARTDESIGN_Body_H
 
+#include <list>
+#include <TopoDS_Shape.hxx>
 #include <App/PropertyStandard.h>
 #include <Mod/Part/App/BodyBase.h>
 
@@ -137,6 +139,31 @@ public:
       */
     App::DocumentObject *getNextSolidFeature(App::DocumentObject* start = NULL);
 
+    /** @name Result cache
+     * The body keeps the results of its features for the inputs they were computed
+     * from, i.e. the base shape and the tool shape. When a feature is changed and
+     * changed back, or when a feature before it is changed in a way that leaves its
+     * shape untouched, the following features find their results here instead of
+     * repeating their boolean operations. Since an unchanged result keeps its TShape,
+     * the features after it hit the cache as well.
+     *
+     * The base shapes are compared by their TShape and the values of their location,
+     * the tool shapes by their BRep data. The least recently used results are dropped
+     * once their estimated size exceeds the user preference "ResultCacheSize" in MB.
+     * The cache is disabled by default (0).
+     */
+    //@{
+    /// Returns the cached result of \a feature for the given inputs, or a null shape
+    TopoDS_Shape getCachedResult(const App::DocumentObject* feature, int variant,
+                                 const TopoDS_Shape& base, const TopoDS_Shape& tool);
+    /// Stores \a result as the result of \a feature for the given inputs
+    void setCachedResult(const App::DocumentObject* feature, int variant,
+                         const TopoDS_Shape& base, const TopoDS_Shape& tool,
+                         const TopoDS_Shape& result);
+    /// Drops the cached results of \a feature, or all results if it is null
+    void clearCachedResults(const App::DocumentObject* feature = nullptr);
+    //@}
+
 protected:
     virtual void onSettingDocument() override;
 
@@ -153,6 +180,18 @@ protected:
 private:
     boost::signals2::scoped_connection connection;
     bool showTip = false;
+
+    struct CachedResult {
+        const App::DocumentObject* feature;
+        int variant;
+        TopoDS_Shape base;
+        TopoDS_Shape tool;
+        std::string toolData;   /**< The BRep data of the tool, written on the first compare. */
+        TopoDS_Shape result;
+        std::size_t memSize;
+    };
+    std::list<CachedResult> cachedResults; /**< Most recently used first. */
+    std::size_t cachedResultsSize = 0;
 };
 
 } //namespace PartDesign
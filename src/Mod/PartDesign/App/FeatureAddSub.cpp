@@ -31,6 +31,7 @@
 #include <App/Application.h>
 #include <App/FeaturePythonPyImp.h>
 #include <Mod/Part/App/modelRefine.h>
+#include "Body.h"
 #include "FeatureAddSub.h"
 #include "FeaturePy.h"
 
@@ -81,6 +82,24 @@ TopoDS_Shape FeatureAddSub::refineShapeIfActive(const TopoDS_Shape& oldShape) co
     return oldShape;
 }
 
+TopoDS_Shape FeatureAddSub::getCachedResult(const TopoDS_Shape& base, const TopoDS_Shape& tool) const
+{
+    Body* body = getFeatureBody();
+    if (!body)
+        return TopoDS_Shape();
+    int variant = addSubType | (Refine.getValue() ? 2 : 0);
+    return body->getCachedResult(this, variant, base, tool);
+}
+
+void FeatureAddSub::cacheResult(const TopoDS_Shape& base, const TopoDS_Shape& tool) const
+{
+    Body* body = getFeatureBody();
+    if (!body)
+        return;
+    int variant = addSubType | (Refine.getValue() ? 2 : 0);
+    body->setCachedResult(this, variant, base, tool, Shape.getValue());
+}
+
 void FeatureAddSub::getAddSubShape(Part::TopoShape &addShape, Part::TopoShape &subShape)
 {
     if (addSubType == Additive)
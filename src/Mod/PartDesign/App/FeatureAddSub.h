@@ -58,6 +58,13 @@ protected:
     Type addSubType;
 
     TopoDS_Shape refineShapeIfActive(const TopoDS_Shape&) const;
+
+    /** Returns the result of an earlier recompute that applied \a tool to \a base,
+     * or a null shape. The results are kept by the body, see Body::getCachedResult().
+     */
+    TopoDS_Shape getCachedResult(const TopoDS_Shape& base, const TopoDS_Shape& tool) const;
+    /// Remembers the current Shape as the result of applying \a tool to \a base
+    void cacheResult(const TopoDS_Shape& base, const TopoDS_Shape& tool) const;
 };
 
 typedef App::FeaturePythonT<FeatureAddSub> FeatureAddSubPython;
@@ -136,38 +136,36 @@ App::DocumentObjectExecReturn *Chamfer::execute(void)
     Part::TopoShape baseShape(TopShape);
     baseShape.setTransform(Base::Matrix4D());
     try {
-        BRepFilletAPI_MakeChamfer mkChamfer(baseShape.getShape());
-
-        TopTools_IndexedMapOfShape mapOfEdges;
         TopTools_IndexedDataMapOfShapeListOfShape mapEdgeFace;
         TopExp::MapShapesAndAncestors(baseShape.getShape(), TopAbs_EDGE, TopAbs_FACE, mapEdgeFace);
-        TopExp::MapShapes(baseShape.getShape(), TopAbs_EDGE, mapOfEdges);
-
-        for (std::vector<std::string>::const_iterator it=SubNames.begin(); it != SubNames.end(); ++it) {
-            TopoDS_Edge edge = TopoDS::Edge(baseShape.getSubShape(it->c_str()));
-            const TopoDS_Face& face = (chamferType != 0 && flipDirection) ?
-                TopoDS::Face(mapEdgeFace.FindFromKey(edge).Last()) :
-                TopoDS::Face(mapEdgeFace.FindFromKey(edge).First());
-            switch (chamferType) {
-                case 0: // Equal distance
-                    mkChamfer.Add(size, size, edge, face);
-                    break;
-                case 1: // Two distances
-                    mkChamfer.Add(size, size2, edge, face);
-                    break;
-                case 2: // Distance and angle
-                    mkChamfer.AddDA(size, Base::toRadians(angle), edge, face);
-                    break;
-            }
-        }
 
-        mkChamfer.Build();
-        if (!mkChamfer.IsDone())
-            return new App::DocumentObjectExecReturn("Failed to create chamfer");
+        auto makeChamfer = [&](const TopoDS_Shape& base, const std::vector<TopoDS_Edge>& edges) {
+            BRepFilletAPI_MakeChamfer* mkChamfer = new BRepFilletAPI_MakeChamfer(base);
+            for (const TopoDS_Edge& edge : edges) {
+                const TopoDS_Face& face = (chamferType != 0 && flipDirection) ?
+                    TopoDS::Face(mapEdgeFace.FindFromKey(edge).Last()) :
+                    TopoDS::Face(mapEdgeFace.FindFromKey(edge).First());
+                switch (chamferType) {
+                    case 0: // Equal distance
+                        mkChamfer->Add(size, size, edge, face);
+                        break;
+                    case 1: // Two distances
+                        mkChamfer->Add(size, size2, edge, face);
+                        break;
+                    case 2: // Distance and angle
+                        mkChamfer->AddDA(size, Base::toRadians(angle), edge, face);
+                        break;
+                }
+            }
+            return mkChamfer;
+        };
 
-        TopoDS_Shape shape = mkChamfer.Shape();
+        std::string failedEdges;
+        TopoDS_Shape shape = makeEdgeOperation(baseShape.getShape(), SubNames, makeChamfer, failedEdges);
+        if (!failedEdges.empty())
+            return new App::DocumentObjectExecReturn(("Failed to create chamfer on " + failedEdges).c_str());
         if (shape.IsNull())
-            return new App::DocumentObjectExecReturn("Resulting shape is null");
+            return new App::DocumentObjectExecReturn("Failed to create chamfer");
 
         TopTools_ListOfShape aLarg;
         aLarg.Append(baseShape.getShape());
@@ -25,16 +25,32 @@
 #ifndef _PreComp_
 #include <TopTools_IndexedMapOfShape.hxx>
 #include <TopTools_IndexedDataMapOfShapeListOfShape.hxx>
+#include <TopTools_ListIteratorOfListOfShape.hxx>
 #include <TopExp.hxx>
+#include <TopExp_Explorer.hxx>
 #include <TopoDS.hxx>
+#include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
+#include <BRepBuilderAPI_MakeSolid.hxx>
+#include <BRepCheck_Analyzer.hxx>
+#include <BRepCheck_Shell.hxx>
+#include <BRepFilletAPI_LocalOperation.hxx>
+#include <BRepLib.hxx>
 #include <TopoDS_Edge.hxx>
+#include <TopoDS_Shell.hxx>
+#include <TopoDS_Solid.hxx>
 #endif
 
+#include <map>
+#include <memory>
+#include <QtConcurrentMap>
 
 #include "FeatureDressUp.h"
+#include <App/Application.h>
 #include <App/Document.h>
+#include <Base/Console.h>
 #include <Base/Exception.h>
+#include <Base/Parameter.h>
 
 
 
@@ -162,6 +178,216 @@ void DressUp::getContiniusEdges(Part::TopoShape TopShape, std::vector< std::stri
     }
 }
 
+namespace {
+
+/// Edges of a dress-up that are built together, and the faces their result replaces
+struct EdgeGroup
+{
+    std::vector<TopoDS_Edge> edges;
+    std::vector<std::string> names;
+    std::vector<int> removedFaces;
+    std::vector<TopoDS_Shape> addedFaces;
+    std::vector<std::string> failedEdges;
+};
+
+int findGroup(std::vector<int>& groups, int i)
+{
+    while (groups[i] != i)
+        i = groups[i] = groups[groups[i]];
+    return i;
+}
+
+bool buildEdgeOperation(const DressUp::EdgeOperation& make, const TopoDS_Shape& shape,
+                        const std::vector<TopoDS_Edge>& edges, TopoDS_Shape& result)
+{
+    try {
+        std::unique_ptr<BRepFilletAPI_LocalOperation> mk(make(shape, edges));
+        mk->Build();
+        if (!mk->IsDone())
+            return false;
+        result = mk->Shape();
+        return !result.IsNull();
+    }
+    catch (Standard_Failure&) {
+        return false;
+    }
+}
+
+/// Returns the edges which also fail on their own, or all edges if they only fail together
+std::vector<std::string> findFailedEdges(const DressUp::EdgeOperation& make, const TopoDS_Shape& shape,
+                                         const std::vector<TopoDS_Edge>& edges,
+                                         const std::vector<std::string>& names)
+{
+    std::vector<std::string> failed;
+    for (std::size_t i = 0; i < edges.size(); ++i) {
+        TopoDS_Shape single;
+        std::vector<TopoDS_Edge> edge(1, edges[i]);
+        if (!buildEdgeOperation(make, shape, edge, single))
+            failed.push_back(names[i]);
+    }
+    if (failed.empty())
+        failed = names;
+    return failed;
+}
+
+}
+
+TopoDS_Shape DressUp::makeEdgeOperation(const TopoDS_Shape& shape, const std::vector<std::string>& edgeNames,
+                                        const EdgeOperation& make, std::string& failedEdges) const
+{
+    TopTools_IndexedMapOfShape mapOfEdges;
+    TopExp::MapShapes(shape, TopAbs_EDGE, mapOfEdges);
+
+    std::vector<TopoDS_Edge> edges;
+    edges.reserve(edgeNames.size());
+    for (const std::string& name : edgeNames) {
+        auto index = Part::TopoShape::shapeTypeAndIndex(name.c_str());
+        if (index.first == TopAbs_EDGE && index.second >= 1 && index.second <= mapOfEdges.Extent())
+            edges.push_back(TopoDS::Edge(mapOfEdges.FindKey(index.second)));
+        else
+            edges.push_back(TopoDS::Edge(Part::TopoShape(shape).getSubShape(name.c_str())));
+    }
+
+    int shells = 0;
+    for (TopExp_Explorer xp(shape, TopAbs_SHELL); xp.More(); xp.Next())
+        ++shells;
+
+    Base::Reference<ParameterGrp> hGrp = App::GetApplication().GetUserParameter()
+        .GetGroup("BaseApp")->GetGroup("Preferences")->GetGroup("Mod/PartDesign");
+    if (edges.size() > 1 && shells == 1 && hGrp->GetBool("ParallelDressUp", false)) {
+        // Edges whose vertices touch a common face influence each other and go into the
+        // same group. The faces outside of a group are left untouched by its operation.
+        TopTools_IndexedMapOfShape mapOfFaces;
+        TopTools_IndexedDataMapOfShapeListOfShape mapVertexFace;
+        TopExp::MapShapes(shape, TopAbs_FACE, mapOfFaces);
+        TopExp::MapShapesAndAncestors(shape, TopAbs_VERTEX, TopAbs_FACE, mapVertexFace);
+
+        std::vector<int> parents(edges.size());
+        std::vector<int> faceOwners(mapOfFaces.Extent() + 1, -1);
+        for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
+            parents[i] = i;
+            for (TopExp_Explorer xp(edges[i], TopAbs_VERTEX); xp.More(); xp.Next()) {
+                const TopTools_ListOfShape& faces = mapVertexFace.FindFromKey(xp.Current());
+                for (TopTools_ListIteratorOfListOfShape it(faces); it.More(); it.Next()) {
+                    int& owner = faceOwners[mapOfFaces.FindIndex(it.Value())];
+                    if (owner < 0)
+                        owner = i;
+                    else
+                        parents[findGroup(parents, i)] = findGroup(parents, owner);
+                }
+            }
+        }
+
+        std::vector<EdgeGroup> groups;
+        std::map<int, std::size_t> groupIndex;
+        for (int i = 0; i < static_cast<int>(edges.size()); ++i) {
+            auto res = groupIndex.emplace(findGroup(parents, i), groups.size());
+            if (res.second)
+                groups.emplace_back();
+            groups[res.first->second].edges.push_back(edges[i]);
+            groups[res.first->second].names.push_back(edgeNames[i]);
+        }
+
+        if (groups.size() > 1) {
+            QtConcurrent::blockingMap(groups, [&](EdgeGroup& group) {
+                TopoDS_Shape result;
+                if (!buildEdgeOperation(make, shape, group.edges, result)) {
+                    group.failedEdges = findFailedEdges(make, shape, group.edges, group.names);
+                    return;
+                }
+
+                TopTools_IndexedMapOfShape resultFaces;
+                TopExp::MapShapes(result, TopAbs_FACE, resultFaces);
+                for (int i = 1; i <= mapOfFaces.Extent(); ++i) {
+                    if (!resultFaces.Contains(mapOfFaces.FindKey(i)))
+                        group.removedFaces.push_back(i);
+                }
+                for (TopExp_Explorer xp(result, TopAbs_FACE); xp.More(); xp.Next()) {
+                    if (!mapOfFaces.Contains(xp.Current()))
+                        group.addedFaces.push_back(xp.Current());
+                }
+            });
+
+            for (const EdgeGroup& group : groups) {
+                for (const std::string& name : group.failedEdges) {
+                    if (!failedEdges.empty())
+                        failedEdges += ", ";
+                    failedEdges += name;
+                }
+            }
+            if (!failedEdges.empty())
+                return TopoDS_Shape();
+
+            // Replace the faces each group has changed. If two groups changed the same
+            // face they were not independent after all.
+            std::vector<bool> removed(mapOfFaces.Extent() + 1, false);
+            bool independent = true;
+            for (const EdgeGroup& group : groups) {
+                for (int i : group.removedFaces) {
+                    if (removed[i])
+                        independent = false;
+                    removed[i] = true;
+                }
+            }
+
+            if (independent) {
+                try {
+                    BRep_Builder builder;
+                    TopoDS_Shell shell;
+                    builder.MakeShell(shell);
+                    for (TopExp_Explorer xp(shape, TopAbs_FACE); xp.More(); xp.Next()) {
+                        if (!removed[mapOfFaces.FindIndex(xp.Current())])
+                            builder.Add(shell, xp.Current());
+                    }
+                    for (const EdgeGroup& group : groups) {
+                        for (const TopoDS_Shape& face : group.addedFaces)
+                            builder.Add(shell, face);
+                    }
+
+                    // The faces are not sewn. The shell is only closed if the new faces share
+                    // their boundary edges with the untouched faces, i.e. if every edge of the
+                    // shell belongs to two of its faces.
+                    BRepCheck_Shell checkShell(shell);
+                    if (checkShell.Closed() == BRepCheck_NoError) {
+                        shell.Closed(Standard_True);
+                        TopoDS_Solid solid = BRepBuilderAPI_MakeSolid(shell).Solid();
+                        BRepLib::OrientClosedSolid(solid);
+                        BRepCheck_Analyzer check(solid);
+                        if (check.IsValid())
+                            return solid;
+                    }
+                }
+                catch (Standard_Failure&) {
+                }
+            }
+
+            Base::Console().Log("%s: failed to merge %d edge groups, building all edges at once\n",
+                                getFullName().c_str(), static_cast<int>(groups.size()));
+        }
+    }
+
+    TopoDS_Shape result;
+    std::unique_ptr<BRepFilletAPI_LocalOperation> mk(make(shape, edges));
+    try {
+        mk->Build();
+        if (mk->IsDone())
+            result = mk->Shape();
+    }
+    catch (Standard_Failure&) {
+        // a single edge keeps the message of the exception
+        if (edges.size() == 1)
+            throw;
+    }
+
+    if (result.IsNull() && edges.size() > 1) {
+        for (const std::string& name : findFailedEdges(make, shape, edges, edgeNames)) {
+            if (!failedEdges.empty())
+                failedEdges += ", ";
+            failedEdges += name;
+        }
+    }
+    return result;
+}
 
 void DressUp::onChanged(const App::Property* prop)
 {
@@ -24,9 +24,13 @@
 #ifndef PARTDESIGN_DressUp_H
 #define PARTDESIGN_DressUp_H
 
+#include <functional>
 #include <App/PropertyStandard.h>
 #include "FeatureAddSub.h"
 
+class BRepFilletAPI_LocalOperation;
+class TopoDS_Edge;
+
 namespace PartDesign
 {
 
@@ -63,6 +67,22 @@ public:
     virtual void getAddSubShape(Part::TopoShape &addShape, Part::TopoShape &subShape);
 
 protected:
+    /// creates a fillet or chamfer operation on the shape for the given edges of it
+    typedef std::function<BRepFilletAPI_LocalOperation*(const TopoDS_Shape&,
+                                                        const std::vector<TopoDS_Edge>&)> EdgeOperation;
+    /**
+     * Builds the operation created by \a make on the named edges of \a shape.
+     * If the preference "ParallelDressUp" is set, edges that have no face in common
+     * are split into independent groups which are built concurrently and then merged
+     * into one solid. If merging fails all edges are built at once. If building fails
+     * the edges are retried one by one to find the ones that cause the failure.
+     * @return the resulting shape or a null shape if the operation failed. In the
+     *         latter case \a failedEdges lists the edges that could be identified
+     *         as the cause, separated by commas.
+     */
+    TopoDS_Shape makeEdgeOperation(const TopoDS_Shape& shape, const std::vector<std::string>& edgeNames,
+                                   const EdgeOperation& make, std::string& failedEdges) const;
+
     virtual void onChanged(const App::Property* prop);
 };
 
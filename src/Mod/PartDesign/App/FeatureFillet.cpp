@@ -90,20 +90,19 @@ App::DocumentObjectExecReturn *Fillet::execute(void)
     Part::TopoShape baseShape(TopShape);
     baseShape.setTransform(Base::Matrix4D());
     try {
-        BRepFilletAPI_MakeFillet mkFillet(baseShape.getShape());
-
-        for (std::vector<std::string>::const_iterator it=SubNames.begin(); it != SubNames.end(); ++it) {
-            TopoDS_Edge edge = TopoDS::Edge(baseShape.getSubShape(it->c_str()));
-            mkFillet.Add(radius, edge);
-        }
-
-        mkFillet.Build();
-        if (!mkFillet.IsDone())
-            return new App::DocumentObjectExecReturn("Failed to create fillet");
-
-        TopoDS_Shape shape = mkFillet.Shape();
+        auto makeFillet = [radius](const TopoDS_Shape& base, const std::vector<TopoDS_Edge>& edges) {
+            BRepFilletAPI_MakeFillet* mkFillet = new BRepFilletAPI_MakeFillet(base);
+            for (const TopoDS_Edge& edge : edges)
+                mkFillet->Add(radius, edge);
+            return mkFillet;
+        };
+
+        std::string failedEdges;
+        TopoDS_Shape shape = makeEdgeOperation(baseShape.getShape(), SubNames, makeFillet, failedEdges);
+        if (!failedEdges.empty())
+            return new App::DocumentObjectExecReturn(("Failed to create fillet on " + failedEdges).c_str());
         if (shape.IsNull())
-            return new App::DocumentObjectExecReturn("Resulting shape is null");
+            return new App::DocumentObjectExecReturn("Failed to create fillet");
 
         TopTools_ListOfShape aLarg;
         aLarg.Append(baseShape.getShape());
@@ -154,6 +154,12 @@ App::DocumentObjectExecReturn *Groove::execute(void)
             result = refineShapeIfActive(result);
             this->AddSubShape.setValue(result);
 
+            TopoDS_Shape cached = getCachedResult(base, result);
+            if (!cached.IsNull()) {
+                this->Shape.setValue(cached);
+                return App::DocumentObject::StdReturn;
+            }
+
             // cut out groove to get one result object
             BRepAlgoAPI_Cut mkCut(base, result);
             // Let's check if the fusion has been successful
@@ -172,7 +178,7 @@ App::DocumentObjectExecReturn *Groove::execute(void)
             if (solidCount > 1) {
                 return new App::DocumentObjectExecReturn("Groove: Result has multiple solids. This is not supported at this time.");
             }
-            
+            cacheResult(base, result);
         }
         else
             return new App::DocumentObjectExecReturn("Could not revolve the sketch!");
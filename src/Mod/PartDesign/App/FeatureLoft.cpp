@@ -178,8 +178,15 @@ App::DocumentObjectExecReturn *Loft::execute(void)
 
         AddSubShape.setValue(result);
 
+        TopoDS_Shape cached = getCachedResult(base, result);
+        if (!cached.IsNull()) {
+            Shape.setValue(cached);
+            return App::DocumentObject::StdReturn;
+        }
+
         if(base.IsNull()) {
             Shape.setValue(getSolid(result));
+            cacheResult(base, result);
             return App::DocumentObject::StdReturn;
         }
 
@@ -220,6 +227,7 @@ App::DocumentObjectExecReturn *Loft::execute(void)
             Shape.setValue(getSolid(boolOp));
         }
 
+        cacheResult(base, result);
         return App::DocumentObject::StdReturn;
     }
     catch (Standard_Failure& e) {
@@ -309,6 +309,12 @@ App::DocumentObjectExecReturn *Pad::execute(void)
         prism = refineShapeIfActive(prism);
         this->AddSubShape.setValue(prism);
 
+        TopoDS_Shape cached = getCachedResult(base, prism);
+        if (!cached.IsNull()) {
+            this->Shape.setValue(cached);
+            return App::DocumentObject::StdReturn;
+        }
+
         if (!base.IsNull()) {
 //             auto obj = getDocument()->addObject("Part::Feature", "prism");
 //             static_cast<Part::Feature*>(obj)->Shape.setValue(getSolid(prism));
@@ -340,6 +346,7 @@ App::DocumentObjectExecReturn *Pad::execute(void)
            this->Shape.setValue(getSolid(prism));
         }
 
+        cacheResult(base, prism);
         return App::DocumentObject::StdReturn;
     }
     catch (Standard_Failure& e) {
@@ -302,8 +302,15 @@ App::DocumentObjectExecReturn *Pipe::execute(void)
         //result.Move(invObjLoc);
         AddSubShape.setValue(result);
 
+        TopoDS_Shape cached = getCachedResult(base, result);
+        if (!cached.IsNull()) {
+            Shape.setValue(cached);
+            return App::DocumentObject::StdReturn;
+        }
+
         if(base.IsNull()) {
             Shape.setValue(getSolid(result));
+            cacheResult(base, result);
             return App::DocumentObject::StdReturn;
         }
 
@@ -346,6 +353,7 @@ App::DocumentObjectExecReturn *Pipe::execute(void)
             Shape.setValue(getSolid(boolOp));
         }
 
+        cacheResult(base, result);
         return App::DocumentObject::StdReturn;
     }
     catch (Standard_Failure& e) {
@@ -213,6 +213,13 @@ App::DocumentObjectExecReturn *Pocket::execute(void)
             prism = refineShapeIfActive(prism);
             this->AddSubShape.setValue(prism);
 
+            TopoDS_Shape cached = getCachedResult(base, prism);
+            if (!cached.IsNull()) {
+                remapSupportShape(cached);
+                this->Shape.setValue(cached);
+                return App::DocumentObject::StdReturn;
+            }
+
             // Cut the SubShape out of the base feature
             BRepAlgoAPI_Cut mkCut(base, prism);
             if (!mkCut.IsDone())
@@ -231,6 +238,7 @@ App::DocumentObjectExecReturn *Pocket::execute(void)
             solRes = refineShapeIfActive(solRes);
             remapSupportShape(solRes);
             this->Shape.setValue(getSolid(solRes));
+            cacheResult(base, prism);
         }
 
         return App::DocumentObject::StdReturn;
@@ -75,25 +75,44 @@ App::DocumentObjectExecReturn* FeaturePrimitive::execute(const TopoDS_Shape& pri
         FeatureAddSub::execute();
 
         //if we have no base we just add the standard primitive shape
-        TopoDS_Shape base;
+        TopoDS_Shape base, baseKey;
         try{
              //if we have a base shape we need to make sure that it does not get our transformation to
-             BRepBuilderAPI_Transform trsf(getBaseShape(), getLocation().Transformation().Inverted(), true);
+             TopoDS_Shape baseShape = getBaseShape();
+             BRepBuilderAPI_Transform trsf(baseShape, getLocation().Transformation().Inverted(), true);
              base = trsf.Shape();
+             //the copy is new on every recompute, so the cached results are looked up by the
+             //original base shape moved the same way
+             baseKey = baseShape.Moved(getLocation().Inverted());
         }
         catch(const Base::Exception&) {
 
              //as we use this for preview we can add it even if useless for subtractive
              AddSubShape.setValue(primitiveShape);
 
-             if(getAddSubType() == FeatureAddSub::Additive)
-                 Shape.setValue(getSolid(primitiveShape));
+             if(getAddSubType() == FeatureAddSub::Additive) {
+                 TopoDS_Shape cached = getCachedResult(TopoDS_Shape(), primitiveShape);
+                 if (!cached.IsNull()) {
+                     Shape.setValue(cached);
+                 }
+                 else {
+                     Shape.setValue(getSolid(primitiveShape));
+                     cacheResult(TopoDS_Shape(), primitiveShape);
+                 }
+             }
              else
                  return new App::DocumentObjectExecReturn("Cannot subtract primitive feature without base feature");
 
              return  App::DocumentObject::StdReturn;
         }
 
+        TopoDS_Shape cached = getCachedResult(baseKey, primitiveShape);
+        if (!cached.IsNull()) {
+            Shape.setValue(cached);
+            AddSubShape.setValue(primitiveShape);
+            return App::DocumentObject::StdReturn;
+        }
+
         if(getAddSubType() == FeatureAddSub::Additive) {
 
             BRepAlgoAPI_Fuse mkFuse(base, primitiveShape);
@@ -135,7 +154,7 @@ App::DocumentObjectExecReturn* FeaturePrimitive::execute(const TopoDS_Shape& pri
             AddSubShape.setValue(primitiveShape);
         }
 
-
+        cacheResult(baseKey, primitiveShape);
     }
     catch (Standard_Failure& e) {
 
@@ -153,6 +153,13 @@ App::DocumentObjectExecReturn *Revolution::execute(void)
             // set the additive shape property for later usage in e.g. pattern
             this->AddSubShape.setValue(result);            
 
+            TopoDS_Shape revol = result;
+            TopoDS_Shape cached = getCachedResult(base, revol);
+            if (!cached.IsNull()) {
+                this->Shape.setValue(cached);
+                return App::DocumentObject::StdReturn;
+            }
+
             if (!base.IsNull()) {
                 // Let's call algorithm computing a fuse operation:
                 BRepAlgoAPI_Fuse mkFuse(base, result);
@@ -164,6 +171,7 @@ App::DocumentObjectExecReturn *Revolution::execute(void)
             }
 
             this->Shape.setValue(getSolid(result));
+            cacheResult(base, revol);
         }
         else
             return new App::DocumentObjectExecReturn("Could not revolve the sketch!");
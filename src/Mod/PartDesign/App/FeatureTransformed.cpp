@@ -34,8 +34,12 @@
 # include <BRepBuilderAPI_Copy.hxx>
 # include <BRepBndLib.hxx>
 # include <Bnd_Box.hxx>
+# include <Standard_Version.hxx>
+# include <TopTools_ListOfShape.hxx>
 #endif
 
+#include <QtConcurrentMap>
+
 
 #include "FeatureTransformed.h"
 #include "FeatureMultiTransform.h"
@@ -55,6 +59,63 @@
 
 using namespace PartDesign;
 
+namespace {
+
+// One transformed copy of the add/subshape of an original
+struct TransformedInstance {
+    std::vector<gp_Trsf>::const_iterator trsf;
+    TopoDS_Shape fuseShape;
+    TopoDS_Shape cutShape;
+    Bnd_Box bound;
+    bool overlapsSupport = false;
+    bool isolated = true;   // if the box overlaps no other fused instance
+    bool joins = false;     // if the instance fuses with the support or a neighbour before it
+    std::vector<TransformedInstance*> neighbours; // the fused instances before it whose box overlaps
+};
+
+// Returns a null shape if the transformation fails
+TopoDS_Shape transformCopy(const TopoDS_Shape& shape, const gp_Trsf& trsf)
+{
+    try {
+        // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
+        // seems to be pretty broken
+        BRepBuilderAPI_Copy copy(shape);
+        if (copy.Shape().IsNull())
+            return TopoDS_Shape();
+
+        BRepBuilderAPI_Transform mkTrf(copy.Shape(), trsf, false); // No need to copy, now
+        if (!mkTrf.IsDone())
+            return TopoDS_Shape();
+        return mkTrf.Shape();
+    }
+    catch (Standard_Failure&) {
+        return TopoDS_Shape();
+    }
+}
+
+// Checks whether fusing the shape to other gives no additional solid, i.e. whether
+// the shape would be accepted if it were fused to other alone
+bool fusesWith(const TopoDS_Shape& shape, const TopoDS_Shape& other)
+{
+    // the shapes are shared by the concurrent tests and must not be changed
+    TopTools_ListOfShape shapeArguments, shapeTools;
+    shapeArguments.Append(other);
+    shapeTools.Append(shape);
+    BRepAlgoAPI_Fuse mkFuse;
+#if OCC_VERSION_HEX >= 0x070100
+    mkFuse.SetNonDestructive(Standard_True);
+#endif
+    mkFuse.SetArguments(shapeArguments);
+    mkFuse.SetTools(shapeTools);
+    mkFuse.Build();
+    if (!mkFuse.IsDone())
+        return false;
+    return Part::TopoShape(other).countSubShapes(TopAbs_SOLID)
+        == Part::TopoShape(mkFuse.Shape()).countSubShapes(TopAbs_SOLID);
+}
+
+}
+
 namespace PartDesign {
 
 PROPERTY_SOURCE(PartDesign::Transformed, PartDesign::Feature)
@@ -258,7 +319,6 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
     for (std::vector<App::DocumentObject*>::const_iterator o = originals.begin(); o != originals.end(); ++o)
     {
         // Extract the original shape and determine whether to cut or to fuse
-        TopoDS_Shape shape;
         Part::TopoShape fuseShape;
         Part::TopoShape cutShape;
 
@@ -277,40 +337,153 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
             return new App::DocumentObjectExecReturn("Only additive and subtractive features can be transformed");
         }
 
-        // Transform the add/subshape and collect the resulting shapes for overlap testing
-        /*typedef std::vector<std::vector<gp_Trsf>::const_iterator> trsf_it_vec;
-        trsf_it_vec v_transformations;
-        std::vector<TopoDS_Shape> v_transformedShapes;*/
-
-        std::vector<gp_Trsf>::const_iterator t = transformations.begin();
-        ++t; // Skip first transformation, which is always the identity transformation
-        for (; t != transformations.end(); ++t) {
-            // Make an explicit copy of the shape because the "true" parameter to BRepBuilderAPI_Transform
-            // seems to be pretty broken
-            BRepBuilderAPI_Copy copy(fuseShape.isNull()?cutShape.getShape():fuseShape.getShape());
-            shape = copy.Shape();
-            if (shape.IsNull())
-                return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
-
-            BRepBuilderAPI_Transform mkTrf(shape, *t, false); // No need to copy, now
-            if (!mkTrf.IsDone())
+        // Transform the add/subshape. The copies do not depend on each other, so they are
+        // built concurrently
+        std::vector<TransformedInstance> instances(transformations.size() - 1);
+        for (std::size_t i = 0; i < instances.size(); i++)
+            instances[i].trsf = transformations.begin() + i + 1; // Skip first transformation, which is always the identity transformation
+        QtConcurrent::blockingMap(instances, [&fuseShape, &cutShape](TransformedInstance& instance) {
+            if (!fuseShape.isNull())
+                instance.fuseShape = transformCopy(fuseShape.getShape(), *instance.trsf);
+            if (!cutShape.isNull())
+                instance.cutShape = transformCopy(cutShape.getShape(), *instance.trsf);
+            const TopoDS_Shape& shape = fuseShape.isNull() ? instance.cutShape : instance.fuseShape;
+            if (!shape.IsNull())
+                BRepBndLib::Add(shape, instance.bound);
+        });
+        for (std::vector<TransformedInstance>::const_iterator it = instances.begin(); it != instances.end(); ++it) {
+            if ((!fuseShape.isNull() && it->fuseShape.IsNull()) || (!cutShape.isNull() && it->cutShape.IsNull()))
                 return new App::DocumentObjectExecReturn("Transformation failed", (*o));
+        }
 
-            shape = mkTrf.Shape();
-            try {
-                // Intersection checking for additive shape is redundant.
-                // Because according to CheckIntersection() source code, it is
-                // implemented using fusion and counting of the resulting
-                // solid, which will be done in the following modeling step
-                // anyway.
-                //
-                // There is little reason for doing intersection checking on
-                // subtractive shape either, because it does not produce
-                // multiple solids.
-                //
-                // if (!Part::checkIntersection(support, mkTrf.Shape(), false, true)) {
+        try {
+            // Intersection checking for additive shape is redundant.
+            // Because according to CheckIntersection() source code, it is
+            // implemented using fusion and counting of the resulting
+            // solid, which will be done in the following modeling step
+            // anyway.
+            //
+            // There is little reason for doing intersection checking on
+            // subtractive shape either, because it does not produce
+            // multiple solids.
+
+            std::vector<TransformedInstance*> sequence; // instances to be applied one after the other
+            if (!fuseShape.isNull() && !cutShape.isNull()) {
+                // every instance is fused and then cut, so they cannot be applied at once
+                for (std::vector<TransformedInstance>::iterator it = instances.begin(); it != instances.end(); ++it)
+                    sequence.push_back(&(*it));
+            }
+            else {
+                // An instance can only be fused to the support if its bounding box overlaps the support or
+                // an instance fused before it. Cutting an instance outside of the support changes nothing.
+                // Such instances are sorted out here without running a boolean.
+                Bnd_Box supportBound;
+                BRepBndLib::Add(support, supportBound);
+                std::vector<TransformedInstance*> reached;
+                for (std::vector<TransformedInstance>::iterator it = instances.begin(); it != instances.end(); ++it) {
+                    it->overlapsSupport = !it->bound.IsOut(supportBound);
+                    if (!fuseShape.isNull()) {
+                        for (std::vector<TransformedInstance*>::const_iterator jt = reached.begin(); jt != reached.end(); ++jt) {
+                            if (!it->bound.IsOut((*jt)->bound)) {
+                                it->neighbours.push_back(*jt);
+                                (*jt)->isolated = false;
+                            }
+                        }
+                        it->isolated = it->neighbours.empty();
+                    }
+                    if (!it->overlapsSupport && it->neighbours.empty()) {
+                        if (!fuseShape.isNull()) {
+#ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
+                            Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
+#endif
+                            nointersect_trsfms[*o].insert(it->trsf);
+                        }
+                        continue;
+                    }
+                    if (!fuseShape.isNull())
+                        reached.push_back(&(*it));
+                    sequence.push_back(&(*it));
+                }
 
+#if OCC_VERSION_HEX > 0x060800
+                // Fuse/Cut all remaining instances with the support in a single boolean operation
+                if (sequence.size() > 1) {
+                    // The one-by-one fuse rejects an instance that only touches a later instance. So the
+                    // instances can only be fused at once if each one joins the support or an instance
+                    // before it. An instance whose box overlaps no other instance can only join the
+                    // support, which the number of solids of the result shows. The others are tested
+                    // against their neighbours before and, if that fails, against the support. These
+                    // tests do not depend on each other and run concurrently.
+                    bool batch = true;
+                    if (!fuseShape.isNull()) {
+                        batch = Part::TopoShape(support).countSubShapes(TopAbs_SOLID) == 1;
+                        if (batch) {
+                            QtConcurrent::blockingMap(sequence, [&support](TransformedInstance* instance) {
+                                if (instance->isolated) {
+                                    instance->joins = true;
+                                    return;
+                                }
+                                for (std::vector<TransformedInstance*>::const_iterator jt = instance->neighbours.begin();
+                                        jt != instance->neighbours.end(); ++jt) {
+                                    if (fusesWith(instance->fuseShape, (*jt)->fuseShape)) {
+                                        instance->joins = true;
+                                        return;
+                                    }
+                                }
+                                instance->joins = instance->overlapsSupport && fusesWith(instance->fuseShape, support);
+                            });
+                            for (std::vector<TransformedInstance*>::const_iterator it = sequence.begin(); it != sequence.end(); ++it)
+                                batch = batch && (*it)->joins;
+                        }
+                    }
 
+                    TopTools_ListOfShape shapeArguments, shapeTools;
+                    shapeArguments.Append(support);
+                    for (std::vector<TransformedInstance*>::const_iterator it = sequence.begin(); it != sequence.end(); ++it)
+                        shapeTools.Append(fuseShape.isNull() ? (*it)->cutShape : (*it)->fuseShape);
+
+                    TopoDS_Shape result;
+                    if (batch && !fuseShape.isNull()) {
+                        BRepAlgoAPI_Fuse mkFuse;
+# if OCC_VERSION_HEX >= 0x060900
+                        mkFuse.SetRunParallel(true);
+# endif
+                        mkFuse.SetArguments(shapeArguments);
+                        mkFuse.SetTools(shapeTools);
+                        mkFuse.Build();
+                        if (!mkFuse.IsDone())
+                            return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
+
+                        // If an isolated instance does not intersect the support the result has more than one
+                        // solid. The instances are then applied one by one to find out which ones to reject.
+                        if (Part::TopoShape(mkFuse.Shape()).countSubShapes(TopAbs_SOLID) == 1) {
+                            result = this->getSolid(mkFuse.Shape());
+                            if (result.IsNull())
+                                return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
+                        }
+                    }
+                    else if (fuseShape.isNull()) {
+                        BRepAlgoAPI_Cut mkCut;
+# if OCC_VERSION_HEX >= 0x060900
+                        mkCut.SetRunParallel(true);
+# endif
+                        mkCut.SetArguments(shapeArguments);
+                        mkCut.SetTools(shapeTools);
+                        mkCut.Build();
+                        if (!mkCut.IsDone())
+                            return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
+                        result = mkCut.Shape();
+                    }
+
+                    if (!result.IsNull()) {
+                        support = result;
+                        sequence.clear();
+                    }
+                }
+#endif
+            }
+
+            for (std::vector<TransformedInstance*>::const_iterator it = sequence.begin(); it != sequence.end(); ++it) {
                 TopoDS_Shape current = support;
 
                 if (!fuseShape.isNull()) {
@@ -323,21 +496,7 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
                     //
                     // Therefore, if the transformation succeeded, then we fuse it with the support now, before checking the intersection
                     // of the next transformation.
-                    
-                    /*v_transformations.push_back(t);
-                    v_transformedShapes.push_back(mkTrf.Shape());*/
-    
-                    // Note: Transformations that do not intersect the support are ignored in the overlap tests
-                    
-                    //insert scheme here.
-                    /*TopoDS_Compound compoundTool;
-                    std::vector<TopoDS_Shape> individualTools;
-                    divideTools(v_transformedShapes, individualTools, compoundTool);*/
-                    
-                    // Fuse/Cut the compounded transformed shapes with the support
-                    //TopoDS_Shape result;
-
-                    BRepAlgoAPI_Fuse mkFuse(current, shape);
+                    BRepAlgoAPI_Fuse mkFuse(current, (*it)->fuseShape);
                     if (!mkFuse.IsDone())
                         return new App::DocumentObjectExecReturn("Fusion with support failed", *o);
 
@@ -347,7 +506,7 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
 #ifdef FC_DEBUG // do not write this in release mode because a message appears already in the task view
                         Base::Console().Warning("Transformed shape does not intersect support %s: Removed\n", (*o)->getNameInDocument());
 #endif
-                        nointersect_trsfms[*o].insert(t);
+                        nointersect_trsfms[*o].insert((*it)->trsf);
                         continue;
                     }
                     // we have to get the solids (fuse sometimes creates compounds)
@@ -355,35 +514,23 @@ App::DocumentObjectExecReturn *Transformed::execute(void)
                     // lets check if the result is a solid
                     if (current.IsNull())
                         return new App::DocumentObjectExecReturn("Resulting shape is not a solid", *o);
-
-                    if (!cutShape.isNull()) {
-                        BRepBuilderAPI_Copy copy(cutShape.getShape());
-                        shape = copy.Shape();
-                        if (shape.IsNull())
-                            return new App::DocumentObjectExecReturn("Transformed: Linked shape object is empty");
-            
-                        BRepBuilderAPI_Transform mkTrf(shape, *t, false); // No need to copy, now
-                        if (!mkTrf.IsDone())
-                            return new App::DocumentObjectExecReturn("Transformation failed", (*o));
-                        shape = mkTrf.Shape();
-                    }
                 }
                 if (!cutShape.isNull()) {
-                    BRepAlgoAPI_Cut mkCut(current, shape);
+                    BRepAlgoAPI_Cut mkCut(current, (*it)->cutShape);
                     if (!mkCut.IsDone())
                         return new App::DocumentObjectExecReturn("Cut out of support failed", *o);
                     current = mkCut.Shape();
                 }
                 support = current; // Use result of this operation for fuse/cut of next original
-            } catch (Standard_Failure& e) {
-                // Note: Ignoring this failure is probably pointless because if the intersection check fails, the later
-                // fuse operation of the transformation result will also fail
-        
-                std::string msg("Transformation: Intersection check failed");
-                if (e.GetMessageString() != NULL)
-                    msg += std::string(": '") + e.GetMessageString() + "'";
-                return new App::DocumentObjectExecReturn(msg.c_str());
             }
+        } catch (Standard_Failure& e) {
+            // Note: Ignoring this failure is probably pointless because if the intersection check fails, the later
+            // fuse operation of the transformation result will also fail
+
+            std::string msg("Transformation: Intersection check failed");
+            if (e.GetMessageString() != NULL)
+                msg += std::string(": '") + e.GetMessageString() + "'";
+            return new App::DocumentObjectExecReturn(msg.c_str());
         }
     }
     support = refineShapeIfActive(support);
@@ -75,6 +75,9 @@ public:
       * Gets the transformations from the virtual getTransformations() method of the sub class
       * and applies them to every member of Originals. The total number of copies including
       * the untransformed Originals will be sizeof(Originals) times sizeof(getTransformations())
+      * The copies of an Original are built concurrently. Copies whose bounding box cannot touch the
+      * support are rejected right away, the others are fused/cut with a single boolean operation
+      * if possible
       * If Originals is empty, execute() returns immediately without doing anything as
       * the actual processing will happen in the MultiTransform feature
       */
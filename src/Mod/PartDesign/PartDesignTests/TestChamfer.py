@@ -42,6 +42,48 @@ class TestChamfer(unittest.TestCase):
         self.MajorFaces = [face for face in self.Chamfer.Shape.Faces if face.Area > 1e-3]
         self.assertEqual(len(self.MajorFaces), 8)
 
+    def testChamferIndependentEdges(self):
+        """
+        Chamfers the top edges of two separate towers on a box, once with all edges
+        built at once and once with the edge groups built in parallel.
+        """
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Box.Length=30.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Body.addObject(self.Box)
+        self.Tower1 = self.Doc.addObject('PartDesign::AdditiveBox','Tower1')
+        self.Tower1.Placement.Base = FreeCAD.Vector(2,2,10)
+        self.Tower2 = self.Doc.addObject('PartDesign::AdditiveBox','Tower2')
+        self.Tower2.Placement.Base = FreeCAD.Vector(20,2,10)
+        for tower in (self.Tower1, self.Tower2):
+            tower.Length=5.00
+            tower.Width=5.00
+            tower.Height=5.00
+            self.Body.addObject(tower)
+        self.Doc.recompute()
+        # one edge along X on top of each tower
+        edges = ['Edge'+str(i+1) for i, e in enumerate(self.Tower2.Shape.Edges)
+                 if e.BoundBox.ZMin > 14.999 and e.BoundBox.ZLength < 1e-7
+                 and e.BoundBox.YMax < 2.001]
+        self.assertEqual(len(edges), 2)
+        self.Chamfer = self.Doc.addObject("PartDesign::Chamfer","Chamfer")
+        self.Chamfer.Base = (self.Tower2, edges)
+        self.Chamfer.Size = 1
+        self.Body.addObject(self.Chamfer)
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/PartDesign")
+        parallel = param.GetBool("ParallelDressUp", False)
+        try:
+            for mode in (False, True):
+                param.SetBool("ParallelDressUp", mode)
+                self.Chamfer.touch()
+                self.Doc.recompute()
+                self.assertTrue(self.Chamfer.Shape.isValid())
+                self.assertAlmostEqual(self.Chamfer.Shape.Volume, 3250 - 2 * 5 * 0.5)
+        finally:
+            param.SetBool("ParallelDressUp", parallel)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestChamfer")
@@ -43,6 +43,50 @@ class TestFillet(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.Fillet.Shape.Volume, 4/3 * pi * 5**3, places=3)
 
+    def testFilletIndependentEdges(self):
+        """
+        Fillets the top edges of two separate towers on a box, once with all edges
+        built at once and once with the edge groups built in parallel.
+        """
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Box.Length=30.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Body.addObject(self.Box)
+        self.Tower1 = self.Doc.addObject('PartDesign::AdditiveBox','Tower1')
+        self.Tower1.Placement.Base = FreeCAD.Vector(2,2,10)
+        self.Tower2 = self.Doc.addObject('PartDesign::AdditiveBox','Tower2')
+        self.Tower2.Placement.Base = FreeCAD.Vector(20,2,10)
+        for tower in (self.Tower1, self.Tower2):
+            tower.Length=5.00
+            tower.Width=5.00
+            tower.Height=5.00
+            self.Body.addObject(tower)
+        self.Doc.recompute()
+        edges = ['Edge'+str(i+1) for i, e in enumerate(self.Tower2.Shape.Edges)
+                 if e.BoundBox.ZMin > 14.999 and e.BoundBox.ZLength < 1e-7]
+        self.assertEqual(len(edges), 8)
+        self.Fillet = self.Doc.addObject("PartDesign::Fillet","Fillet")
+        self.Fillet.Base = (self.Tower2, edges)
+        self.Fillet.Radius = 1
+        self.Body.addObject(self.Fillet)
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/PartDesign")
+        parallel = param.GetBool("ParallelDressUp", False)
+        try:
+            volumes = []
+            for mode in (False, True):
+                param.SetBool("ParallelDressUp", mode)
+                self.Fillet.touch()
+                self.Doc.recompute()
+                self.assertTrue(self.Fillet.Shape.isValid())
+                self.assertEqual(len(self.Fillet.Shape.Solids), 1)
+                volumes.append(self.Fillet.Shape.Volume)
+        finally:
+            param.SetBool("ParallelDressUp", parallel)
+        self.assertAlmostEqual(volumes[0], volumes[1], places=6)
+        self.assertLess(volumes[0], 3250)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestFillet")
@@ -138,6 +138,69 @@ class TestLinearPattern(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 1e4)
 
+    def testManyOccurrencesLinearPattern(self):
+        # every box only touches its neighbours, not the original one
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=10.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Box]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 1990.0
+        self.LinearPattern.Occurrences = 200
+        self.Body.addObject(self.LinearPattern)
+        self.Doc.recompute()
+        self.assertNotIn('Invalid', self.LinearPattern.State)
+        self.assertEqual(len(self.LinearPattern.Shape.Solids), 1)
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 2e6)
+
+    def testSubtractiveLinearPattern(self):
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=1000.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.Pocket = self.Doc.addObject('PartDesign::SubtractiveBox','Pocket')
+        self.Body.addObject(self.Pocket)
+        self.Pocket.Length=5.00
+        self.Pocket.Width=5.00
+        self.Pocket.Height=5.00
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Pocket]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 1485.0
+        self.LinearPattern.Occurrences = 100
+        self.Body.addObject(self.LinearPattern)
+        self.Doc.recompute()
+        # the last third of the pockets is outside of the box
+        self.assertNotIn('Invalid', self.LinearPattern.State)
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 1e5 - 67*125)
+
+    def testDisjointLinearPattern(self):
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.Box = self.Doc.addObject('PartDesign::AdditiveBox','Box')
+        self.Body.addObject(self.Box)
+        self.Box.Length=10.00
+        self.Box.Width=10.00
+        self.Box.Height=10.00
+        self.Doc.recompute()
+        self.LinearPattern = self.Doc.addObject("PartDesign::LinearPattern","LinearPattern")
+        self.LinearPattern.Originals = [self.Box]
+        self.LinearPattern.Direction = (self.Doc.X_Axis,[""])
+        self.LinearPattern.Length = 200.0
+        self.LinearPattern.Occurrences = 3
+        self.Body.addObject(self.LinearPattern)
+        self.Doc.recompute()
+        self.assertIn('Invalid', self.LinearPattern.State)
+        self.assertAlmostEqual(self.LinearPattern.Shape.Volume, 1e3)
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestLinearPattern")
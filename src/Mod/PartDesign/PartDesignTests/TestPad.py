@@ -165,6 +165,47 @@ class TestPad(unittest.TestCase):
         self.Doc.recompute()
         self.assertAlmostEqual(self.Pad1.Shape.Volume, 4.0)
 
+    def testPadChangedBackCase(self):
+        param = FreeCAD.ParamGet("User parameter:BaseApp/Preferences/Mod/PartDesign")
+        cacheSize = param.GetInt("ResultCacheSize", 0)
+        param.SetInt("ResultCacheSize", 16)
+        try:
+            self.padChangedBack()
+        finally:
+            param.SetInt("ResultCacheSize", cacheSize)
+
+    def padChangedBack(self):
+        self.Body = self.Doc.addObject('PartDesign::Body','Body')
+        self.PadSketch = self.Doc.addObject('Sketcher::SketchObject', 'SketchPad')
+        self.Body.addObject(self.PadSketch)
+        TestSketcherApp.CreateRectangleSketch(self.PadSketch, (0, 0), (2, 2))
+        self.Doc.recompute()
+        self.Pad = self.Doc.addObject("PartDesign::Pad", "Pad")
+        self.Body.addObject(self.Pad)
+        self.Pad.Profile = self.PadSketch
+        self.Pad.Length = 1
+        self.Doc.recompute()
+        self.PadSketch1 = self.Doc.addObject('Sketcher::SketchObject', 'SketchPad1')
+        self.Body.addObject(self.PadSketch1)
+        TestSketcherApp.CreateRectangleSketch(self.PadSketch1, (0, 0), (1, 1))
+        self.Doc.recompute()
+        self.Pad1 = self.Doc.addObject("PartDesign::Pad", "Pad1")
+        self.Body.addObject(self.Pad1)
+        self.Pad1.Profile = self.PadSketch1
+        self.Pad1.Length = 3
+        self.Doc.recompute()
+        self.assertAlmostEqual(self.Pad1.Shape.Volume, 6.0)
+        shape = self.Pad1.Shape
+        # changing the first pad and changing it back reuses the earlier results
+        self.Pad.Length = 2
+        self.Doc.recompute()
+        self.assertAlmostEqual(self.Pad1.Shape.Volume, 9.0)
+        self.Pad.Length = 1
+        self.Doc.recompute()
+        self.assertAlmostEqual(self.Pad1.Shape.Volume, 6.0)
+        # the result keeps its TShape but gets a new location from the placement
+        self.assertTrue(self.Pad1.Shape.isPartner(shape))
+
     def tearDown(self):
         #closing doc
         FreeCAD.closeDocument("PartDesignTestPad")
@@ -0,0 +1,350 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "PreCompiled.h"
+
+#ifndef _PreComp_
+# include <algorithm>
+# include <climits>
+# include <cmath>
+#endif
+
+#include <QtConcurrentMap>
+
+#include "PointsKDTree.h"
+#include "Points.h"
+
+using namespace Points;
+
+namespace {
+// Maximum number of points in a leaf node
+const unsigned long LeafSize = 16;
+
+typedef std::pair<Base::Vector3f, unsigned long> IndexedPoint;
+
+struct AxisLess
+{
+    AxisLess(int axis) : axis(axis) {}
+    bool operator() (const IndexedPoint& a, const IndexedPoint& b) const
+    { return a.first[axis] < b.first[axis]; }
+    int axis;
+};
+}
+
+PointsKDTree::PointsKDTree()
+  : _ctOriginal(0)
+{
+}
+
+PointsKDTree::PointsKDTree(const std::vector<Base::Vector3f>& points)
+  : _ctOriginal(0)
+{
+    Build(points);
+}
+
+PointsKDTree::PointsKDTree(const PointKernel& points)
+  : _ctOriginal(0)
+{
+    Build(points);
+}
+
+PointsKDTree::~PointsKDTree()
+{
+}
+
+void PointsKDTree::Build(const PointKernel& points)
+{
+    Build(points.getBasicPoints());
+}
+
+void PointsKDTree::Build(const std::vector<Base::Vector3f>& points)
+{
+    Clear();
+    _ctOriginal = points.size();
+
+    std::vector<IndexedPoint> pts;
+    pts.reserve(points.size());
+    for (std::size_t i = 0; i < points.size(); i++) {
+        const Base::Vector3f& p = points[i];
+        if (!std::isnan(p.x) && !std::isnan(p.y) && !std::isnan(p.z))
+            pts.push_back(std::make_pair(p, static_cast<unsigned long>(i)));
+    }
+
+    if (pts.empty())
+        return;
+
+    // Build the nodes with an explicit stack to avoid deep recursions. The
+    // children of a node are always created after the node itself so that
+    // the root stays the first node.
+    _nodes.reserve(2 * (pts.size() / LeafSize + 1));
+    Node root;
+    root.begin = 0;
+    root.end = pts.size();
+    root.axis = -1;
+    root.left = root.right = -1;
+    root.split = 0.0f;
+    _nodes.push_back(root);
+
+    std::vector<int> stack;
+    stack.push_back(0);
+    while (!stack.empty()) {
+        int index = stack.back();
+        stack.pop_back();
+
+        unsigned long begin = _nodes[index].begin;
+        unsigned long end = _nodes[index].end;
+        if (end - begin <= LeafSize)
+            continue;
+
+        // split along the axis of largest extent
+        Base::Vector3f minPt = pts[begin].first;
+        Base::Vector3f maxPt = pts[begin].first;
+        for (unsigned long i = begin + 1; i < end; i++) {
+            const Base::Vector3f& p = pts[i].first;
+            minPt.x = std::min(minPt.x, p.x); maxPt.x = std::max(maxPt.x, p.x);
+            minPt.y = std::min(minPt.y, p.y); maxPt.y = std::max(maxPt.y, p.y);
+            minPt.z = std::min(minPt.z, p.z); maxPt.z = std::max(maxPt.z, p.z);
+        }
+
+        Base::Vector3f ext = maxPt - minPt;
+        int axis = 0;
+        if (ext.y > ext[axis])
+            axis = 1;
+        if (ext.z > ext[axis])
+            axis = 2;
+
+        // all points are coincident
+        if (ext[axis] <= 0.0f)
+            continue;
+
+        unsigned long mid = begin + (end - begin) / 2;
+        std::nth_element(pts.begin() + begin, pts.begin() + mid, pts.begin() + end, AxisLess(axis));
+
+        Node left, right;
+        left.begin = begin;
+        left.end = mid;
+        right.begin = mid;
+        right.end = end;
+        left.axis = right.axis = -1;
+        left.left = left.right = right.left = right.right = -1;
+        left.split = right.split = 0.0f;
+
+        int leftIndex = static_cast<int>(_nodes.size());
+        _nodes.push_back(left);
+        _nodes.push_back(right);
+
+        Node& node = _nodes[index];
+        node.axis = axis;
+        node.split = pts[mid].first[axis];
+        node.left = leftIndex;
+        node.right = leftIndex + 1;
+
+        stack.push_back(leftIndex);
+        stack.push_back(leftIndex + 1);
+    }
+
+    _points.reserve(pts.size());
+    _indices.reserve(pts.size());
+    for (std::vector<IndexedPoint>::iterator it = pts.begin(); it != pts.end(); ++it) {
+        _points.push_back(it->first);
+        _indices.push_back(it->second);
+    }
+}
+
+void PointsKDTree::Clear()
+{
+    _points.clear();
+    _indices.clear();
+    _nodes.clear();
+    _ctOriginal = 0;
+}
+
+bool PointsKDTree::IsEmpty() const
+{
+    return _points.empty();
+}
+
+std::size_t PointsKDTree::Size() const
+{
+    return _points.size();
+}
+
+void PointsKDTree::SearchKNearest(int index, const Base::Vector3f& p, std::size_t k,
+                                  std::vector<Neighbour>& heap) const
+{
+    const Node& node = _nodes[index];
+    if (node.axis < 0) {
+        for (unsigned long i = node.begin; i < node.end; i++) {
+            Neighbour n;
+            n.sqrDist = Base::DistanceP2(p, _points[i]);
+            n.pos = i;
+            if (heap.size() < k) {
+                heap.push_back(n);
+                std::push_heap(heap.begin(), heap.end());
+            }
+            else if (n.sqrDist < heap.front().sqrDist) {
+                std::pop_heap(heap.begin(), heap.end());
+                heap.back() = n;
+                std::push_heap(heap.begin(), heap.end());
+            }
+        }
+        return;
+    }
+
+    float diff = p[node.axis] - node.split;
+    int nearChild = diff < 0.0f ? node.left : node.right;
+    int farChild = diff < 0.0f ? node.right : node.left;
+
+    SearchKNearest(nearChild, p, k, heap);
+    if (heap.size() < k || diff * diff <= heap.front().sqrDist)
+        SearchKNearest(farChild, p, k, heap);
+}
+
+void PointsKDTree::SearchRadius(int index, const Base::Vector3f& p, float sqrRadius,
+                                std::vector<Neighbour>& result) const
+{
+    const Node& node = _nodes[index];
+    if (node.axis < 0) {
+        for (unsigned long i = node.begin; i < node.end; i++) {
+            float dist = Base::DistanceP2(p, _points[i]);
+            if (dist <= sqrRadius) {
+                Neighbour n;
+                n.sqrDist = dist;
+                n.pos = i;
+                result.push_back(n);
+            }
+        }
+        return;
+    }
+
+    float diff = p[node.axis] - node.split;
+    int nearChild = diff < 0.0f ? node.left : node.right;
+    int farChild = diff < 0.0f ? node.right : node.left;
+
+    SearchRadius(nearChild, p, sqrRadius, result);
+    if (diff * diff <= sqrRadius)
+        SearchRadius(farChild, p, sqrRadius, result);
+}
+
+std::size_t PointsKDTree::CopyResult(std::vector<Neighbour>& result, std::vector<unsigned long>& indices,
+                                     std::vector<float>* sqrDist) const
+{
+    std::sort(result.begin(), result.end());
+
+    indices.resize(result.size());
+    if (sqrDist)
+        sqrDist->resize(result.size());
+    for (std::size_t i = 0; i < result.size(); i++) {
+        indices[i] = _indices[result[i].pos];
+        if (sqrDist)
+            (*sqrDist)[i] = result[i].sqrDist;
+    }
+
+    return result.size();
+}
+
+std::size_t PointsKDTree::FindKNearest(const Base::Vector3f& p, int k, std::vector<unsigned long>& indices,
+                                       std::vector<float>* sqrDist) const
+{
+    std::vector<Neighbour> heap;
+    if (!_nodes.empty() && k > 0) {
+        heap.reserve(k);
+        SearchKNearest(0, p, static_cast<std::size_t>(k), heap);
+    }
+
+    return CopyResult(heap, indices, sqrDist);
+}
+
+std::size_t PointsKDTree::FindInRadius(const Base::Vector3f& p, float radius, std::vector<unsigned long>& indices,
+                                       std::vector<float>* sqrDist) const
+{
+    std::vector<Neighbour> result;
+    if (!_nodes.empty() && radius >= 0.0f)
+        SearchRadius(0, p, radius * radius, result);
+
+    return CopyResult(result, indices, sqrDist);
+}
+
+unsigned long PointsKDTree::FindNearest(const Base::Vector3f& p, float& sqrDist) const
+{
+    std::vector<unsigned long> indices;
+    std::vector<float> dist;
+    if (FindKNearest(p, 1, indices, &dist) == 0)
+        return ULONG_MAX;
+
+    sqrDist = dist.front();
+    return indices.front();
+}
+
+void PointsKDTree::FindKNearest(const std::vector<Base::Vector3f>& points, int k,
+                                std::vector<std::vector<unsigned long> >& indices) const
+{
+    indices.clear();
+    indices.resize(points.size());
+    if (points.empty())
+        return;
+
+    // the position of an element in the result list is the index of the query point
+    std::vector<unsigned long>* first = &indices.front();
+    QtConcurrent::blockingMap(indices, [this, first, &points, k](std::vector<unsigned long>& result) {
+        std::size_t index = &result - first;
+        FindKNearest(points[index], k, result);
+    });
+}
+
+void PointsKDTree::FindInRadius(const std::vector<Base::Vector3f>& points, float radius,
+                                std::vector<std::vector<unsigned long> >& indices) const
+{
+    indices.clear();
+    indices.resize(points.size());
+    if (points.empty())
+        return;
+
+    std::vector<unsigned long>* first = &indices.front();
+    QtConcurrent::blockingMap(indices, [this, first, &points, radius](std::vector<unsigned long>& result) {
+        std::size_t index = &result - first;
+        FindInRadius(points[index], radius, result);
+    });
+}
+
+void PointsKDTree::FindNeighbours(int k, float radius, std::vector<std::vector<unsigned long> >& indices) const
+{
+    indices.clear();
+    indices.resize(_ctOriginal);
+    if (_points.empty())
+        return;
+
+    // Iterate over the points in tree order so that spatially close queries end up
+    // in the same work chunk. The original index is used to store the result.
+    std::vector<unsigned long> order(_points.size());
+    for (std::size_t i = 0; i < order.size(); i++)
+        order[i] = static_cast<unsigned long>(i);
+
+    QtConcurrent::blockingMap(order, [this, &indices, k, radius](unsigned long& pos) {
+        std::vector<unsigned long>& result = indices[_indices[pos]];
+        if (k > 0)
+            FindKNearest(_points[pos], k, result);
+        else
+            FindInRadius(_points[pos], radius, result);
+    });
+}
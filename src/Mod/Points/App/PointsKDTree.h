@@ -0,0 +1,132 @@
+/***************************************************************************
+ *   Copyright (c) 2020 FreeCAD Developers                                 *
+ *                                                                         *
+ *   This file is part of the FreeCAD CAx development system.              *
+ *                                                                         *
+ *   This library is free software; you can redistribute it and/or         *
+ *   modify it under the terms of the GNU Library General Public           *
+ *   License as published by the Free Software Foundation; either          *
+ *   version 2 of the License, or (at your option) any later version.      *
+ *                                                                         *
+ *   This library  is distributed in the hope that it will be useful,      *
+ *   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+ *   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+ *   GNU Library General Public License for more details.                  *
+ *                                                                         *
+ *   You should have received a copy of the GNU Library General Public     *
+ *   License along with this library; see the file COPYING.LIB. If not,    *
+ *   write to the Free Software Foundation, Inc., 59 Temple Place,         *
+ *   Suite 330, Boston, MA  02111-1307, USA                                *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#ifndef POINTS_KDTREE_H
+#define POINTS_KDTREE_H
+
+#include <vector>
+#include <Base/Vector3D.h>
+
+namespace Points {
+class PointKernel;
+
+/**
+ * The PointsKDTree class is a static, balanced k-d tree over the points of a point
+ * cloud. It supports k-nearest-neighbour and radius queries.
+ *
+ * Once built the tree is never modified, so all query methods are const and can be
+ * called concurrently from several threads. The batched query methods make use of
+ * this and distribute the queries over the global thread pool.
+ *
+ * Points with NaN coordinates are not inserted, the returned indices always refer to
+ * the position in the original point array.
+ */
+class PointsExport PointsKDTree
+{
+public:
+    /// Construction
+    PointsKDTree();
+    /// Construction
+    PointsKDTree(const std::vector<Base::Vector3f>& points);
+    /// Construction
+    PointsKDTree(const PointKernel& points);
+    /// Destruction
+    ~PointsKDTree();
+
+    /** Rebuilds the tree from the given points. */
+    void Build(const std::vector<Base::Vector3f>& points);
+    /** Rebuilds the tree from the untransformed points of the kernel. */
+    void Build(const PointKernel& points);
+    void Clear();
+    bool IsEmpty() const;
+    /** Returns the number of points stored in the tree. */
+    std::size_t Size() const;
+
+    /** @name Single queries */
+    //@{
+    /** Searches for the \a k nearest neighbours of \a p. The indices are sorted by
+     * increasing distance, \a sqrDist gets the squared distances if not null.
+     * Returns the number of found points which is less than \a k only if the tree
+     * has less than \a k points.
+     */
+    std::size_t FindKNearest(const Base::Vector3f& p, int k, std::vector<unsigned long>& indices,
+                             std::vector<float>* sqrDist = nullptr) const;
+    /** Searches for all points with a distance to \a p less or equal to \a radius.
+     * The indices are sorted by increasing distance.
+     */
+    std::size_t FindInRadius(const Base::Vector3f& p, float radius, std::vector<unsigned long>& indices,
+                             std::vector<float>* sqrDist = nullptr) const;
+    /** Returns the index of the nearest point or ULONG_MAX if the tree is empty. */
+    unsigned long FindNearest(const Base::Vector3f& p, float& sqrDist) const;
+    //@}
+
+    /** @name Batched queries */
+    //@{
+    /** Runs FindKNearest() for all \a points concurrently. */
+    void FindKNearest(const std::vector<Base::Vector3f>& points, int k,
+                      std::vector<std::vector<unsigned long> >& indices) const;
+    /** Runs FindInRadius() for all \a points concurrently. */
+    void FindInRadius(const std::vector<Base::Vector3f>& points, float radius,
+                      std::vector<std::vector<unsigned long> >& indices) const;
+    /** Searches the neighbours of all points of the tree itself. If \a k is positive the
+     * k nearest neighbours are searched, otherwise all points within \a radius. A point
+     * is part of its own neighbourhood. Points that were skipped because of NaN
+     * coordinates get an empty list.
+     */
+    void FindNeighbours(int k, float radius, std::vector<std::vector<unsigned long> >& indices) const;
+    //@}
+
+private:
+    struct Node
+    {
+        float split;         /**< Split value of an inner node. */
+        int axis;            /**< Split axis of an inner node or -1 for a leaf. */
+        int left, right;     /**< Child nodes of an inner node. */
+        unsigned long begin; /**< First point of the node in tree order. */
+        unsigned long end;   /**< Past-the-end point of the node in tree order. */
+    };
+    struct Neighbour
+    {
+        float sqrDist;
+        unsigned long pos;
+        bool operator < (const Neighbour& n) const
+        { return sqrDist < n.sqrDist; }
+    };
+    void SearchKNearest(int node, const Base::Vector3f& p, std::size_t k, std::vector<Neighbour>& heap) const;
+    void SearchRadius(int node, const Base::Vector3f& p, float sqrRadius, std::vector<Neighbour>& result) const;
+    std::size_t CopyResult(std::vector<Neighbour>& result, std::vector<unsigned long>& indices,
+                           std::vector<float>* sqrDist) const;
+
+private:
+    std::vector<Base::Vector3f> _points; /**< Copy of the points in tree order. */
+    std::vector<unsigned long> _indices; /**< Original index of the points in tree order. */
+    std::vector<Node> _nodes;            /**< Flat node array, the root is the first node. */
+    std::size_t _ctOriginal;             /**< Number of points passed to Build(). */
+
+    PointsKDTree(const PointsKDTree&);
+    void operator= (const PointsKDTree&);
+};
+
+} // namespace Points
+
+#endif // POINTS_KDTREE_H
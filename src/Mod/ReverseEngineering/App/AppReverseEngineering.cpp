@@ -85,6 +85,24 @@ public:
             "Weight=0.1,Grad=1.0,Bend=0.0,\n"
             "Iterations=5,Correction=True,PatchFactor=1.0)"
         );
+        add_keyword_method("normalEstimation",&Module::normalEstimation,
+            "normalEstimation(Points,[KSearch=0, SearchRadius=0]) -> Normals\n"
+            "KSearch is an int and used to search the k-nearest neighbours in\n"
+            "the k-d tree. Alternatively, SearchRadius (a float) can be used\n"
+            "as spatial distance to determine the neighbours of a point\n"
+            "Example:\n"
+            "\n"
+            "import ReverseEngineering as Reen\n"
+            "pts=App.ActiveDocument.ActiveObject.Points\n"
+            "nor=Reen.normalEstimation(pts,KSearch=5)\n"
+            "\n"
+            "f=App.ActiveDocument.addObject('Points::FeaturePython','Normals')\n"
+            "f.addProperty('Points::PropertyNormalList','Normal')\n"
+            "f.Points=pts\n"
+            "f.Normal=nor\n"
+            "f.ViewObject.Proxy=0\n"
+            "f.ViewObject.DisplayMode=1\n"
+        );
 #if defined(HAVE_PCL_SURFACE)
         add_keyword_method("triangulate",&Module::triangulate,
             "triangulate(PointKernel,searchRadius[,mu=2.5])."
@@ -114,29 +132,11 @@ public:
         add_keyword_method("filterVoxelGrid",&Module::filterVoxelGrid,
             "filterVoxelGrid(dim)."
         );
-        add_keyword_method("normalEstimation",&Module::normalEstimation,
-            "normalEstimation(Points,[KSearch=0, SearchRadius=0]) -> Normals\n"
-            "KSearch is an int and used to search the k-nearest neighbours in\n"
-            "the k-d tree. Alternatively, SearchRadius (a float) can be used\n"
-            "as spatial distance to determine the neighbours of a point\n"
-            "Example:\n"
-            "\n"
-            "import ReverseEngineering as Reen\n"
-            "pts=App.ActiveDocument.ActiveObject.Points\n"
-            "nor=Reen.normalEstimation(pts,KSearch=5)\n"
-            "\n"
-            "f=App.ActiveDocument.addObject('Points::FeaturePython','Normals')\n"
-            "f.addProperty('Points::PropertyNormalList','Normal')\n"
-            "f.Points=pts\n"
-            "f.Normal=nor\n"
-            "f.ViewObject.Proxy=0\n"
-            "f.ViewObject.DisplayMode=1\n"
-        );
 #endif
-#if defined(HAVE_PCL_SEGMENTATION)
         add_keyword_method("regionGrowingSegmentation",&Module::regionGrowingSegmentation,
-            "regionGrowingSegmentation()."
+            "regionGrowingSegmentation(Points,[KSearch=5, Normals]) -> list of index tuples."
         );
+#if defined(HAVE_PCL_SEGMENTATION)
         add_keyword_method("featureSegmentation",&Module::featureSegmentation,
             "featureSegmentation()."
         );
@@ -278,6 +278,84 @@ private:
             throw Py::RuntimeError("Unknown C++ exception");
         }
     }
+    Py::Object normalEstimation(const Py::Tuple& args, const Py::Dict& kwds)
+    {
+        PyObject *pts;
+        int ksearch=0;
+        double searchRadius=0;
+
+        static char* kwds_normals[] = {"Points", "KSearch", "SearchRadius", NULL};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|id", kwds_normals,
+                                        &(Points::PointsPy::Type), &pts,
+                                        &ksearch, &searchRadius))
+            throw Py::Exception();
+
+        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
+
+        std::vector<Base::Vector3d> normals;
+        try {
+            NormalEstimation estimate(*points);
+            estimate.setKSearch(ksearch);
+            estimate.setSearchRadius(searchRadius);
+            estimate.perform(normals);
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        Py::List list;
+        for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
+            list.append(Py::Vector(*it));
+        }
+
+        return list;
+    }
+    Py::Object regionGrowingSegmentation(const Py::Tuple& args, const Py::Dict& kwds)
+    {
+        PyObject *pts;
+        PyObject *vec = 0;
+        int ksearch=5;
+
+        static char* kwds_segment[] = {"Points", "KSearch", "Normals", NULL};
+        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|iO", kwds_segment,
+                                        &(Points::PointsPy::Type), &pts,
+                                        &ksearch, &vec))
+            throw Py::Exception();
+
+        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
+
+        std::list<std::vector<int> > clusters;
+        try {
+            RegionGrowing segm(*points, clusters);
+            if (vec) {
+                Py::Sequence list(vec);
+                std::vector<Base::Vector3f> normals;
+                normals.reserve(list.size());
+                for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
+                    Base::Vector3d v = Py::Vector(*it).toVector();
+                    normals.push_back(Base::convertTo<Base::Vector3f>(v));
+                }
+                segm.perform(normals);
+            }
+            else {
+                segm.perform(ksearch);
+            }
+        }
+        catch (const Base::Exception& e) {
+            throw Py::RuntimeError(e.what());
+        }
+
+        Py::List lists;
+        for (std::list<std::vector<int> >::iterator it = clusters.begin(); it != clusters.end(); ++it) {
+            Py::Tuple tuple(it->size());
+            for (std::size_t i = 0; i < it->size(); i++) {
+                tuple.setItem(i, Py::Long((*it)[i]));
+            }
+            lists.append(tuple);
+        }
+
+        return lists;
+    }
 #if defined(HAVE_PCL_SURFACE)
     /*
 import ReverseEngineering as Reen
@@ -630,77 +708,7 @@ Mesh.show(m)
         return Py::asObject(new Points::PointsPy(points_sample));
     }
 #endif
-#if defined(HAVE_PCL_FILTERS)
-    Py::Object normalEstimation(const Py::Tuple& args, const Py::Dict& kwds)
-    {
-        PyObject *pts;
-        int ksearch=0;
-        double searchRadius=0;
-
-        static char* kwds_normals[] = {"Points", "KSearch", "SearchRadius", NULL};
-        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|id", kwds_normals,
-                                        &(Points::PointsPy::Type), &pts,
-                                        &ksearch, &searchRadius))
-            throw Py::Exception();
-
-        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
-
-        std::vector<Base::Vector3d> normals;
-        NormalEstimation estimate(*points);
-        estimate.setKSearch(ksearch);
-        estimate.setSearchRadius(searchRadius);
-        estimate.perform(normals);
-
-        Py::List list;
-        for (std::vector<Base::Vector3d>::iterator it = normals.begin(); it != normals.end(); ++it) {
-            list.append(Py::Vector(*it));
-        }
-
-        return list;
-    }
-#endif
 #if defined(HAVE_PCL_SEGMENTATION)
-    Py::Object regionGrowingSegmentation(const Py::Tuple& args, const Py::Dict& kwds)
-    {
-        PyObject *pts;
-        PyObject *vec = 0;
-        int ksearch=5;
-
-        static char* kwds_segment[] = {"Points", "KSearch", "Normals", NULL};
-        if (!PyArg_ParseTupleAndKeywords(args.ptr(), kwds.ptr(), "O!|iO", kwds_segment,
-                                        &(Points::PointsPy::Type), &pts,
-                                        &ksearch, &vec))
-            throw Py::Exception();
-
-        Points::PointKernel* points = static_cast<Points::PointsPy*>(pts)->getPointKernelPtr();
-
-        std::list<std::vector<int> > clusters;
-        RegionGrowing segm(*points, clusters);
-        if (vec) {
-            Py::Sequence list(vec);
-            std::vector<Base::Vector3f> normals;
-            normals.reserve(list.size());
-            for (Py::Sequence::iterator it = list.begin(); it != list.end(); ++it) {
-                Base::Vector3d v = Py::Vector(*it).toVector();
-                normals.push_back(Base::convertTo<Base::Vector3f>(v));
-            }
-            segm.perform(normals);
-        }
-        else {
-            segm.perform(ksearch);
-        }
-
-        Py::List lists;
-        for (std::list<std::vector<int> >::iterator it = clusters.begin(); it != clusters.end(); ++it) {
-            Py::Tuple tuple(it->size());
-            for (std::size_t i = 0; i < it->size(); i++) {
-                tuple.setItem(i, Py::Long((*it)[i]));
-            }
-            lists.append(tuple);
-        }
-
-        return lists;
-    }
     Py::Object featureSegmentation(const Py::Tuple& args, const Py::Dict& kwds)
     {
         PyObject *pts;
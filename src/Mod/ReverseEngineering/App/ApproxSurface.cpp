@@ -29,6 +29,7 @@
 
 #include <QFuture>
 #include <QFutureWatcher>
+#include <QThread>
 #include <QtConcurrentMap>
 #include <boost_bind_bind.hpp>
 
@@ -183,6 +184,46 @@ void BSplineBasis::AllBasisFunctions(double fParam, TColStd_Array1OfReal& vFuncV
     }
 }
 
+int BSplineBasis::NonZeroBasisFunctions(double fParam, double* vFuncVals) const
+{
+    int n = _vKnotVector.Length()-_iOrder-1;
+    int p = _iOrder-1;
+    if (fParam < _vKnotVector(p) || fParam > _vKnotVector(n+1))
+        return -1;
+
+    int iIndex = n;
+    if (fParam != _vKnotVector(n+1)) {
+        int low = p;
+        int high = n+1;
+        iIndex = (low+high)/2;
+        while (fParam < _vKnotVector(iIndex) || fParam >= _vKnotVector(iIndex+1)) {
+            if (fParam < _vKnotVector(iIndex))
+                high = iIndex;
+            else
+                low = iIndex;
+            iIndex = (low+high)/2;
+        }
+    }
+
+    // same as AllBasisFunctions() but the left and right differences are
+    // computed on the fly instead of storing them in temporary arrays
+    vFuncVals[0] = 1.0;
+    for (int j=1; j<_iOrder; j++) {
+        double saved = 0.0;
+        for (int r=0; r<j; r++) {
+            double right = _vKnotVector(iIndex+r+1) - fParam;
+            double left  = fParam - _vKnotVector(iIndex+1-j+r);
+            double tmp = vFuncVals[r]/(right + left);
+            vFuncVals[r] = saved + right*tmp;
+            saved = left*tmp;
+        }
+
+        vFuncVals[j] = saved;
+    }
+
+    return iIndex;
+}
+
 BSplineBasis::ValueT BSplineBasis::LocalSupport(int iIndex, double fParam)
 {
     int m = _vKnotVector.Length()-1;
@@ -1028,6 +1069,9 @@ private:
 
 bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
 {
+    if (SolveNormalEquations(fWeight))
+        return true;
+
     unsigned ulSize = _pvcPoints->Length();
     unsigned ulDim  = _usUCtrlpoints*_usVCtrlpoints;
     math_Matrix M  (0, ulSize-1, 0, ulDim-1);
@@ -1146,6 +1190,246 @@ bool BSplineParameterCorrection::SolveWithSmoothing(double fWeight)
     return true;
 }
 
+namespace Reen {
+/**
+ * Symmetric band matrix of which only the diagonal and the upper band are stored.
+ */
+class SymmetricBandMatrix
+{
+public:
+    SymmetricBandMatrix(int dim, int band)
+      : dim(dim), band(band), values(static_cast<std::size_t>(dim)*(band+1), 0.0)
+    {
+    }
+    int size() const
+    {
+        return dim;
+    }
+    int bandwidth() const
+    {
+        return band;
+    }
+    // requires i <= j <= i+band
+    double& operator()(int i, int j)
+    {
+        return values[static_cast<std::size_t>(i)*(band+1) + (j-i)];
+    }
+    double operator()(int i, int j) const
+    {
+        return values[static_cast<std::size_t>(i)*(band+1) + (j-i)];
+    }
+    void add(const SymmetricBandMatrix& m)
+    {
+        for (std::size_t i=0; i<values.size(); i++)
+            values[i] += m.values[i];
+    }
+    /**
+     * Replaces the matrix with the upper triangular matrix U of the Cholesky
+     * decomposition A = U^T*U. Returns false if the matrix is not positive definite.
+     */
+    bool decompose()
+    {
+        for (int i=0; i<dim; i++) {
+            int first = std::max(0, i-band);
+            double diag = (*this)(i,i);
+            for (int k=first; k<i; k++)
+                diag -= (*this)(k,i) * (*this)(k,i);
+            if (diag <= 0.0)
+                return false;
+            diag = sqrt(diag);
+            (*this)(i,i) = diag;
+
+            int last = std::min(dim-1, i+band);
+            for (int j=i+1; j<=last; j++) {
+                double sum = (*this)(i,j);
+                for (int k=std::max(first, j-band); k<i; k++)
+                    sum -= (*this)(k,i) * (*this)(k,j);
+                (*this)(i,j) = sum / diag;
+            }
+        }
+        return true;
+    }
+    /**
+     * Solves the system with the decomposed matrix, the right-hand side is replaced
+     * with the solution.
+     */
+    void solve(std::vector<double>& b) const
+    {
+        // U^T*y = b
+        for (int i=0; i<dim; i++) {
+            double sum = b[i];
+            for (int k=std::max(0, i-band); k<i; k++)
+                sum -= (*this)(k,i) * b[k];
+            b[i] = sum / (*this)(i,i);
+        }
+        // U*x = y
+        for (int i=dim-1; i>=0; i--) {
+            double sum = b[i];
+            int last = std::min(dim-1, i+band);
+            for (int j=i+1; j<=last; j++)
+                sum -= (*this)(i,j) * b[j];
+            b[i] = sum / (*this)(i,i);
+        }
+    }
+
+private:
+    int dim;
+    int band;
+    std::vector<double> values;
+};
+
+/**
+ * Normal equations M^T*M*x = M^T*b of a range of points. Every thread gets its own
+ * instance and the partial sums are added afterwards.
+ */
+struct NormalEquations
+{
+    NormalEquations(int dim, int band, int begin, int end)
+      : matrix(dim, band), bx(dim, 0.0), by(dim, 0.0), bz(dim, 0.0)
+      , begin(begin), end(end)
+    {
+    }
+    void add(const NormalEquations& eq)
+    {
+        matrix.add(eq.matrix);
+        for (int i=0; i<matrix.size(); i++) {
+            bx[i] += eq.bx[i];
+            by[i] += eq.by[i];
+            bz[i] += eq.bz[i];
+        }
+    }
+
+    SymmetricBandMatrix matrix;
+    std::vector<double> bx, by, bz;
+    int begin, end;
+};
+
+/**
+ * Table of the non-vanishing basis functions of all points. Per point the span
+ * indices and the values of the u and v basis functions are stored contiguously.
+ */
+struct BasisTable
+{
+    BasisTable(int size, int uOrder, int vOrder)
+      : uOrder(uOrder), vOrder(vOrder)
+      , uSpan(size), vSpan(size)
+      , uValues(static_cast<std::size_t>(size)*uOrder)
+      , vValues(static_cast<std::size_t>(size)*vOrder)
+    {
+    }
+
+    int uOrder, vOrder;
+    std::vector<int> uSpan, vSpan;
+    std::vector<double> uValues, vValues;
+};
+}
+
+bool BSplineParameterCorrection::SolveNormalEquations(double fWeight)
+{
+    int ulSize = _pvcPoints->Length();
+    int uOrder = static_cast<int>(_usUOrder);
+    int vOrder = static_cast<int>(_usVOrder);
+    int vCount = static_cast<int>(_usVCtrlpoints);
+    int ulDim  = static_cast<int>(_usUCtrlpoints*_usVCtrlpoints);
+
+    // The row of a point has non-zero entries only for the control points (j,k) with
+    // j in [uSpan-uOrder+1, uSpan] and k in [vSpan-vOrder+1, vSpan]. With the index
+    // j*vCount+k this gives the following bandwidth of M^T*M.
+    int band = std::min(ulDim-1, (uOrder-1)*vCount + (vOrder-1));
+
+    int numChunks = std::max(1, QThread::idealThreadCount());
+    int chunkSize = (ulSize + numChunks - 1) / numChunks;
+    std::vector<NormalEquations> chunks;
+    chunks.reserve(numChunks);
+    for (int begin=0; begin<ulSize; begin+=chunkSize)
+        chunks.emplace_back(ulDim, band, begin, std::min(ulSize, begin+chunkSize));
+    if (chunks.empty())
+        return false;
+
+    // Tabulate the basis functions
+    BasisTable table(ulSize, uOrder, vOrder);
+    const TColgp_Array1OfPnt2d& uvParams = *_pvcUVParam;
+    const TColgp_Array1OfPnt& points = *_pvcPoints;
+    int uvLower = uvParams.Lower();
+    int ptLower = points.Lower();
+    const BSplineBasis& uSpline = _clUSpline;
+    const BSplineBasis& vSpline = _clVSpline;
+    QtConcurrent::blockingMap(chunks, [&](NormalEquations& eq) {
+        for (int i=eq.begin; i<eq.end; i++) {
+            const gp_Pnt2d& uvValue = uvParams(uvLower+i);
+            table.uSpan[i] = uSpline.NonZeroBasisFunctions(uvValue.X(), &table.uValues[i*uOrder]);
+            table.vSpan[i] = vSpline.NonZeroBasisFunctions(uvValue.Y(), &table.vValues[i*vOrder]);
+        }
+    });
+
+    // Assemble the normal equations
+    QtConcurrent::blockingMap(chunks, [&](NormalEquations& eq) {
+        std::vector<int> index(uOrder*vOrder);
+        std::vector<double> value(uOrder*vOrder);
+        for (int i=eq.begin; i<eq.end; i++) {
+            int uSpan = table.uSpan[i];
+            int vSpan = table.vSpan[i];
+            if (uSpan < 0 || vSpan < 0)
+                continue;
+
+            const double* uValues = &table.uValues[i*uOrder];
+            const double* vValues = &table.vValues[i*vOrder];
+            int count = 0;
+            for (int a=0; a<uOrder; a++) {
+                int j = uSpan-uOrder+1+a;
+                for (int b=0; b<vOrder; b++) {
+                    int k = vSpan-vOrder+1+b;
+                    index[count] = j*vCount+k;
+                    value[count] = uValues[a]*vValues[b];
+                    count++;
+                }
+            }
+
+            // the indices are sorted in increasing order
+            const gp_Pnt& pnt = points(ptLower+i);
+            for (int m=0; m<count; m++) {
+                int row = index[m];
+                double val = value[m];
+                for (int n=m; n<count; n++)
+                    eq.matrix(row, index[n]) += val*value[n];
+                eq.bx[row] += val*pnt.X();
+                eq.by[row] += val*pnt.Y();
+                eq.bz[row] += val*pnt.Z();
+            }
+        }
+    });
+
+    NormalEquations& system = chunks.front();
+    for (std::size_t c=1; c<chunks.size(); c++)
+        system.add(chunks[c]);
+
+    // The smoothing terms are integrals over products of basis functions and
+    // thus have the same band structure
+    if (fWeight != 0.0) {
+        for (int i=0; i<ulDim; i++) {
+            int last = std::min(ulDim-1, i+band);
+            for (int j=i; j<=last; j++)
+                system.matrix(i,j) += fWeight*_clSmoothMatrix(i,j);
+        }
+    }
+
+    if (!system.matrix.decompose())
+        return false;
+    system.matrix.solve(system.bx);
+    system.matrix.solve(system.by);
+    system.matrix.solve(system.bz);
+
+    unsigned ulIdx=0;
+    for (unsigned j=0;j<_usUCtrlpoints;j++) {
+        for (unsigned k=0;k<_usVCtrlpoints;k++) {
+            _vCtrlPntsOfSurf(j,k) = gp_Pnt(system.bx[ulIdx],system.by[ulIdx],system.bz[ulIdx]);
+            ulIdx++;
+        }
+    }
+
+    return true;
+}
+
 void BSplineParameterCorrection::CalcSmoothingTerms(bool bRecalc, double fFirst, double fSecond, double fThird)
 {
     if (bRecalc) {
@@ -182,6 +182,16 @@ public:
      */
     virtual void AllBasisFunctions(double fParam, TColStd_Array1OfReal& vFuncVals);
 
+    /**
+     * Computes the values of the non-vanishing basis functions at fParam into
+     * vFuncVals which must have room for iOrder values. Returns the knot span so
+     * that vFuncVals[i] is the value of the basis function with index span-iOrder+1+i,
+     * or -1 if fParam is outside the knot vector.
+     * Unlike the other methods no temporary OCC arrays are allocated and the method
+     * can be called from several threads.
+     */
+    int NonZeroBasisFunctions(double fParam, double* vFuncVals) const;
+
     /**
      * Gibt an, ob der Funktionswert Nik(t) an der Stelle fParam
      * 0, 1 oder ein Wert dazwischen ergibt.
@@ -400,6 +410,19 @@ protected:
      */
     virtual bool SolveWithSmoothing(double fWeight);
 
+    /**
+     * Assembles the normal equations of the least-squares problem in a banded matrix
+     * and solves them with a banded Cholesky decomposition. The basis functions are
+     * tabulated once per call and the assembly runs in parallel with per-thread
+     * accumulators. The smoothing terms are added with fWeight.
+     * This is only used for the smoothed fit which solves the normal equations anyway.
+     * The fit without smoothing keeps the Householder QR decomposition because forming
+     * M^T*M squares the condition number of ill-conditioned fits.
+     * Returns false if the system is not positive definite, in this case the caller
+     * falls back to the dense solver.
+     */
+    virtual bool SolveNormalEquations(double fWeight);
+
 public:
     /**
      * Setzen des Knotenvektors
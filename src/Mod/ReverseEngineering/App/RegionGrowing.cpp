@@ -23,27 +23,30 @@
 
 #include "PreCompiled.h"
 
+#ifndef _PreComp_
+# include <algorithm>
+# include <cmath>
+# include <queue>
+#endif
+
 #include "RegionGrowing.h"
+#include "Segmentation.h"
 #include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsKDTree.h>
 #include <Base/Exception.h>
 #include <boost/math/special_functions/fpclassify.hpp>
 
-#if defined(HAVE_PCL_FILTERS)
-#include <pcl/filters/passthrough.h>
-#include <pcl/point_types.h>
-#endif
-#if defined(HAVE_PCL_SEGMENTATION)
-#include <pcl/search/search.h>
-#include <pcl/search/kdtree.h>
-#include <pcl/features/normal_3d.h>
-#include <pcl/segmentation/region_growing.h>
-#include <pcl/filters/extract_indices.h>
-
 using namespace std;
 using namespace Reen;
-using pcl::PointXYZ;
-using pcl::PointNormal;
-using pcl::PointCloud;
+
+namespace {
+// Parameters of the region growing
+const int NumberOfNeighbours = 30;
+const std::size_t MinClusterSize = 50;
+const std::size_t MaxClusterSize = 1000000;
+const double SmoothnessThreshold = 3.0 / 180.0 * M_PI;
+const float CurvatureThreshold = 1.0f;
+}
 
 RegionGrowing::RegionGrowing(const Points::PointKernel& pts, std::list<std::vector<int> >& clusters)
   : myPoints(pts)
@@ -53,48 +56,15 @@ RegionGrowing::RegionGrowing(const Points::PointKernel& pts, std::list<std::vect
 
 void RegionGrowing::perform(int ksearch)
 {
-    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ>);
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        if (!boost::math::isnan(it->x) && !boost::math::isnan(it->y) && !boost::math::isnan(it->z))
-            cloud->push_back(pcl::PointXYZ(it->x, it->y, it->z));
-    }
+    Points::PointsKDTree tree(myPoints);
 
-    //normal estimation
-    pcl::search::Search<pcl::PointXYZ>::Ptr tree(new pcl::search::KdTree<pcl::PointXYZ>);
-    pcl::PointCloud <pcl::Normal>::Ptr normals (new pcl::PointCloud <pcl::Normal>);
-    pcl::NormalEstimation<pcl::PointXYZ, pcl::Normal> normal_estimator;
-    normal_estimator.setSearchMethod (tree);
-    normal_estimator.setInputCloud (cloud);
-    normal_estimator.setKSearch (ksearch);
-    normal_estimator.compute (*normals);
-
-    // pass through
-    pcl::IndicesPtr indices (new std::vector <int>);
-    pcl::PassThrough<pcl::PointXYZ> pass;
-    pass.setInputCloud (cloud);
-    pass.setFilterFieldName ("z");
-    pass.setFilterLimits (0.0, 1.0);
-    pass.filter (*indices);
-
-    pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> reg;
-    reg.setMinClusterSize (50);
-    reg.setMaxClusterSize (1000000);
-    reg.setSearchMethod (tree);
-    reg.setNumberOfNeighbours (30);
-    reg.setInputCloud (cloud);
-    //reg.setIndices (indices);
-    reg.setInputNormals (normals);
-    reg.setSmoothnessThreshold (3.0 / 180.0 * M_PI);
-    reg.setCurvatureThreshold (1.0);
-
-    std::vector <pcl::PointIndices> clusters;
-    reg.extract (clusters);
-
-    for (std::vector<pcl::PointIndices>::iterator it = clusters.begin (); it != clusters.end (); ++it) {
-        myClusters.push_back(std::vector<int>());
-        myClusters.back().swap(it->indices);
-    }
+    std::vector<Base::Vector3f> normals;
+    std::vector<float> curvature;
+    NormalEstimation estimate(myPoints);
+    estimate.setKSearch(ksearch);
+    estimate.perform(tree, normals, &curvature);
+
+    grow(tree, normals, curvature);
 }
 
 void RegionGrowing::perform(const std::vector<Base::Vector3f>& myNormals)
@@ -102,52 +72,78 @@ void RegionGrowing::perform(const std::vector<Base::Vector3f>& myNormals)
     if (myPoints.size() != myNormals.size())
         throw Base::RuntimeError("Number of points doesn't match with number of normals");
 
-    pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ>);
-    cloud->reserve(myPoints.size());
-    pcl::PointCloud <pcl::Normal>::Ptr normals (new pcl::PointCloud <pcl::Normal>);
-    normals->reserve(myNormals.size());
+    Points::PointsKDTree tree(myPoints);
+
+    // without further information all points are treated as flat
+    std::vector<float> curvature(myNormals.size(), 0.0f);
+    grow(tree, myNormals, curvature);
+}
 
-    std::size_t num_points = myPoints.size();
+void RegionGrowing::grow(const Points::PointsKDTree& tree, const std::vector<Base::Vector3f>& normals,
+                         const std::vector<float>& curvature)
+{
     const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
-    for (std::size_t index=0; index<num_points; index++) {
+    std::size_t num_points = points.size();
+
+    std::vector<std::vector<unsigned long> > neighbours;
+    tree.FindNeighbours(NumberOfNeighbours, 0.0f, neighbours);
+
+    // Points without a valid normal cannot be part of any region
+    std::vector<int> labels(num_points, -1);
+    std::vector<unsigned long> seeds;
+    seeds.reserve(num_points);
+    for (std::size_t index = 0; index < num_points; index++) {
         const Base::Vector3f& p = points[index];
-        const Base::Vector3f& n = myNormals[index];
-        if (!boost::math::isnan(p.x) && !boost::math::isnan(p.y) && !boost::math::isnan(p.z)) {
-            cloud->push_back(pcl::PointXYZ(p.x, p.y, p.z));
-            normals->push_back(pcl::Normal(n.x, n.y, n.z));
-        }
+        const Base::Vector3f& n = normals[index];
+        if (boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z) ||
+            boost::math::isnan(n.x) || boost::math::isnan(n.y) || boost::math::isnan(n.z))
+            labels[index] = -2;
+        else
+            seeds.push_back(index);
     }
 
-    pcl::search::Search<pcl::PointXYZ>::Ptr tree(new pcl::search::KdTree<pcl::PointXYZ>);
-    tree->setInputCloud (cloud);
-
-    // pass through
-    pcl::IndicesPtr indices (new std::vector <int>);
-    pcl::PassThrough<pcl::PointXYZ> pass;
-    pass.setInputCloud (cloud);
-    pass.setFilterFieldName ("z");
-    pass.setFilterLimits (0.0, 1.0);
-    pass.filter (*indices);
-
-    pcl::RegionGrowing<pcl::PointXYZ, pcl::Normal> reg;
-    reg.setMinClusterSize (50);
-    reg.setMaxClusterSize (1000000);
-    reg.setSearchMethod (tree);
-    reg.setNumberOfNeighbours (30);
-    reg.setInputCloud (cloud);
-    //reg.setIndices (indices);
-    reg.setInputNormals (normals);
-    reg.setSmoothnessThreshold (3.0 / 180.0 * M_PI);
-    reg.setCurvatureThreshold (1.0);
-
-    std::vector <pcl::PointIndices> clusters;
-    reg.extract (clusters);
-
-    for (std::vector<pcl::PointIndices>::iterator it = clusters.begin (); it != clusters.end (); ++it) {
-        myClusters.push_back(std::vector<int>());
-        myClusters.back().swap(it->indices);
-    }
-}
+    // start with the flattest points
+    std::stable_sort(seeds.begin(), seeds.end(), [&curvature](unsigned long a, unsigned long b) {
+        return curvature[a] < curvature[b];
+    });
+
+    const float cosThreshold = static_cast<float>(std::cos(SmoothnessThreshold));
+    int label = 0;
+    for (std::vector<unsigned long>::iterator it = seeds.begin(); it != seeds.end(); ++it) {
+        if (labels[*it] != -1)
+            continue;
+
+        std::vector<int> region;
+        std::queue<unsigned long> front;
+        front.push(*it);
+        labels[*it] = label;
+        region.push_back(static_cast<int>(*it));
+
+        while (!front.empty()) {
+            unsigned long current = front.front();
+            front.pop();
+
+            const Base::Vector3f& normal = normals[current];
+            const std::vector<unsigned long>& nb = neighbours[current];
+            for (std::vector<unsigned long>::const_iterator jt = nb.begin(); jt != nb.end(); ++jt) {
+                unsigned long next = *jt;
+                if (labels[next] != -1)
+                    continue;
+                if (std::fabs(normal * normals[next]) < cosThreshold)
+                    continue;
+
+                labels[next] = label;
+                region.push_back(static_cast<int>(next));
+                if (curvature[next] <= CurvatureThreshold)
+                    front.push(next);
+            }
+        }
 
-#endif // HAVE_PCL_SEGMENTATION
+        if (region.size() >= MinClusterSize && region.size() <= MaxClusterSize) {
+            myClusters.push_back(std::vector<int>());
+            myClusters.back().swap(region);
+        }
 
+        label++;
+    }
+}
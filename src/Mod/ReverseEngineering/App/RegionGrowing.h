@@ -28,10 +28,15 @@
 #include <vector>
 #include <list>
 
-namespace Points {class PointKernel;}
+namespace Points {class PointKernel; class PointsKDTree;}
 
 namespace Reen {
 
+/**
+ * Segments a point cloud into smooth regions. Starting from the point with the
+ * lowest curvature a region grows over all neighbours whose normals deviate less
+ * than the smoothness threshold.
+ */
 class RegionGrowing
 {
 public:
@@ -45,6 +50,10 @@ public:
       */
     void perform(const std::vector<Base::Vector3f>& normals);
 
+private:
+    void grow(const Points::PointsKDTree&, const std::vector<Base::Vector3f>& normals,
+              const std::vector<float>& curvature);
+
 private:
     const Points::PointKernel& myPoints;
     std::list<std::vector<int> >& myClusters;
@@ -23,8 +23,18 @@
 
 #include "PreCompiled.h"
 
+#ifndef _PreComp_
+# include <limits>
+#endif
+
+#include <QtConcurrentMap>
+#include <Eigen/Eigenvalues>
+#include <boost/math/special_functions/fpclassify.hpp>
+
 #include "Segmentation.h"
 #include <Mod/Points/App/Points.h>
+#include <Mod/Points/App/PointsKDTree.h>
+#include <Base/Converter.h>
 #include <Base/Exception.h>
 
 #if defined(HAVE_PCL_FILTERS)
@@ -159,7 +169,6 @@ void Segmentation::perform(int ksearch)
 
 // ----------------------------------------------------------------------------
 
-#if defined (HAVE_PCL_FILTERS)
 NormalEstimation::NormalEstimation(const Points::PointKernel& pts)
   : myPoints(pts)
   , kSearch(0)
@@ -169,43 +178,91 @@ NormalEstimation::NormalEstimation(const Points::PointKernel& pts)
 
 void NormalEstimation::perform(std::vector<Base::Vector3d>& normals)
 {
-    // Copy the points
-    pcl::PointCloud<PointXYZ>::Ptr cloud (new pcl::PointCloud<PointXYZ>);
-    cloud->reserve(myPoints.size());
-    for (Points::PointKernel::const_iterator it = myPoints.begin(); it != myPoints.end(); ++it) {
-        cloud->push_back(pcl::PointXYZ(it->x, it->y, it->z));
+    Points::PointsKDTree tree(myPoints);
+
+    std::vector<Base::Vector3f> local;
+    perform(tree, local);
+
+    // The normals are computed in the local coordinate system of the kernel.
+    // Transform them and orient them towards the origin as viewpoint.
+    Base::Matrix4D mat = myPoints.getTransform();
+    Base::Vector3d nullPt;
+    mat.multVec(nullPt, nullPt);
+
+    normals.reserve(local.size());
+    for (std::size_t i = 0; i < local.size(); i++) {
+        Base::Vector3d n = Base::convertTo<Base::Vector3d>(local[i]);
+        if (!boost::math::isnan(n.x)) {
+            mat.multVec(n, n);
+            n = n - nullPt;
+            if (n * myPoints.getPoint(i) > 0.0)
+                n = -n;
+        }
+        normals.push_back(n);
     }
+}
 
-    cloud->width = int (cloud->points.size ());
-    cloud->height = 1;
-
-#if 0
-    // Build a passthrough filter to remove spurious NaNs
-    pcl::PointCloud<PointXYZ>::Ptr cloud_filtered (new pcl::PointCloud<PointXYZ>);
-    pcl::PassThrough<PointXYZ> pass;
-    pass.setInputCloud (cloud);
-    pass.setFilterFieldName ("z");
-    pass.setFilterLimits (0, 1.5);
-    pass.filter (*cloud_filtered);
-#endif
+void NormalEstimation::perform(const Points::PointsKDTree& tree, std::vector<Base::Vector3f>& normals,
+                               std::vector<float>* curvature)
+{
+    if (kSearch <= 0 && searchRadius <= 0)
+        throw Base::ValueError("Either the number of neighbours or the search radius must be set");
 
-    // Estimate point normals
-    pcl::PointCloud<pcl::Normal>::Ptr cloud_normals (new pcl::PointCloud<pcl::Normal>);
-    pcl::search::KdTree<PointXYZ>::Ptr tree (new pcl::search::KdTree<PointXYZ> ());
-    pcl::NormalEstimation<PointXYZ, pcl::Normal> ne;
-    ne.setSearchMethod (tree);
-    //ne.setInputCloud (cloud_filtered);
-    ne.setInputCloud (cloud);
-    if (kSearch > 0)
-        ne.setKSearch (kSearch);
-    if (searchRadius > 0)
-        ne.setRadiusSearch (searchRadius);
-    ne.compute (*cloud_normals);
+    const std::vector<Base::Vector3f>& points = myPoints.getBasicPoints();
+    const float nan = std::numeric_limits<float>::quiet_NaN();
 
-    normals.reserve(cloud_normals->size());
-    for (pcl::PointCloud<pcl::Normal>::const_iterator it = cloud_normals->begin(); it != cloud_normals->end(); ++it) {
-        normals.push_back(Base::Vector3d(it->normal_x, it->normal_y, it->normal_z));
+    normals.clear();
+    normals.resize(points.size(), Base::Vector3f(nan, nan, nan));
+    if (curvature) {
+        curvature->clear();
+        curvature->resize(points.size(), nan);
     }
-}
 
-#endif // HAVE_PCL_FILTERS
+    // the elements of the normal list are processed concurrently, their position is the point index
+    if (points.empty())
+        return;
+    const Base::Vector3f* firstNormal = &normals.front();
+    int k = kSearch;
+    float radius = static_cast<float>(searchRadius);
+
+    QtConcurrent::blockingMap(normals, [&, firstNormal, k, radius](Base::Vector3f& normal) {
+        std::size_t index = &normal - firstNormal;
+        const Base::Vector3f& p = points[index];
+        if (boost::math::isnan(p.x) || boost::math::isnan(p.y) || boost::math::isnan(p.z))
+            return;
+
+        std::vector<unsigned long> neighbours;
+        if (k > 0)
+            tree.FindKNearest(p, k, neighbours);
+        else
+            tree.FindInRadius(p, radius, neighbours);
+        if (neighbours.size() < 3)
+            return;
+
+        // covariance matrix of the neighbourhood
+        Eigen::Vector3d center(0, 0, 0);
+        for (std::vector<unsigned long>::iterator it = neighbours.begin(); it != neighbours.end(); ++it) {
+            const Base::Vector3f& q = points[*it];
+            center += Eigen::Vector3d(q.x, q.y, q.z);
+        }
+        center /= static_cast<double>(neighbours.size());
+
+        Eigen::Matrix3d cov = Eigen::Matrix3d::Zero();
+        for (std::vector<unsigned long>::iterator it = neighbours.begin(); it != neighbours.end(); ++it) {
+            const Base::Vector3f& q = points[*it];
+            Eigen::Vector3d d = Eigen::Vector3d(q.x, q.y, q.z) - center;
+            cov += d * d.transpose();
+        }
+
+        // the eigenvalues are sorted in increasing order
+        Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eig(cov);
+        Eigen::Vector3d n = eig.eigenvectors().col(0);
+        normal.Set(static_cast<float>(n.x()), static_cast<float>(n.y()), static_cast<float>(n.z()));
+
+        if (curvature) {
+            const Eigen::Vector3d& ev = eig.eigenvalues();
+            double sum = ev.sum();
+            (*curvature)[index] = sum > 0.0 ? static_cast<float>(ev(0) / sum) : 0.0f;
+        }
+    });
+}
@@ -28,7 +28,7 @@
 #include <vector>
 #include <list>
 
-namespace Points {class PointKernel;}
+namespace Points {class PointKernel; class PointsKDTree;}
 
 namespace Reen {
 
@@ -46,6 +46,11 @@ private:
     std::list<std::vector<int> >& myClusters;
 };
 
+/**
+ * Estimates the point normals by a principal component analysis of the neighbourhood
+ * of each point. The neighbours are searched with a Points::PointsKDTree and the
+ * points are processed concurrently.
+ */
 class NormalEstimation
 {
 public:
@@ -71,6 +76,15 @@ public:
       */
     void perform(std::vector<Base::Vector3d>& normals);
 
+    /** \brief Perform the normal estimation in the local coordinate system of the points
+      * using an already built search tree.
+      * \param[in] tree the search tree built from the points given in the constructor
+      * \param[out] normals the estimated normals, invalid points get a NaN normal
+      * \param[out] curvature the surface variation of each point if not null
+      */
+    void perform(const Points::PointsKDTree& tree, std::vector<Base::Vector3f>& normals,
+                 std::vector<float>* curvature = nullptr);
+
 private:
     const Points::PointKernel& myPoints;
     int kSearch;
@@ -0,0 +1,161 @@
+#**************************************************************************
+#   Copyright (c) 2020 FreeCAD Developers                                 *
+#                                                                         *
+#   This file is part of the FreeCAD CAx development system.              *
+#                                                                         *
+#   This program is free software; you can redistribute it and/or modify  *
+#   it under the terms of the GNU Lesser General Public License (LGPL)    *
+#   as published by the Free Software Foundation; either version 2 of     *
+#   the License, or (at your option) any later version.                   *
+#   for detail see the LICENCE text file.                                 *
+#                                                                         *
+#   FreeCAD is distributed in the hope that it will be useful,            *
+#   but WITHOUT ANY WARRANTY; without even the implied warranty of        *
+#   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the         *
+#   GNU Library General Public License for more details.                  *
+#                                                                         *
+#   You should have received a copy of the GNU Library General Public     *
+#   License along with FreeCAD; if not, write to the Free Software        *
+#   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  *
+#   USA                                                                   *
+#**************************************************************************
+
+import FreeCAD, unittest, random, math
+import numpy as np
+import Part, Points
+import ReverseEngineering as Reen
+
+#---------------------------------------------------------------------------
+# define the test cases to test the FreeCAD ReverseEngineering module
+#---------------------------------------------------------------------------
+
+def saddlePoints(count):
+    pts = []
+    for i in range(count):
+        for j in range(count):
+            x = 10.0 * i / (count - 1)
+            y = 10.0 * j / (count - 1)
+            pts.append(FreeCAD.Vector(x, y, 0.02 * (x - 5.0) ** 2 - 0.02 * (y - 5.0) ** 2))
+    return pts
+
+def spherePoints(count, radius, noise, seed):
+    rnd = random.Random(seed)
+    pts = []
+    for i in range(count):
+        v = FreeCAD.Vector(rnd.gauss(0, 1), rnd.gauss(0, 1), rnd.gauss(0, 1))
+        v.normalize()
+        pts.append(v * (radius + rnd.gauss(0, noise)))
+    return pts
+
+def gridPoints(origin, u, v, count):
+    return [origin + u * i + v * j for i in range(count) for j in range(count)]
+
+def pcaNormal(pts, indexes):
+    # normal of the plane fitted through the selected points
+    m = np.array([[pts[i].x, pts[i].y, pts[i].z] for i in indexes])
+    m -= m.mean(axis=0)
+    w, v = np.linalg.eigh(m.T.dot(m))
+    return FreeCAD.Vector(*v[:, 0])
+
+
+class ApproxSurfaceCases(unittest.TestCase):
+    def testFitSaddle(self):
+        pts = saddlePoints(30)
+        surf = Reen.approxSurface(Points=Points.Points(pts), UDegree=3, VDegree=3,
+                                  NbUPoles=6, NbVPoles=6, Smooth=False,
+                                  Iterations=3, Correction=True)
+        face = surf.toShape()
+        for p in pts[::37]:
+            dist = face.distToShape(Part.Vertex(p))[0]
+            self.assertLess(dist, 1e-3)
+
+    def testFitSaddleSmooth(self):
+        pts = saddlePoints(30)
+        surf = Reen.approxSurface(Points=Points.Points(pts), UDegree=3, VDegree=3,
+                                  NbUPoles=8, NbVPoles=8, Smooth=True, Weight=0.1,
+                                  Iterations=3, Correction=True)
+        face = surf.toShape()
+        for p in pts[::37]:
+            dist = face.distToShape(Part.Vertex(p))[0]
+            self.assertLess(dist, 1e-2)
+
+
+class NormalEstimationCases(unittest.TestCase):
+    def testKNearestAgainstBruteForce(self):
+        pts = spherePoints(500, 10.0, 0.2, 1)
+        k = 8
+        normals = Reen.normalEstimation(Points.Points(pts), KSearch=k)
+        self.assertEqual(len(normals), len(pts))
+        checked = 0
+        for i in range(0, len(pts), 10):
+            order = sorted(range(len(pts)), key=lambda j: pts[i].distanceToPoint(pts[j]))
+            # skip queries where float rounding may swap the k-th and the next neighbour
+            if pts[i].distanceToPoint(pts[order[k]]) - pts[i].distanceToPoint(pts[order[k - 1]]) < 1e-3:
+                continue
+            n = pcaNormal(pts, order[:k])
+            self.assertGreater(abs(n.dot(normals[i])), 1.0 - 1e-4)
+            checked += 1
+        self.assertGreater(checked, 0)
+
+    def testRadiusAgainstBruteForce(self):
+        pts = spherePoints(500, 10.0, 0.2, 2)
+        radius = 2.5
+        normals = Reen.normalEstimation(Points.Points(pts), SearchRadius=radius)
+        self.assertEqual(len(normals), len(pts))
+        checked = 0
+        for i in range(0, len(pts), 10):
+            dist = [pts[i].distanceToPoint(p) for p in pts]
+            if min(abs(d - radius) for d in dist) < 1e-3:
+                continue
+            inside = [j for j, d in enumerate(dist) if d <= radius]
+            if len(inside) < 3:
+                self.assertTrue(math.isnan(normals[i].x))
+                continue
+            n = pcaNormal(pts, inside)
+            self.assertGreater(abs(n.dot(normals[i])), 1.0 - 1e-4)
+            checked += 1
+        self.assertGreater(checked, 0)
+
+    def testPlane(self):
+        pts = gridPoints(FreeCAD.Vector(-5, -5, 5), FreeCAD.Vector(1, 0, 0), FreeCAD.Vector(0, 1, 0), 11)
+        normals = Reen.normalEstimation(Points.Points(pts), KSearch=6)
+        # the normals are oriented towards the origin
+        for n in normals:
+            self.assertAlmostEqual(n.z, -1.0, 5)
+
+    def testSphere(self):
+        pts = spherePoints(1000, 10.0, 0.0, 3)
+        normals = Reen.normalEstimation(Points.Points(pts), KSearch=10)
+        for p, n in zip(pts, normals):
+            self.assertLess(FreeCAD.Vector(p).normalize().dot(n), -0.99)
+
+    def testMissingParameter(self):
+        pts = spherePoints(20, 1.0, 0.0, 4)
+        with self.assertRaises(RuntimeError):
+            Reen.normalEstimation(Points.Points(pts))
+
+
+class RegionGrowingCases(unittest.TestCase):
+    def testSeparatePlanes(self):
+        pts = gridPoints(FreeCAD.Vector(0, 0, 0), FreeCAD.Vector(1, 0, 0), FreeCAD.Vector(0, 1, 0), 20)
+        pts += gridPoints(FreeCAD.Vector(100, 0, 0), FreeCAD.Vector(0, 1, 0), FreeCAD.Vector(0, 0, 1), 20)
+        segments = Reen.regionGrowingSegmentation(Points.Points(pts), KSearch=8)
+        self.assertEqual(len(segments), 2)
+        self.assertEqual(sorted(len(s) for s in segments), [400, 400])
+        self.assertEqual(set(segments[0]) | set(segments[1]), set(range(800)))
+
+    def testTouchingPlanesWithNormals(self):
+        # two perpendicular planes sharing an edge and a small patch that is below the minimum size
+        pts = gridPoints(FreeCAD.Vector(0, 0, 0), FreeCAD.Vector(1, 0, 0), FreeCAD.Vector(0, 1, 0), 20)
+        nor = [FreeCAD.Vector(0, 0, 1)] * len(pts)
+        pts += gridPoints(FreeCAD.Vector(0, 0, 1), FreeCAD.Vector(0, 1, 0), FreeCAD.Vector(0, 0, 1), 20)
+        nor += [FreeCAD.Vector(1, 0, 0)] * 400
+        pts += gridPoints(FreeCAD.Vector(200, 0, 0), FreeCAD.Vector(1, 0, 0), FreeCAD.Vector(0, 1, 0), 5)
+        nor += [FreeCAD.Vector(0, 0, 1)] * 25
+        segments = Reen.regionGrowingSegmentation(Points.Points(pts), Normals=nor)
+        self.assertEqual(sorted(len(s) for s in segments), [400, 400])
+
+    def testNormalCountMismatch(self):
+        pts = spherePoints(20, 1.0, 0.0, 5)
+        with self.assertRaises(RuntimeError):
+            Reen.regionGrowingSegmentation(Points.Points(pts), Normals=[FreeCAD.Vector(0, 0, 1)])
@@ -3516,7 +3516,8 @@ int Sketch::initMove(int geoId, PointPos pos, bool fine)
     }
     InitParameters = MoveParameters;
 
-    GCSsys.initSolution();
+    // keep the solver state between the moves of the drag
+    GCSsys.initDrag();
     isInitMove = true;
     return 0;
 }
@@ -447,6 +447,10 @@ public:
     inline void setConvergenceRedundant(double conv){GCSsys.convergenceRedundant=conv;}
     inline void setQRAlgorithm(GCS::QRAlgorithm alg){GCSsys.qrAlgorithm=alg;}
     inline GCS::QRAlgorithm getQRAlgorithm(){return GCSsys.qrAlgorithm;}
+    inline void setParallelSolve(bool on){GCSsys.parallelComponents=on;}
+    inline bool getParallelSolve() const {return GCSsys.parallelComponents;}
+    inline void setIncrementalDiagnosis(bool on){GCSsys.incrementalDiagnosis=on;}
+    inline bool getIncrementalDiagnosis() const {return GCSsys.incrementalDiagnosis;}
     inline void setQRPivotThreshold(double val){GCSsys.qrpivotThreshold=val;}
     inline void setLM_eps(double val){GCSsys.LM_eps=val;}
     inline void setLM_eps1(double val){GCSsys.LM_eps1=val;}
@@ -727,6 +727,32 @@ int SketchObject::movePoint(int GeoId, PointPos PosId, const Base::Vector3d& toP
     return lastSolverStatus;
 }
 
+int SketchObject::initTemporaryMove(int GeoId, PointPos PosId, bool fine)
+{
+    // the drag starts from the solved sketch, so it must be up to date
+    if (solverNeedsUpdate) {
+        lastDoF = solvedSketch.setUpSketch(getCompleteGeometry(), Constraints.getValues(),
+                                    getExternalGeometryCount());
+
+        lastHasConflict = solvedSketch.hasConflicts();
+        lastHasRedundancies = solvedSketch.hasRedundancies();
+        lastConflicting=solvedSketch.getConflicting();
+        lastRedundant=solvedSketch.getRedundant();
+
+        solverNeedsUpdate=false;
+    }
+
+    if (lastDoF < 0 || lastHasConflict)
+        return -1;
+
+    return solvedSketch.initMove(GeoId, PosId, fine);
+}
+
+int SketchObject::moveTemporaryPoint(int GeoId, PointPos PosId, const Base::Vector3d& toPoint, bool relative)
+{
+    return solvedSketch.movePoint(GeoId, PosId, toPoint, relative);
+}
+
 Base::Vector3d SketchObject::getPoint(int GeoId, PointPos PosId) const
 {
     if(!(GeoId == H_Axis || GeoId == V_Axis
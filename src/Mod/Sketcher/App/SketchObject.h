@@ -201,6 +201,12 @@ public:
     int toggleVirtualSpace(int ConstrId);
     /// move this point to a new location and solve
     int movePoint(int GeoId, PointPos PosId, const Base::Vector3d& toPoint, bool relative=false, bool updateGeoBeforeMoving=false);
+    /** starts a drag session of a point (or curve) in the solved sketch. The solver keeps its
+     * state until the session ends, so that every moveTemporaryPoint only needs a few iterations.
+     */
+    int initTemporaryMove(int GeoId, PointPos PosId, bool fine=true);
+    /// moves the point of the drag session, only the solved sketch is updated
+    int moveTemporaryPoint(int GeoId, PointPos PosId, const Base::Vector3d& toPoint, bool relative=false);
     /// retrieves the coordinates of a point
     Base::Vector3d getPoint(int GeoId, PointPos PosId) const;
 
@@ -341,6 +347,12 @@ public:
     /// gets the solved sketch as a reference
     inline Sketch &getSolvedSketch(void) {return solvedSketch;}
 
+    /// if the decoupled parts of the sketch are solved and diagnosed concurrently
+    inline void setParallelSolve(bool on) {solvedSketch.setParallelSolve(on); solverNeedsUpdate=true;}
+    inline bool getParallelSolve(void) const {return solvedSketch.getParallelSolve();}
+    inline void setIncrementalDiagnosis(bool on) {solvedSketch.setIncrementalDiagnosis(on); solverNeedsUpdate=true;}
+    inline bool getIncrementalDiagnosis(void) const {return solvedSketch.getIncrementalDiagnosis();}
+
     /// returns the geometric elements/vertex which the solver detects as having dependent parameters.
     /// these parameters relate to not fully constraint edges/vertices.
     void getGeometryWithDependentParameters(std::vector<std::pair<int,PointPos>>& geometrymap);
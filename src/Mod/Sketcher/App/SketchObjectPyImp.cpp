@@ -941,6 +941,37 @@ PyObject* SketchObjectPy::movePoint(PyObject *args)
 
 }
 
+PyObject* SketchObjectPy::initTemporaryMove(PyObject *args)
+{
+    int GeoId, PointType;
+    PyObject* fine = Py_True;
+    if (!PyArg_ParseTuple(args, "ii|O!", &GeoId, &PointType, &PyBool_Type, &fine))
+        return 0;
+
+    if (this->getSketchObjectPtr()->initTemporaryMove(GeoId,(Sketcher::PointPos)PointType,PyObject_IsTrue(fine) ? true : false)) {
+        std::stringstream str;
+        str << "Not able to move point with the id and type: (" << GeoId << ", " << PointType << ")";
+        PyErr_SetString(PyExc_ValueError, str.str().c_str());
+        return 0;
+    }
+
+    Py_Return;
+}
+
+PyObject* SketchObjectPy::moveTemporaryPoint(PyObject *args)
+{
+    PyObject *pcObj;
+    int GeoId, PointType;
+    int relative=0;
+
+    if (!PyArg_ParseTuple(args, "iiO!|i", &GeoId, &PointType, &(Base::VectorPy::Type), &pcObj, &relative))
+        return 0;
+
+    Base::Vector3d v1 = static_cast<Base::VectorPy*>(pcObj)->value();
+    int ret = this->getSketchObjectPtr()->moveTemporaryPoint(GeoId,(Sketcher::PointPos)PointType,v1,(relative>0));
+    return Py::new_reference_to(Py::Boolean(ret == 0));
+}
+
 PyObject* SketchObjectPy::getGeoVertexIndex(PyObject *args)
 {
     int index;
@@ -1738,6 +1769,26 @@ Py::Long SketchObjectPy::getAxisCount(void) const
     return Py::Long(this->getSketchObjectPtr()->getAxisCount());
 }
 
+Py::Boolean SketchObjectPy::getParallelSolve(void) const
+{
+    return Py::Boolean(this->getSketchObjectPtr()->getParallelSolve());
+}
+
+void SketchObjectPy::setParallelSolve(Py::Boolean arg)
+{
+    this->getSketchObjectPtr()->setParallelSolve(static_cast<bool>(arg));
+}
+
+Py::Boolean SketchObjectPy::getIncrementalDiagnosis(void) const
+{
+    return Py::Boolean(this->getSketchObjectPtr()->getIncrementalDiagnosis());
+}
+
+void SketchObjectPy::setIncrementalDiagnosis(Py::Boolean arg)
+{
+    this->getSketchObjectPtr()->setIncrementalDiagnosis(static_cast<bool>(arg));
+}
+
 PyObject *SketchObjectPy::getCustomAttributes(const char* /*attr*/) const
 {
     return 0;
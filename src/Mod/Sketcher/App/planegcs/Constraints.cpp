@@ -41,7 +41,7 @@ Constraint::Constraint()
 {
 }
 
-void Constraint::redirectParams(MAP_pD_pD redirectionmap)
+void Constraint::redirectParams(const MAP_pD_pD &redirectionmap)
 {
     int i=0;
     for (VEC_pD::iterator param=origpvec.begin();
@@ -79,6 +79,18 @@ double Constraint::grad(double * /*param*/)
     return 0.;
 }
 
+double Constraint::errorAndGrad(double *grads)
+{
+    for (std::size_t i=0; i < pvec.size(); i++) {
+        // grad() already sums up all occurrences of a parameter
+        if (findParamInPvec(pvec[i]) == static_cast<int>(i))
+            grads[i] = grad(pvec[i]);
+        else
+            grads[i] = 0.;
+    }
+    return error();
+}
+
 double Constraint::maxStep(MAP_pD_D & /*dir*/, double lim)
 {
     return lim;
@@ -129,6 +141,13 @@ double ConstraintEqual::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintEqual::errorAndGrad(double *grads)
+{
+    grads[0] = scale;
+    grads[1] = -scale;
+    return scale * (*param1() - ratio *(*param2()));
+}
+
 // Difference
 ConstraintDifference::ConstraintDifference(double *p1, double *p2, double *d)
 {
@@ -163,6 +182,14 @@ double ConstraintDifference::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintDifference::errorAndGrad(double *grads)
+{
+    grads[0] = -scale;
+    grads[1] = scale;
+    grads[2] = -scale;
+    return scale * (*param2() - *param1() - *difference());
+}
+
 // P2PDistance
 ConstraintP2PDistance::ConstraintP2PDistance(Point &p1, Point &p2, double *d)
 {
@@ -212,6 +239,19 @@ double ConstraintP2PDistance::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintP2PDistance::errorAndGrad(double *grads)
+{
+    double dx = (*p1x() - *p2x());
+    double dy = (*p1y() - *p2y());
+    double d = sqrt(dx*dx + dy*dy);
+    grads[0] = scale * (dx/d);
+    grads[1] = scale * (dy/d);
+    grads[2] = scale * (-dx/d);
+    grads[3] = scale * (-dy/d);
+    grads[4] = -scale;
+    return scale * (d - *distance());
+}
+
 double ConstraintP2PDistance::maxStep(MAP_pD_D &dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -303,6 +343,26 @@ double ConstraintP2PAngle::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintP2PAngle::errorAndGrad(double *grads)
+{
+    double dx = (*p2x() - *p1x());
+    double dy = (*p2y() - *p1y());
+    double a = *angle() + da;
+    double ca = cos(a);
+    double sa = sin(a);
+    double x = dx*ca + dy*sa;
+    double y = -dx*sa + dy*ca;
+    double r2 = dx*dx+dy*dy;
+    double ddx = -y/r2;
+    double ddy = x/r2;
+    grads[0] = scale * (-ca*ddx + sa*ddy);
+    grads[1] = scale * (-sa*ddx - ca*ddy);
+    grads[2] = scale * ( ca*ddx - sa*ddy);
+    grads[3] = scale * ( sa*ddx + ca*ddy);
+    grads[4] = -scale;
+    return scale * atan2(y,x);
+}
+
 double ConstraintP2PAngle::maxStep(MAP_pD_D &dir, double lim)
 {
     // step(angle()) <= pi/18 = 10°
@@ -381,6 +441,26 @@ double ConstraintP2LDistance::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintP2LDistance::errorAndGrad(double *grads)
+{
+    double x0=*p0x(), x1=*p1x(), x2=*p2x();
+    double y0=*p0y(), y1=*p1y(), y2=*p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    double sscale = (area < 0) ? -scale : scale;
+    grads[0] = sscale * ((y1-y2) / d);
+    grads[1] = sscale * ((x2-x1) / d);
+    grads[2] = sscale * (((y2-y0)*d + (dx/d)*area) / d2);
+    grads[3] = sscale * (((x0-x2)*d + (dy/d)*area) / d2);
+    grads[4] = sscale * (((y0-y1)*d - (dx/d)*area) / d2);
+    grads[5] = sscale * (((x1-x0)*d - (dy/d)*area) / d2);
+    grads[6] = -scale;
+    return scale * (std::abs(area)/d - *distance());
+}
+
 double ConstraintP2LDistance::maxStep(MAP_pD_D &dir, double lim)
 {
     MAP_pD_D::iterator it;
@@ -493,6 +573,24 @@ double ConstraintPointOnLine::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintPointOnLine::errorAndGrad(double *grads)
+{
+    double x0=*p0x(), x1=*p1x(), x2=*p2x();
+    double y0=*p0y(), y1=*p1y(), y2=*p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    grads[0] = scale * ((y1-y2) / d);
+    grads[1] = scale * ((x2-x1) / d);
+    grads[2] = scale * (((y2-y0)*d + (dx/d)*area) / d2);
+    grads[3] = scale * (((x0-x2)*d + (dy/d)*area) / d2);
+    grads[4] = scale * (((y0-y1)*d - (dx/d)*area) / d2);
+    grads[5] = scale * (((x1-x0)*d - (dy/d)*area) / d2);
+    return scale * area/d;
+}
+
 // PointOnPerpBisector
 ConstraintPointOnPerpBisector::ConstraintPointOnPerpBisector(Point &p, Line &l)
 {
@@ -622,6 +720,23 @@ double ConstraintParallel::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintParallel::errorAndGrad(double *grads)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    grads[0] = scale * dy2;
+    grads[1] = scale * -dx2;
+    grads[2] = scale * -dy2;
+    grads[3] = scale * dx2;
+    grads[4] = scale * -dy1;
+    grads[5] = scale * dx1;
+    grads[6] = scale * dy1;
+    grads[7] = scale * -dx1;
+    return scale * (dx1*dy2 - dy1*dx2);
+}
+
 // Perpendicular
 ConstraintPerpendicular::ConstraintPerpendicular(Line &l1, Line &l2)
 {
@@ -691,6 +806,23 @@ double ConstraintPerpendicular::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintPerpendicular::errorAndGrad(double *grads)
+{
+    double dx1 = (*l1p1x() - *l1p2x());
+    double dy1 = (*l1p1y() - *l1p2y());
+    double dx2 = (*l2p1x() - *l2p2x());
+    double dy2 = (*l2p1y() - *l2p2y());
+    grads[0] = scale * dx2;
+    grads[1] = scale * dy2;
+    grads[2] = scale * -dx2;
+    grads[3] = scale * -dy2;
+    grads[4] = scale * dx1;
+    grads[5] = scale * dy1;
+    grads[6] = scale * -dx1;
+    grads[7] = scale * -dy1;
+    return scale * (dx1*dx2 + dy1*dy2);
+}
+
 // L2LAngle
 ConstraintL2LAngle::ConstraintL2LAngle(Line &l1, Line &l2, double *a)
 {
@@ -784,6 +916,33 @@ double ConstraintL2LAngle::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintL2LAngle::errorAndGrad(double *grads)
+{
+    double dx1 = (*l1p2x() - *l1p1x());
+    double dy1 = (*l1p2y() - *l1p1y());
+    double dx2 = (*l2p2x() - *l2p1x());
+    double dy2 = (*l2p2y() - *l2p1y());
+    double r1 = dx1*dx1+dy1*dy1;
+    grads[0] = scale * (-dy1/r1);
+    grads[1] = scale * (dx1/r1);
+    grads[2] = scale * (dy1/r1);
+    grads[3] = scale * (-dx1/r1);
+    double a = atan2(dy1,dx1) + *angle();
+    double ca = cos(a);
+    double sa = sin(a);
+    double x2 = dx2*ca + dy2*sa;
+    double y2 = -dx2*sa + dy2*ca;
+    double r2 = dx2*dx2+dy2*dy2;
+    double ddx2 = -y2/r2;
+    double ddy2 = x2/r2;
+    grads[4] = scale * (-ca*ddx2 + sa*ddy2);
+    grads[5] = scale * (-sa*ddx2 - ca*ddy2);
+    grads[6] = scale * ( ca*ddx2 - sa*ddy2);
+    grads[7] = scale * ( sa*ddx2 + ca*ddy2);
+    grads[8] = -scale;
+    return scale * atan2(y2,x2);
+}
+
 double ConstraintL2LAngle::maxStep(MAP_pD_D &dir, double lim)
 {
     // step(angle()) <= pi/18 = 10°
@@ -879,6 +1038,26 @@ double ConstraintMidpointOnLine::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintMidpointOnLine::errorAndGrad(double *grads)
+{
+    double x0=((*l1p1x())+(*l1p2x()))/2;
+    double y0=((*l1p1y())+(*l1p2y()))/2;
+    double x1=*l2p1x(), x2=*l2p2x();
+    double y1=*l2p1y(), y2=*l2p2y();
+    double dx = x2-x1;
+    double dy = y2-y1;
+    double d2 = dx*dx+dy*dy;
+    double d = sqrt(d2);
+    double area = -x0*dy+y0*dx+x1*y2-x2*y1;
+    grads[0] = grads[2] = scale * ((y1-y2) / (2*d));
+    grads[1] = grads[3] = scale * ((x2-x1) / (2*d));
+    grads[4] = scale * (((y2-y0)*d + (dx/d)*area) / d2);
+    grads[5] = scale * (((x0-x2)*d + (dy/d)*area) / d2);
+    grads[6] = scale * (((y0-y1)*d - (dx/d)*area) / d2);
+    grads[7] = scale * (((x1-x0)*d - (dy/d)*area) / d2);
+    return scale * area/d;
+}
+
 // TangentCircumf
 ConstraintTangentCircumf::ConstraintTangentCircumf(Point &p1, Point &p2,
                                                    double *rad1, double *rad2, bool internal_)
@@ -939,6 +1118,24 @@ double ConstraintTangentCircumf::grad(double *param)
     return scale * deriv;
 }
 
+double ConstraintTangentCircumf::errorAndGrad(double *grads)
+{
+    double dx = (*c1x() - *c2x());
+    double dy = (*c1y() - *c2y());
+    double d = sqrt(dx*dx + dy*dy);
+    grads[0] = scale * (dx/d);
+    grads[1] = scale * (dy/d);
+    grads[2] = scale * (-dx/d);
+    grads[3] = scale * (-dy/d);
+    if (internal) {
+        grads[4] = (*r1() > *r2()) ? -scale : scale;
+        grads[5] = -grads[4];
+        return scale * (d - std::abs(*r1() - *r2()));
+    }
+    grads[4] = grads[5] = -scale;
+    return scale * (d - (*r1() + *r2()));
+}
+
 // ConstraintPointOnEllipse
 ConstraintPointOnEllipse::ConstraintPointOnEllipse(Point &p, Ellipse &e)
 {
@@ -106,7 +106,7 @@ namespace GCS
 
         inline VEC_pD params() { return pvec; }
 
-        void redirectParams(MAP_pD_pD redirectionmap);
+        void redirectParams(const MAP_pD_pD &redirectionmap);
         void revertParams();
         void setTag(int tagId) { tag = tagId; }
         int getTag() { return tag; }
@@ -118,7 +118,10 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
-        // virtual void grad(MAP_pD_D &deriv);  --> TODO: vectorized grad version
+        // Returns error() and writes the derivative with respect to each entry of pvec
+        // into grads[0..pvec.size()-1]. Entries pointing to the same parameter have to be
+        // summed up by the caller. The default implementation relies on grad().
+        virtual double errorAndGrad(double *grads);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
         // Finds first occurrence of param in pvec. This is useful to test if a constraint depends 
         // on the parameter (it may not actually depend on it, e.g. angle-via-point doesn't depend 
@@ -140,6 +143,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // Difference
@@ -155,6 +159,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // P2PDistance
@@ -175,6 +180,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -197,6 +203,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -220,6 +227,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
         double abs(double darea);
     };
@@ -244,6 +252,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // PointOnPerpBisector
@@ -291,6 +300,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // Perpendicular
@@ -315,6 +325,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // L2LAngle
@@ -341,6 +352,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
         virtual double maxStep(MAP_pD_D &dir, double lim=1.);
     };
 
@@ -366,6 +378,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
 
     // TangentCircumf
@@ -390,6 +403,7 @@ namespace GCS
         virtual void rescale(double coef=1.);
         virtual double error();
         virtual double grad(double *);
+        virtual double errorAndGrad(double *grads);
     };
     // PointOnEllipse
     class ConstraintPointOnEllipse : public Constraint
@@ -51,6 +51,7 @@
 #include <iostream>
 #include <algorithm>
 #include <cfloat>
+#include <cmath>
 #include <limits>
 
 #include "GCS.h"
@@ -106,6 +107,8 @@
 #include <boost/graph/adjacency_list.hpp>
 #include <boost/graph/connected_components.hpp>
 
+#include <QtConcurrentMap>
+
 typedef Eigen::FullPivHouseholderQR<Eigen::MatrixXd>::IntDiagSizeVectorType MatrixIndexType;
 
 #ifndef EIGEN_STOCK_FULLPIVLU_COMPUTE
@@ -422,6 +425,7 @@ System::System()
   , hasUnknowns(false)
   , hasDiagnosis(false)
   , isInit(false)
+  , isDrag(false)
   , maxIter(100)
   , maxIterRedundant(100)
   , sketchSizeMultiplier(false)
@@ -431,6 +435,9 @@ System::System()
   , qrAlgorithm(EigenSparseQR)
   , dogLegGaussStep(FullPivLU)
   , qrpivotThreshold(1E-13)
+  , sparseThreshold(100)
+  , parallelComponents(false)
+  , incrementalDiagnosis(false)
   , debugMode(Minimal)
   , LM_eps(1E-10)
   , LM_eps1(1E-80)
@@ -1374,6 +1381,7 @@ void System::initSolution(Algorithm alg)
     //   system reduction specified in the previous step
 
     isInit = false;
+    isDrag = false;
     if (!hasUnknowns)
         return;
 
@@ -1490,6 +1498,12 @@ void System::initSolution(Algorithm alg)
     isInit = true;
 }
 
+void System::initDrag(Algorithm alg)
+{
+    initSolution(alg);
+    isDrag = isInit;
+}
+
 void System::setReference()
 {
     reference.clear();
@@ -1521,22 +1535,42 @@ int System::solve(bool isFine, Algorithm alg, bool isRedundantsolving)
     if (!isInit)
         return Failed;
 
-    bool isReset = false;
-    // return success by default in order to permit coincidence constraints to be applied
-    // even if no other system has to be solved
-    int res = Success;
+    // components that have anything to solve
+    std::vector<int> cids;
     for (int cid=0; cid < int(subSystems.size()); cid++) {
-        if ((subSystems[cid] || subSystemsAux[cid]) && !isReset) {
-             resetToReference();
-             isReset = true;
-        }
+        if (subSystems[cid] || subSystemsAux[cid])
+            cids.push_back(cid);
+    }
+    if (!cids.empty()) {
+        // while dragging continue from the previous solution, which
+        // becomes the configuration restored by undoSolution
+        if (isDrag)
+            setReference();
+        else
+            resetToReference();
+    }
+
+    // the components share no parameters and no constraints, so they can be solved concurrently
+    VEC_I results(subSystems.size(), Success);
+    auto solveComponent = [&](int &cid) {
         if (subSystems[cid] && subSystemsAux[cid])
-            res = std::max(res, solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving));
+            results[cid] = solve(subSystems[cid], subSystemsAux[cid], isFine, isRedundantsolving);
         else if (subSystems[cid])
-            res = std::max(res, solve(subSystems[cid], isFine, alg, isRedundantsolving));
-        else if (subSystemsAux[cid])
-            res = std::max(res, solve(subSystemsAux[cid], isFine, alg, isRedundantsolving));
-    }
+            results[cid] = solve(subSystems[cid], isFine, alg, isRedundantsolving);
+        else
+            results[cid] = solve(subSystemsAux[cid], isFine, alg, isRedundantsolving);
+    };
+    // the solvers log every iteration at IterationLevel, keep that output readable
+    if (parallelComponents && cids.size() > 1 && debugMode != IterationLevel)
+        QtConcurrent::blockingMap(cids, solveComponent);
+    else
+        std::for_each(cids.begin(), cids.end(), solveComponent);
+
+    // return success by default in order to permit coincidence constraints to be applied
+    // even if no other system has to be solved
+    int res = Success;
+    for (VEC_I::const_iterator it=results.begin(); it != results.end(); ++it)
+        res = std::max(res, *it);
     if (res == Success) {
         for (std::set<Constraint *>::const_iterator constr=redundant.begin();
              constr != redundant.end(); ++constr){
@@ -1700,10 +1734,18 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
     if (xsize == 0)
         return Success;
 
+    // large subsystems have only a few nonzeros per row and are solved with sparse matrices
+    bool sparse = xsize >= sparseThreshold;
+
     Eigen::VectorXd e(csize), e_new(csize); // vector of all function errors (every constraint is one function)
-    Eigen::MatrixXd J(csize, xsize);        // Jacobi of the subsystem
-    Eigen::MatrixXd A(xsize, xsize);
+    Eigen::MatrixXd J;                      // Jacobi of the subsystem
+    Eigen::MatrixXd A;
+    Eigen::SparseMatrix<double> SJ, SA;     // sparse Jacobi and J^T J
     Eigen::VectorXd x(xsize), h(xsize), x_new(xsize), g(xsize), diag_A(xsize);
+    if (!sparse) {
+        J.resize(csize, xsize);
+        A.resize(xsize, xsize);
+    }
 
     subsys->redirectParams();
 
@@ -1728,6 +1770,7 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
                 << ", tau: "            << tau
                 << ", convergence: "    << (isRedundantsolving?convergenceRedundant:convergence)
                 << ", xsize: "          << xsize
+                << ", sparse: "         << (sparse?"true":"false")
                 << ", maxIter: "        << maxIterNumber  << "\n";
 
         const std::string tmp = stream.str();
@@ -1750,14 +1793,23 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         }
 
         // J^T J, J^T e
-        subsys->calcJacobi(J);;
+        if (sparse) {
+            subsys->calcJacobi(SJ);
+
+            SA = Eigen::SparseMatrix<double>(SJ.transpose())*SJ;
+            g = SJ.transpose()*e;
+            diag_A = SA.diagonal();
+        }
+        else {
+            subsys->calcJacobi(J);
 
-        A = J.transpose()*J;
-        g = J.transpose()*e;
+            A = J.transpose()*J;
+            g = J.transpose()*e;
+            diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
+        }
 
         // Compute ||J^T e||_inf
         double g_inf = g.lpNorm<Eigen::Infinity>();
-        diag_A = A.diagonal(); // save diagonal entries so that augmentation can be later canceled
 
         // check for convergence
         if (g_inf <= eps1) {
@@ -1773,13 +1825,23 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
         // determine increment using adaptive damping
         int k=0;
         while (k < 50) {
-            // augment normal equations A = A+uI
-            for (int i=0; i < xsize; ++i)
-                A(i,i) += mu;
+            double rel_error;
+            if (sparse) {
+                // solve augmented functions (A+uI)*h=-g, the symbolic factorization is reused
+                if (subsys->solveNormal(SA, mu, g, h))
+                    rel_error = (SA*h + mu*h - g).norm() / g.norm();
+                else
+                    rel_error = 1.;
+            }
+            else {
+                // augment normal equations A = A+uI
+                for (int i=0; i < xsize; ++i)
+                    A(i,i) += mu;
 
-            //solve augmented functions A*h=-g
-            h = A.fullPivLu().solve(g);
-            double rel_error = (A*h - g).norm() / g.norm();
+                //solve augmented functions A*h=-g
+                h = A.fullPivLu().solve(g);
+                rel_error = (A*h - g).norm() / g.norm();
+            }
 
             // check if solving works
             if (rel_error < 1e-5) {
@@ -1826,8 +1888,10 @@ int System::solve_LM(SubSystem* subsys, bool isRedundantsolving)
 
             mu*=nu;
             nu*=2.0;
-            for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
-                A(i,i) = diag_A(i);
+            if (!sparse) {
+                for (int i=0; i < xsize; ++i) // restore diagonal J^T J entries
+                    A(i,i) = diag_A(i);
+            }
 
             k++;
         }
@@ -1878,6 +1942,10 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         (sketchSizeMultiplierRedundant?maxIterRedundant * xsize:maxIterRedundant):
         (sketchSizeMultiplier?maxIter * xsize:maxIter));
 
+    // large subsystems have only a few nonzeros per row and are solved with sparse matrices.
+    // The sparse factorization gives the least norm step, so the other Gauss steps stay dense.
+    bool sparse = xsize >= sparseThreshold && dogLegGaussStep == LeastNormLdlt;
+
     if(debugMode==IterationLevel) {
         std::stringstream stream;
         stream  << "DL: tolg: "         << tolg
@@ -1887,6 +1955,7 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
                 << ", dogLegGaussStep: " << (dogLegGaussStep==FullPivLU?"FullPivLU":(dogLegGaussStep==LeastNormFullPivLU?"LeastNormFullPivLU":"LeastNormLdlt"))
                 << ", xsize: "          << xsize
                 << ", csize: "          << csize
+                << ", sparse: "         << (sparse?"true":"false")
                 << ", maxIter: "        << maxIterNumber  << "\n";
 
         const std::string tmp = stream.str();
@@ -1895,17 +1964,30 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
 
     Eigen::VectorXd x(xsize), x_new(xsize);
     Eigen::VectorXd fx(csize), fx_new(csize);
-    Eigen::MatrixXd Jx(csize, xsize), Jx_new(csize, xsize);
+    Eigen::MatrixXd Jx, Jx_new;
+    Eigen::SparseMatrix<double> SJx, SJx_new;
     Eigen::VectorXd g(xsize), h_sd(xsize), h_gn(xsize), h_dl(xsize);
 
+    // products with the dense or sparse Jacobi
+    auto jacobiTimes = [&](const Eigen::VectorXd &v) -> Eigen::VectorXd {
+        return sparse ? Eigen::VectorXd(SJx*v) : Eigen::VectorXd(Jx*v);
+    };
+    auto jacobiTransposeTimes = [&](const Eigen::VectorXd &v) -> Eigen::VectorXd {
+        return sparse ? Eigen::VectorXd(SJx.transpose()*v) : Eigen::VectorXd(Jx.transpose()*v);
+    };
+
     subsys->redirectParams();
 
     double err;
     subsys->getParams(x);
-    subsys->calcResidual(fx, err);
-    subsys->calcJacobi(Jx);
+    if (sparse)
+        subsys->calcResidualJacobi(fx, err, SJx);
+    else {
+        subsys->calcResidual(fx, err);
+        subsys->calcJacobi(Jx);
+    }
 
-    g = Jx.transpose()*(-fx);
+    g = jacobiTransposeTimes(-fx);
 
     // get the infinity norm fx_inf and g_inf
     double g_inf = g.lpNorm<Eigen::Infinity>();
@@ -1933,25 +2015,36 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         }
         else {
             // get the steepest descent direction
-            alpha = g.squaredNorm()/(Jx*g).squaredNorm();
+            alpha = g.squaredNorm()/jacobiTimes(g).squaredNorm();
             h_sd  = alpha*g;
 
             // get the gauss-newton step
             // http://forum.freecadweb.org/viewtopic.php?f=10&t=12769&start=50#p106220
             // https://forum.kde.org/viewtopic.php?f=74&t=129439#p346104
-            switch (dogLegGaussStep){
-                case FullPivLU:
-                    h_gn = Jx.fullPivLu().solve(-fx);
-                    break;
-                case LeastNormFullPivLU:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
-                    break;
-                case LeastNormLdlt:
-                    h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
-                    break;
+            if (sparse) {
+                // the LeastNormLdlt step with a sparse factorization, the dense
+                // decomposition is only used if the factorization fails
+                Eigen::VectorXd b = -fx;
+                if (!subsys->solveLeastNorm(SJx, b, h_gn)) {
+                    Eigen::MatrixXd J(SJx);
+                    h_gn = J.adjoint()*(J*J.adjoint()).ldlt().solve(b);
+                }
+            }
+            else {
+                switch (dogLegGaussStep){
+                    case FullPivLU:
+                        h_gn = Jx.fullPivLu().solve(-fx);
+                        break;
+                    case LeastNormFullPivLU:
+                        h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).fullPivLu().solve(-fx);
+                        break;
+                    case LeastNormLdlt:
+                        h_gn = Jx.adjoint()*(Jx*Jx.adjoint()).ldlt().solve(-fx);
+                        break;
+                }
             }
 
-            double rel_error = (Jx*h_gn + fx).norm() / fx.norm();
+            double rel_error = (jacobiTimes(h_gn) + fx).norm() / fx.norm();
             if (rel_error > 1e15)
                 break;
 
@@ -1998,21 +2091,28 @@ int System::solve_DL(SubSystem* subsys, bool isRedundantsolving)
         double err_new;
         x_new = x + h_dl;
         subsys->setParams(x_new);
-        subsys->calcResidual(fx_new, err_new);
-        subsys->calcJacobi(Jx_new);
+        if (sparse)
+            subsys->calcResidualJacobi(fx_new, err_new, SJx_new);
+        else {
+            subsys->calcResidual(fx_new, err_new);
+            subsys->calcJacobi(Jx_new);
+        }
 
         // calculate the linear model and the update ratio
-        double dL = err - 0.5*(fx + Jx*h_dl).squaredNorm();
+        double dL = err - 0.5*(fx + jacobiTimes(h_dl)).squaredNorm();
         double dF = err - err_new;
         double rho = dL/dF;
 
         if (dF > 0 && dL > 0) {
             x  = x_new;
-            Jx = Jx_new;
+            if (sparse)
+                SJx.swap(SJx_new);
+            else
+                Jx.swap(Jx_new);
             fx = fx_new;
             err = err_new;
 
-            g = Jx.transpose()*(-fx);
+            g = jacobiTransposeTimes(-fx);
 
             // get infinity norms
             g_inf = g.lpNorm<Eigen::Infinity>();
@@ -3619,6 +3719,11 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
     }
     int xsize = plistAB.size();
 
+    // while dragging a large sketch the factorization of the sparse solver is reused between the
+    // solves. The other solves keep the BFGS update of the dense solver, which converges more reliably.
+    if (isDrag && xsize >= sparseThreshold)
+        return solve_sparseSQP(subsysA, subsysB, plistAB, isRedundantsolving);
+
     Eigen::MatrixXd B = Eigen::MatrixXd::Identity(xsize, xsize);
     Eigen::MatrixXd JA(csizeA, xsize);
     Eigen::MatrixXd Y,Z;
@@ -3761,6 +3866,108 @@ int System::solve(SubSystem *subsysA, SubSystem *subsysB, bool /*isFine*/, bool
 
 }
 
+// Sparse variant of the SQP solver above for dragging large sketches. Instead of the dense
+// BFGS approximation the Hessian is approximated by the diagonal of the Gauss-Newton
+// Hessian of subsysB, so that every step is the solution of a sparse KKT system.
+// Its pattern does not change, thus the symbolic factorization is reused for all
+// iterations and for all the solves of the drag.
+int System::solve_sparseSQP(SubSystem *subsysA, SubSystem *subsysB, VEC_pD &plistAB, bool isRedundantsolving)
+{
+    int xsize = plistAB.size();
+    int csizeA = subsysA->cSize();
+
+    Eigen::SparseMatrix<double> JA, JB;
+    Eigen::VectorXd resA(csizeA);
+    Eigen::VectorXd x(xsize), x0(xsize), xdir(xsize), h(xsize);
+    Eigen::VectorXd grad(xsize), H(xsize);
+
+    // We assume that there are no common constraints in subsysA and subsysB
+    subsysA->redirectParams();
+    subsysB->redirectParams();
+
+    subsysB->getParams(plistAB,x);
+    subsysA->getParams(plistAB,x);
+    subsysB->setParams(plistAB,x);  // just to ensure that A and B are synchronized
+
+    int maxIterNumber = (isRedundantsolving?
+        (sketchSizeMultiplierRedundant?maxIterRedundant * xsize:maxIterRedundant):
+        (sketchSizeMultiplier?maxIter * xsize:maxIter));
+
+    double divergingLim = 1e6*subsysA->error() + 1e12;
+
+    double mu = 0;
+    h.setZero();
+    for (int iter=1; iter < maxIterNumber; iter++) {
+        subsysB->calcGrad(plistAB,grad);
+        subsysB->calcJacobi(plistAB,JB);
+        subsysA->calcJacobi(plistAB,JA);
+        subsysA->calcResidual(resA);
+
+        // the small regularization keeps the parameters that subsysB does
+        // not depend on close to their current values
+        H = (Eigen::RowVectorXd::Ones(JB.rows()) * JB.cwiseAbs2()).transpose();
+        H.array() += 1e-6;
+
+        if (!subsysA->solveKKT(JA, H, grad, resA, xdir))
+            break;
+
+        x0 = x;
+
+        // line search on the merit function as in the dense solver
+        {
+            double eta=0.25;
+            double tau=0.5;
+            double rho=0.5;
+            double alpha = std::min(1., subsysA->maxStep(plistAB,xdir));
+
+            double resA_norm = resA.lpNorm<1>();
+            if (resA_norm > 0)
+                mu = std::max(mu,
+                              (grad.dot(xdir) + std::max(0., 0.5*xdir.dot(H.cwiseProduct(xdir)))) /
+                              ( (1. - rho) * resA_norm ) );
+
+            double f0 = subsysB->error() + mu * resA_norm;
+            double deriv = grad.dot(xdir) - mu * resA_norm;
+
+            while (true) {
+                x = x0 + alpha * xdir;
+                subsysA->setParams(plistAB,x);
+                subsysB->setParams(plistAB,x);
+                subsysA->calcResidual(resA);
+                double f = subsysB->error() + mu * resA.lpNorm<1>();
+                if (f <= f0 + eta * alpha * deriv)
+                    break;
+                alpha = tau * alpha;
+                if (alpha < 1e-8) { // let the linesearch fail
+                    x = x0;
+                    subsysA->setParams(plistAB,x);
+                    subsysB->setParams(plistAB,x);
+                    break;
+                }
+            }
+        }
+        h = x - x0;
+
+        double err = subsysA->error();
+        if (h.norm() <= (isRedundantsolving?convergenceRedundant:convergence) && err <= smallF)
+            break;
+        if (err > divergingLim || err != err) // check for diverging and NaN
+            break;
+    }
+
+    int ret;
+    if (subsysA->error() <= smallF)
+        ret = Success;
+    else if (h.norm() <= (isRedundantsolving?convergenceRedundant:convergence))
+        ret = Converged;
+    else
+        ret = Failed;
+
+    subsysA->revertParams();
+    subsysB->revertParams();
+    return ret;
+}
+
 void System::applySolution()
 {
     for (int cid=0; cid < int(subSystems.size()); cid++) {
@@ -3781,38 +3988,35 @@ void System::undoSolution()
 
 void System::makeReducedJacobian(Eigen::MatrixXd &J,
                                  std::map<int,int> &jacobianconstraintmap,
-                                 GCS::VEC_pD &pdiagnoselist,
-                                 std::map< int , int> &tagmultiplicity)
+                                 const std::vector<Constraint *> &clistC,
+                                 const GCS::VEC_pD &pdiagnoselist)
 {
-    // construct specific parameter list for diagonose ignoring driven constraint parameters
-    for (int j=0; j < int(plist.size()); j++) {
-        auto result1 = std::find(std::begin(pdrivenlist), std::end(pdrivenlist), plist[j]);
+    MAP_pD_I pdiagnoseindex;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        pdiagnoseindex[pdiagnoselist[j]] = j;
 
-        if (result1 == std::end(pdrivenlist)) {
-            pdiagnoselist.push_back(plist[j]);
-        }
+    int jacobianconstraintcount=0;
+    for (std::vector<Constraint *>::const_iterator constr=clistC.begin(); constr != clistC.end(); ++constr) {
+        if ((*constr)->getTag() >= 0 && (*constr)->isDriving())
+            jacobianconstraintcount++;
     }
 
+    J = Eigen::MatrixXd::Zero(jacobianconstraintcount, pdiagnoselist.size());
 
-    J = Eigen::MatrixXd::Zero(clist.size(), pdiagnoselist.size());
-
-    int jacobianconstraintcount=0;
+    jacobianconstraintcount=0;
     int allcount=0;
-    for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
-        (*constr)->revertParams();
+    for (std::vector<Constraint *>::const_iterator constr=clistC.begin(); constr != clistC.end(); ++constr) {
         ++allcount;
         if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
             jacobianconstraintcount++;
-            for (int j=0; j < int(pdiagnoselist.size()); j++) {
-                J(jacobianconstraintcount-1,j) = (*constr)->grad(pdiagnoselist[j]);
+            // only the parameters of the constraint have a nonzero derivative
+            VEC_pD cparams = (*constr)->params();
+            for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+                MAP_pD_I::const_iterator it = pdiagnoseindex.find(*param);
+                if (it != pdiagnoseindex.end())
+                    J(jacobianconstraintcount-1,it->second) = (*constr)->grad(*param);
             }
 
-            // parallel processing: create tag multiplicity map
-            if(tagmultiplicity.find((*constr)->getTag()) == tagmultiplicity.end())
-                tagmultiplicity[(*constr)->getTag()] = 0;
-            else
-                tagmultiplicity[(*constr)->getTag()]++;
-
             jacobianconstraintmap[jacobianconstraintcount-1] = allcount-1;
         }
     }
@@ -3862,23 +4066,345 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     //
     // reduced Jacobian matrix
     // The Jacobian has been reduced to:
-    // 1. only contain driving constraints, but keep a full size (zero padded).
+    // 1. only contain driving constraints.
     // 2. remove the parameters of the values of driven constraints.
-    Eigen::MatrixXd J;
+    //
+    // As the Jacobian of decoupled components is block diagonal, each component can be diagnosed
+    // on its own block (see parallelComponents). Otherwise the whole system is one component.
 
-    // maps the index of the rows of the reduced jacobian matrix (solver constraints) to
-    // the index those constraints would have in a full size Jacobian matrix
-    std::map<int,int> jacobianconstraintmap;
+#ifndef EIGEN_SPARSEQR_COMPATIBLE
+    if(qrAlgorithm==EigenSparseQR){
+        Base::Console().Warning("SparseQR not supported by you current version of Eigen. It requires Eigen 3.2.2 or higher. Falling back to Dense QR\n");
+        qrAlgorithm=EigenDenseQR;
+    }
+#endif
 
     // list of parameters to be diagnosed in this routine (removes value parameters from driven constraints)
     GCS::VEC_pD pdiagnoselist;
+    SET_pD pdrivenset(pdrivenlist.begin(), pdrivenlist.end());
+    for (int j=0; j < int(plist.size()); j++) {
+        if (pdrivenset.count(plist[j]) == 0)
+            pdiagnoselist.push_back(plist[j]);
+    }
 
     // tag multiplicity gives the number of solver constraints associated with the same tag
     // A tag generally corresponds to the Sketcher constraint index - There are special tag values, like 0 and -1.
     std::map< int , int> tagmultiplicity;
 
+    for (std::vector<Constraint *>::iterator constr=clist.begin(); constr != clist.end(); ++constr) {
+        (*constr)->revertParams();
+        if ((*constr)->getTag() >= 0 && (*constr)->isDriving()) {
+            // parallel processing: create tag multiplicity map
+            if(tagmultiplicity.find((*constr)->getTag()) == tagmultiplicity.end())
+                tagmultiplicity[(*constr)->getTag()] = 0;
+            else
+                tagmultiplicity[(*constr)->getTag()]++;
+        }
+    }
+
+    if (clist.empty()) {
+        hasDiagnosis = true;
+        dofs = pdiagnoselist.size();
+        return dofs;
+    }
+
+    std::vector<ComponentDiagnosis> components;
+    if (parallelComponents || incrementalDiagnosis) {
+        // partitioning into decoupled components of driving constraints and diagnosed parameters
+        MAP_pD_I pdiagnoseindex;
+        for (int j=0; j < int(pdiagnoselist.size()); j++)
+            pdiagnoseindex[pdiagnoselist[j]] = j;
+
+        Graph g;
+        for (int i=0; i < int(pdiagnoselist.size() + clist.size()); i++)
+            boost::add_vertex(g);
+
+        int cvtid = int(pdiagnoselist.size());
+        for (std::vector<Constraint *>::const_iterator constr=clist.begin();
+             constr != clist.end(); ++constr, cvtid++) {
+            if (!(*constr)->isDriving())
+                continue;
+            VEC_pD &cparams = c2p[*constr];
+            for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+                MAP_pD_I::const_iterator it = pdiagnoseindex.find(*param);
+                if (it != pdiagnoseindex.end())
+                    boost::add_edge(cvtid, it->second, g);
+            }
+        }
+
+        VEC_I componentIds(boost::num_vertices(g));
+        int componentsSize = boost::connected_components(g, &componentIds[0]);
+
+        // the order of parameters and constraints inside a component follows plist and clist
+        components.resize(componentsSize);
+        for (int j=0; j < int(pdiagnoselist.size()); j++)
+            components[componentIds[j]].params.push_back(pdiagnoselist[j]);
+        cvtid = int(pdiagnoselist.size());
+        for (std::vector<Constraint *>::const_iterator constr=clist.begin();
+             constr != clist.end(); ++constr, cvtid++) {
+            if ((*constr)->isDriving())
+                components[componentIds[cvtid]].constraints.push_back(*constr);
+        }
+    }
+    else {
+        components.resize(1);
+        components[0].params = pdiagnoselist;
+        components[0].constraints = clist;
+    }
+
+    // only the components that changed since the last diagnosis are diagnosed again. This is a
+    // cache of whole components, the factorization of a changed component is not updated but redone.
+    std::vector<ComponentKey> keys(components.size());
+    std::vector<ComponentDiagnosis *> changed;
+    for (std::size_t i=0; i < components.size(); i++) {
+        if (incrementalDiagnosis && makeComponentKey(alg, tagmultiplicity, components[i], keys[i])) {
+            std::map<ComponentKey, CachedDiagnosis>::const_iterator it = diagnosisCache.find(keys[i]);
+            if (it != diagnosisCache.end()) {
+                restoreDiagnosis(it->second, components[i]);
+                continue;
+            }
+        }
+        changed.push_back(&components[i]);
+    }
+
+    auto diagnoseOne = [this, alg, &tagmultiplicity](ComponentDiagnosis *&component) {
+        diagnoseComponent(alg, tagmultiplicity, *component);
+    };
+    // the solvers log every iteration at IterationLevel, keep that output readable
+    if (parallelComponents && changed.size() > 1 && debugMode != IterationLevel)
+        QtConcurrent::blockingMap(changed, diagnoseOne);
+    else
+        std::for_each(changed.begin(), changed.end(), diagnoseOne);
+
+    // the cache only keeps the components of this diagnosis
+    if (incrementalDiagnosis) {
+        std::map<ComponentKey, CachedDiagnosis> cache;
+        for (std::size_t i=0; i < components.size(); i++) {
+            if (!keys[i].first.empty())
+                storeDiagnosis(components[i], cache[keys[i]]);
+        }
+        diagnosisCache.swap(cache);
+    }
+
+    // merge the results of the components, which are independent of the order of evaluation
+    int paramsNum = int(pdiagnoselist.size());
+    int constrNum = 0;
+    int rank = 0;
+    int redundantGroups = 0;
+    bool redundantSolving = false;
+    std::vector< std::vector<Constraint *> > conflictGroups;
+    std::map<int, double *> dependent;
+    MAP_pD_I pdiagnoseindex;
+    for (int j=0; j < int(pdiagnoselist.size()); j++)
+        pdiagnoseindex[pdiagnoselist[j]] = j;
+
+    for (std::vector<ComponentDiagnosis>::const_iterator component=components.begin();
+         component != components.end(); ++component) {
+        constrNum += component->constrNum;
+        rank += component->rank;
+        redundantGroups += component->redundantGroups;
+        redundantSolving = redundantSolving || component->redundantSolving;
+        conflictGroups.insert(conflictGroups.end(), component->conflictGroups.begin(),
+                                                    component->conflictGroups.end());
+        redundant.insert(component->redundant.begin(), component->redundant.end());
+        for (VEC_pD::const_iterator param=component->dependentParams.begin();
+             param != component->dependentParams.end(); ++param)
+            dependent[pdiagnoseindex[*param]] = *param;
+    }
+
+    // keep the dependent parameters in the order of the columns of the Jacobian
+    for (std::map<int, double *>::const_iterator it=dependent.begin(); it != dependent.end(); ++it)
+        pdependentparameters.push_back(it->second);
+
+    if(debugMode==IterationLevel) {
+        SolverReportingManager::Manager().LogQRSystemInformation(*this, paramsNum, constrNum, rank);
+    }
+
+    if (constrNum > rank) { // conflicting or redundant constraints
+        if (redundantSolving && (debugMode==Minimal || debugMode==IterationLevel)) {
+            std::string solvername;
+            switch (alg) {
+                case 0:
+                    solvername = "BFGS";
+                    break;
+                case 1: // solving with the LevenbergMarquardt solver
+                    solvername = "LevenbergMarquardt";
+                    break;
+                case 2: // solving with the BFGS solver
+                    solvername = "DogLeg";
+                    break;
+            }
+
+            Base::Console().Log("Sketcher::RedundantSolving-%s-\n",solvername.c_str());
+            Base::Console().Log("Sketcher Redundant solving: %d redundants\n",redundant.size());
+        }
+
+        constrNum -= redundantGroups;
+
+        // simplified output of conflicting tags
+        SET_I conflictingTagsSet;
+        for (std::size_t i=0; i < conflictGroups.size(); i++) {
+            for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
+                conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
+            }
+        }
+        conflictingTagsSet.erase(0); // exclude constraints tagged with zero
+        conflictingTags.resize(conflictingTagsSet.size());
+        std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
+                  conflictingTags.begin());
+
+        // output of redundant tags
+        SET_I redundantTagsSet;
+        for (std::set<Constraint *>::iterator constr=redundant.begin();
+             constr != redundant.end(); ++constr)
+            redundantTagsSet.insert((*constr)->getTag());
+        // remove tags represented at least in one non-redundant constraint
+        for (std::vector<Constraint *>::iterator constr=clist.begin();
+            constr != clist.end(); ++constr) {
+            if (redundant.count(*constr) == 0)
+                redundantTagsSet.erase((*constr)->getTag());
+        }
+        redundantTags.resize(redundantTagsSet.size());
+        std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
+                  redundantTags.begin());
+
+        if (paramsNum == rank && constrNum > rank) { // over-constrained
+            hasDiagnosis = true;
+            dofs = paramsNum - constrNum;
+            return dofs;
+        }
+    }
+
+    hasDiagnosis = true;
+    dofs = paramsNum - rank;
+    return dofs;
+}
+
+bool System::makeComponentKey(Algorithm alg, const std::map<int,int> &tagmultiplicity,
+                              const ComponentDiagnosis &component, ComponentKey &key) const
+{
+    // The diagnosis of a component is determined by the solver settings, the types, tags and
+    // parameters of its constraints and the values of all these parameters. The errors of the
+    // constraints stand for any additional state of a constraint.
+    VEC_I &structure = key.first;
+    VEC_D &values = key.second;
+    structure.push_back(alg);
+    structure.push_back(qrAlgorithm);
+    structure.push_back(maxIterRedundant);
+    structure.push_back(sketchSizeMultiplierRedundant);
+    values.push_back(qrpivotThreshold);
+    values.push_back(convergenceRedundant);
+
+    MAP_pD_I index;
+    structure.push_back(int(component.params.size()));
+    for (int j=0; j < int(component.params.size()); j++) {
+        index[component.params[j]] = j;
+        values.push_back(*component.params[j]);
+    }
+
+    for (std::vector<Constraint *>::const_iterator constr=component.constraints.begin();
+         constr != component.constraints.end(); ++constr) {
+        structure.push_back((*constr)->getTypeId());
+        structure.push_back((*constr)->getTag());
+        structure.push_back((*constr)->isDriving());
+        std::map<int,int>::const_iterator multiplicity = tagmultiplicity.find((*constr)->getTag());
+        structure.push_back(multiplicity != tagmultiplicity.end() ? multiplicity->second : -1);
+
+        VEC_pD cparams = (*constr)->params();
+        structure.push_back(int(cparams.size()));
+        for (VEC_pD::const_iterator param=cparams.begin(); param != cparams.end(); ++param) {
+            MAP_pD_I::const_iterator it = index.find(*param);
+            if (it != index.end())
+                structure.push_back(it->second);
+            else { // a value that is not diagnosed, e.g. the datum of the constraint
+                structure.push_back(-1);
+                values.push_back(**param);
+            }
+        }
+        values.push_back((*constr)->error());
+    }
+
+    // NaN cannot be ordered, such a component is not cached
+    for (VEC_D::const_iterator value=values.begin(); value != values.end(); ++value) {
+        if (std::isnan(*value)) {
+            structure.clear();
+            values.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void System::storeDiagnosis(const ComponentDiagnosis &component, CachedDiagnosis &cached) const
+{
+    MAP_pD_I paramIndex;
+    for (int j=0; j < int(component.params.size()); j++)
+        paramIndex[component.params[j]] = j;
+    std::map<Constraint *, int> constrIndex;
+    for (int i=0; i < int(component.constraints.size()); i++)
+        constrIndex[component.constraints[i]] = i;
+
+    cached.constrNum = component.constrNum;
+    cached.rank = component.rank;
+    cached.redundantGroups = component.redundantGroups;
+    cached.redundantSolving = component.redundantSolving;
+    for (VEC_pD::const_iterator param=component.dependentParams.begin();
+         param != component.dependentParams.end(); ++param)
+        cached.dependentParams.push_back(paramIndex[*param]);
+    for (std::size_t i=0; i < component.conflictGroups.size(); i++) {
+        cached.conflictGroups.push_back(VEC_I());
+        for (std::size_t j=0; j < component.conflictGroups[i].size(); j++)
+            cached.conflictGroups.back().push_back(constrIndex[component.conflictGroups[i][j]]);
+    }
+    for (std::set<Constraint *>::const_iterator constr=component.redundant.begin();
+         constr != component.redundant.end(); ++constr)
+        cached.redundant.push_back(constrIndex[*constr]);
+}
+
+void System::restoreDiagnosis(const CachedDiagnosis &cached, ComponentDiagnosis &component) const
+{
+    component.constrNum = cached.constrNum;
+    component.rank = cached.rank;
+    component.redundantGroups = cached.redundantGroups;
+    component.redundantSolving = cached.redundantSolving;
+    for (VEC_I::const_iterator j=cached.dependentParams.begin(); j != cached.dependentParams.end(); ++j)
+        component.dependentParams.push_back(component.params[*j]);
+    for (std::size_t i=0; i < cached.conflictGroups.size(); i++) {
+        component.conflictGroups.push_back(std::vector<Constraint *>());
+        for (std::size_t j=0; j < cached.conflictGroups[i].size(); j++)
+            component.conflictGroups.back().push_back(component.constraints[cached.conflictGroups[i][j]]);
+    }
+    for (VEC_I::const_iterator i=cached.redundant.begin(); i != cached.redundant.end(); ++i)
+        component.redundant.insert(component.constraints[*i]);
+}
+
+void System::diagnoseComponent(Algorithm alg, const std::map<int,int> &tagmultiplicity,
+                               ComponentDiagnosis &component)
+{
+    // Diagnoses the driving constraints and the parameters of one decoupled component, see diagnose()
+    component.rank = 0;
+    component.constrNum = 0;
+    component.redundantGroups = 0;
+    component.redundantSolving = false;
+
+    // reduced Jacobian matrix of the component
+    Eigen::MatrixXd J;
+
+    // maps the index of the rows of the reduced jacobian matrix (solver constraints) to
+    // the index those constraints have in the constraints of the component
+    std::map<int,int> jacobianconstraintmap;
 
-    makeReducedJacobian(J, jacobianconstraintmap, pdiagnoselist, tagmultiplicity);
+    // list of parameters to be diagnosed
+    GCS::VEC_pD &pdiagnoselist = component.params;
+    std::vector<Constraint *> &clistC = component.constraints;
+
+    makeReducedJacobian(J, jacobianconstraintmap, clistC, pdiagnoselist);
+
+    // without driving constraints with tag >= 0 every parameter is free
+    if (J.rows() == 0) {
+        component.dependentParams = pdiagnoselist;
+        return;
+    }
 
     // QR decomposition method selection: SparseQR vs DenseQR
 
@@ -3894,11 +4420,6 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     }
 
     Eigen::SparseQR<Eigen::SparseMatrix<double>, Eigen::COLAMDOrdering<int> > SqrJT;
-#else
-    if(qrAlgorithm==EigenSparseQR){
-        Base::Console().Warning("SparseQR not supported by you current version of Eigen. It requires Eigen 3.2.2 or higher. Falling back to Dense QR\n");
-        qrAlgorithm=EigenDenseQR;
-    }
 #endif
 
 
@@ -3979,9 +4500,8 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
     }
 #endif
 
-    if(debugMode==IterationLevel) {
-        SolverReportingManager::Manager().LogQRSystemInformation(*this, paramsNum, constrNum, rank);
-    }
+    component.constrNum = constrNum;
+    component.rank = rank;
 
     if (J.rows() > 0) {
 #ifdef _GCS_DEBUG_SOLVER_JACOBIAN_QR_DECOMPOSITION_TRIANGULAR_MATRIX
@@ -4106,7 +4626,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
         SolverReportingManager::Manager().LogString(tmp);
 #endif
         for( auto param : depParamCols) {
-            pdependentparameters.push_back(pdiagnoselist[param]);
+            component.dependentParams.push_back(pdiagnoselist[param]);
         }
 
         // Detecting conflicting or redundant constraints
@@ -4135,7 +4655,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
                             origCol=SqrJT.colsPermutation().indices()[row];
 #endif
                         //conflictGroups[j-rank].push_back(clist[origCol]);
-                        conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+                        conflictGroups[j-rank].push_back(clistC[jacobianconstraintmap.at(origCol)]);
                     }
                 }
                 int origCol = 0;
@@ -4148,7 +4668,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
                     origCol=SqrJT.colsPermutation().indices()[j];
 #endif
                 //conflictGroups[j-rank].push_back(clist[origCol]);
-                conflictGroups[j-rank].push_back(clist[jacobianconstraintmap.at(origCol)]);
+                conflictGroups[j-rank].push_back(clistC[jacobianconstraintmap.at(origCol)]);
             }
 
             // Augment the information regarding the group of constraints that are conflicting or redundant.
@@ -4201,9 +4721,9 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
             }
 
             std::vector<Constraint *> clistTmp;
-            clistTmp.reserve(clist.size());
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                constr != clist.end(); ++constr) {
+            clistTmp.reserve(clistC.size());
+            for (std::vector<Constraint *>::iterator constr=clistC.begin();
+                constr != clistC.end(); ++constr) {
                 if ((*constr)->isDriving() && skipped.count(*constr) == 0)
                     clistTmp.push_back(*constr);
             }
@@ -4211,22 +4731,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
             SubSystem *subSysTmp = new SubSystem(clistTmp, pdiagnoselist);
             int res = solve(subSysTmp,true,alg,true);
 
-            if(debugMode==Minimal || debugMode==IterationLevel) {
-                std::string solvername;
-                switch (alg) {
-                    case 0:
-                        solvername = "BFGS";
-                        break;
-                    case 1: // solving with the LevenbergMarquardt solver
-                        solvername = "LevenbergMarquardt";
-                        break;
-                    case 2: // solving with the BFGS solver
-                        solvername = "DogLeg";
-                        break;
-                }
-
-                Base::Console().Log("Sketcher::RedundantSolving-%s-\n",solvername.c_str());
-            }
+            component.redundantSolving = true;
 
             if (res == Success) {
                 subSysTmp->applySolution();
@@ -4234,12 +4739,13 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
                      constr != skipped.end(); ++constr) {
                     double err = (*constr)->error();
                     if (err * err < convergenceRedundant)
-                        redundant.insert(*constr);
+                        component.redundant.insert(*constr);
                 }
-                resetToReference();
-
-                if(debugMode==Minimal || debugMode==IterationLevel) {
-                    Base::Console().Log("Sketcher Redundant solving: %d redundants\n",redundant.size());
+                // only the parameters of this component are reverted to the reference
+                if (reference.size() == plist.size()) {
+                    for (VEC_pD::const_iterator param=pdiagnoselist.begin();
+                         param != pdiagnoselist.end(); ++param)
+                        **param = reference[pIndex.find(*param)->second];
                 }
 
                 std::vector< std::vector<Constraint *> > conflictGroupsOrig=conflictGroups;
@@ -4247,7 +4753,7 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
                 for (int i=conflictGroupsOrig.size()-1; i >= 0; i--) {
                     bool isRedundant = false;
                     for (std::size_t j=0; j < conflictGroupsOrig[i].size(); j++) {
-                        if (redundant.count(conflictGroupsOrig[i][j]) > 0) {
+                        if (component.redundant.count(conflictGroupsOrig[i][j]) > 0) {
                             isRedundant = true;
 
                             if(debugMode==IterationLevel) {
@@ -4260,53 +4766,14 @@ SolverReportingManager::Manager().LogToFile("GCS::System::diagnose()\n");
                     if (!isRedundant)
                         conflictGroups.push_back(conflictGroupsOrig[i]);
                     else
-                        constrNum--;
+                        component.redundantGroups++;
                 }
             }
             delete subSysTmp;
 
-            // simplified output of conflicting tags
-            SET_I conflictingTagsSet;
-            for (std::size_t i=0; i < conflictGroups.size(); i++) {
-                for (std::size_t j=0; j < conflictGroups[i].size(); j++) {
-                    conflictingTagsSet.insert(conflictGroups[i][j]->getTag());
-                }
-            }
-            conflictingTagsSet.erase(0); // exclude constraints tagged with zero
-            conflictingTags.resize(conflictingTagsSet.size());
-            std::copy(conflictingTagsSet.begin(), conflictingTagsSet.end(),
-                      conflictingTags.begin());
-
-            // output of redundant tags
-            SET_I redundantTagsSet;
-            for (std::set<Constraint *>::iterator constr=redundant.begin();
-                 constr != redundant.end(); ++constr)
-                redundantTagsSet.insert((*constr)->getTag());
-            // remove tags represented at least in one non-redundant constraint
-            for (std::vector<Constraint *>::iterator constr=clist.begin();
-                constr != clist.end(); ++constr) {
-                if (redundant.count(*constr) == 0)
-                    redundantTagsSet.erase((*constr)->getTag());
-            }
-            redundantTags.resize(redundantTagsSet.size());
-            std::copy(redundantTagsSet.begin(), redundantTagsSet.end(),
-                      redundantTags.begin());
-
-            if (paramsNum == rank && constrNum > rank) { // over-constrained
-                hasDiagnosis = true;
-                dofs = paramsNum - constrNum;
-                return dofs;
-            }
+            component.conflictGroups = conflictGroups;
         }
-
-        hasDiagnosis = true;
-        dofs = paramsNum - rank;
-        return dofs;
     }
-
-    hasDiagnosis = true;
-    dofs = pdiagnoselist.size();
-    return dofs;
 }
 
 void System::clearSubSystems()
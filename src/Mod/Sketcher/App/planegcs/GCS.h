@@ -102,12 +102,47 @@ namespace GCS
         bool hasUnknowns;  // if plist is filled with the unknown parameters
         bool hasDiagnosis; // if dofs, conflictingTags, redundantTags are up to date
         bool isInit;       // if plists, clists, reductionmaps are up to date
+        bool isDrag;       // if the solves continue from the previous solution (see initDrag)
 
         int solve_BFGS(SubSystem *subsys, bool isFine=true, bool isRedundantsolving=false);
         int solve_LM(SubSystem *subsys, bool isRedundantsolving=false);
         int solve_DL(SubSystem *subsys, bool isRedundantsolving=false);
-
-        void makeReducedJacobian(Eigen::MatrixXd &J, std::map<int,int> &jacobianconstraintmap, GCS::VEC_pD &pdiagnoselist, std::map< int , int> &tagmultiplicity);
+        int solve_sparseSQP(SubSystem *subsysA, SubSystem *subsysB, VEC_pD &plistAB, bool isRedundantsolving=false);
+
+        void makeReducedJacobian(Eigen::MatrixXd &J, std::map<int,int> &jacobianconstraintmap,
+                                 const std::vector<Constraint *> &clistC, const GCS::VEC_pD &pdiagnoselist);
+
+        // diagnosis of one decoupled component of the system
+        struct ComponentDiagnosis {
+            VEC_pD params;                            // diagnosed parameters of the component
+            std::vector<Constraint *> constraints;    // constraints of the component
+            int constrNum;                            // number of driving constraints
+            int rank;                                 // rank of the reduced Jacobian
+            int redundantGroups;                      // conflict groups found to be only redundant
+            bool redundantSolving;                    // if the redundant constraints had to be solved
+            VEC_pD dependentParams;
+            std::vector< std::vector<Constraint *> > conflictGroups;
+            std::set<Constraint *> redundant;
+        };
+        void diagnoseComponent(Algorithm alg, const std::map<int,int> &tagmultiplicity,
+                               ComponentDiagnosis &component);
+
+        // diagnosis of a component in terms of the indices of its parameters and constraints
+        struct CachedDiagnosis {
+            int constrNum;
+            int rank;
+            int redundantGroups;
+            bool redundantSolving;
+            VEC_I dependentParams;
+            std::vector<VEC_I> conflictGroups;
+            VEC_I redundant;
+        };
+        typedef std::pair<VEC_I, VEC_D> ComponentKey;
+        std::map<ComponentKey, CachedDiagnosis> diagnosisCache; // component-level cache of the last call of diagnose
+        bool makeComponentKey(Algorithm alg, const std::map<int,int> &tagmultiplicity,
+                              const ComponentDiagnosis &component, ComponentKey &key) const;
+        void storeDiagnosis(const ComponentDiagnosis &component, CachedDiagnosis &cached) const;
+        void restoreDiagnosis(const CachedDiagnosis &cached, ComponentDiagnosis &component) const;
 
         #ifdef _GCS_EXTRACT_SOLVER_SUBSYSTEM_
         void extractSubsystem(SubSystem *subsys, bool isRedundantsolving);
@@ -122,6 +157,10 @@ namespace GCS
         QRAlgorithm qrAlgorithm;
         DogLegGaussStep dogLegGaussStep;
         double qrpivotThreshold;
+        int sparseThreshold; // subsystems with at least this many parameters are solved with sparse matrices
+        bool parallelComponents; // if decoupled components are solved and diagnosed concurrently
+        bool incrementalDiagnosis; // if the diagnosis of components whose constraints did not change is reused,
+                                   // a changed component is factorized again as a whole
         DebugMode debugMode;
         double LM_eps;
         double LM_eps1;
@@ -259,6 +298,11 @@ namespace GCS
         void declareUnknowns(VEC_pD &params);
         void declareDrivenParams(VEC_pD &params);
         void initSolution(Algorithm alg=DogLeg);
+        // Like initSolution, but the following solves start from the current parameter values
+        // instead of the reference configuration. Used while dragging, where every solve is a
+        // small move from the previous solution and the subsystems and their factorizations
+        // are kept for the whole drag. It ends with the next initSolution.
+        void initDrag(Algorithm alg=DogLeg);
 
         int solve(bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
         int solve(VEC_pD &params, bool isFine=true, Algorithm alg=DogLeg, bool isRedundantsolving=false);
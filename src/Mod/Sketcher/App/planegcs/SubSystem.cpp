@@ -20,6 +20,7 @@
  *                                                                         *
  ***************************************************************************/
 
+#include <algorithm>
 #include <iostream>
 #include <iterator>
 #include "SubSystem.h"
@@ -27,6 +28,21 @@
 namespace GCS
 {
 
+bool CachedLDLT::compute(const Eigen::SparseMatrix<double> &A)
+{
+    const int *outer = A.outerIndexPtr();
+    const int *inner = A.innerIndexPtr();
+    if (int(outerIndex.size()) != A.outerSize() + 1 || int(innerIndex.size()) != A.nonZeros() ||
+        !std::equal(outerIndex.begin(), outerIndex.end(), outer) ||
+        !std::equal(innerIndex.begin(), innerIndex.end(), inner)) {
+        ldlt.analyzePattern(A);
+        outerIndex.assign(outer, outer + A.outerSize() + 1);
+        innerIndex.assign(inner, inner + A.nonZeros());
+    }
+    ldlt.factorize(A);
+    return ldlt.info() == Eigen::Success;
+}
+
 // SubSystem
 SubSystem::SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params)
 : clist(clist_)
@@ -126,6 +142,47 @@ void SubSystem::initialize(VEC_pD &params, MAP_pD_pD &reductionmap)
         }
 //        (*constr)->redirectParams(pmap); // redirect parameters to pvec
     }
+
+    // the pattern of the jacobi matrix and the derivative behind each of its nonzeros
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int i=0; i < csize; i++) {
+        VEC_pD &cparams = c2p[clist[i]];
+        for (VEC_pD::const_iterator p=cparams.begin(); p != cparams.end(); ++p)
+            triplets.push_back(Eigen::Triplet<double>(i, int(*p - &pvals[0]), 0.));
+    }
+    jacobiPattern.resize(csize, psize);
+    jacobiPattern.setFromTriplets(triplets.begin(), triplets.end());
+    jacobiPattern.makeCompressed();
+
+    const int *outer = jacobiPattern.outerIndexPtr();
+    const int *inner = jacobiPattern.innerIndexPtr();
+    std::size_t maxslots = 0;
+    std::vector<int> types(csize);
+    slotStart.assign(1, 0);
+    slotEntries.clear();
+    for (int i=0; i < csize; i++) {
+        VEC_pD constr_params = clist[i]->params(); // the original parameters, reverted above
+        for (VEC_pD::const_iterator p=constr_params.begin();
+             p != constr_params.end(); ++p) {
+            int entry = -1;
+            MAP_pD_pD::const_iterator pmapfind = pmap.find(*p);
+            if (pmapfind != pmap.end()) {
+                int col = int(pmapfind->second - &pvals[0]);
+                entry = int(std::lower_bound(inner + outer[col], inner + outer[col+1], i) - inner);
+            }
+            slotEntries.push_back(entry);
+        }
+        slotStart.push_back(int(slotEntries.size()));
+        maxslots = std::max(maxslots, constr_params.size());
+        types[i] = clist[i]->getTypeId();
+    }
+    slotGrads.resize(maxslots);
+
+    evalOrder.resize(csize);
+    for (int i=0; i < csize; i++)
+        evalOrder[i] = i;
+    std::stable_sort(evalOrder.begin(), evalOrder.end(),
+                     [&types](int a, int b) { return types[a] < types[b]; });
 }
 
 void SubSystem::redirectParams()
@@ -258,15 +315,41 @@ void SubSystem::calcJacobi()
 }
 */
 
+// Evaluates the residual (if r is given) and the jacobi matrix with one call per constraint
+void SubSystem::evaluate(Eigen::VectorXd *r, Eigen::SparseMatrix<double> &jacobi)
+{
+    if (jacobi.rows() != csize || jacobi.cols() != psize ||
+        jacobi.nonZeros() != jacobiPattern.nonZeros())
+        jacobi = jacobiPattern;
+
+    double *values = jacobi.valuePtr();
+    std::fill(values, values + jacobi.nonZeros(), 0.);
+    for (std::vector<int>::const_iterator i=evalOrder.begin(); i != evalOrder.end(); ++i) {
+        double err = clist[*i]->errorAndGrad(slotGrads.data());
+        if (r)
+            (*r)[*i] = err;
+        // parameters appearing more than once in a constraint get the sum of their slots
+        const double *grad = slotGrads.data();
+        for (int k=slotStart[*i]; k < slotStart[*i+1]; k++, grad++) {
+            if (slotEntries[k] >= 0)
+                values[slotEntries[k]] += *grad;
+        }
+    }
+}
+
 void SubSystem::calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi)
 {
+    evaluate(0, jacobiValues);
     jacobi.setZero(csize, params.size());
     for (int j=0; j < int(params.size()); j++) {
         MAP_pD_pD::const_iterator
           pmapfind = pmap.find(params[j]);
-        if (pmapfind != pmap.end())
-            for (int i=0; i < csize; i++)
-                jacobi(i,j) = clist[i]->grad(pmapfind->second);
+        if (pmapfind != pmap.end()) {
+            // only the constraints depending on the parameter have a nonzero derivative
+            int col = int(pmapfind->second - &pvals[0]);
+            for (Eigen::SparseMatrix<double>::InnerIterator it(jacobiValues, col); it; ++it)
+                jacobi(it.row(),j) = it.value();
+        }
     }
 }
 
@@ -275,20 +358,53 @@ void SubSystem::calcJacobi(Eigen::MatrixXd &jacobi)
     calcJacobi(plist, jacobi);
 }
 
+void SubSystem::calcJacobi(Eigen::SparseMatrix<double> &jacobi)
+{
+    evaluate(0, jacobi);
+}
+
+void SubSystem::calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi)
+{
+    evaluate(0, jacobiValues);
+    std::vector< Eigen::Triplet<double> > triplets;
+    for (int j=0; j < int(params.size()); j++) {
+        MAP_pD_pD::const_iterator
+          pmapfind = pmap.find(params[j]);
+        if (pmapfind != pmap.end()) {
+            int col = int(pmapfind->second - &pvals[0]);
+            for (Eigen::SparseMatrix<double>::InnerIterator it(jacobiValues, col); it; ++it)
+                triplets.push_back(Eigen::Triplet<double>(int(it.row()), j, it.value()));
+        }
+    }
+    jacobi.resize(csize, params.size());
+    jacobi.setFromTriplets(triplets.begin(), triplets.end());
+}
+
+void SubSystem::calcResidualJacobi(Eigen::VectorXd &r, double &err, Eigen::SparseMatrix<double> &jacobi)
+{
+    assert(r.size() == csize);
+
+    evaluate(&r, jacobi);
+    err = 0.;
+    for (int i=0; i < csize; i++)
+        err += r[i]*r[i];
+    err *= 0.5;
+}
+
 void SubSystem::calcGrad(VEC_pD &params, Eigen::VectorXd &grad)
 {
     assert(grad.size() == int(params.size()));
 
+    Eigen::VectorXd r(csize);
+    evaluate(&r, jacobiValues);
     grad.setZero();
     for (int j=0; j < int(params.size()); j++) {
         MAP_pD_pD::const_iterator
           pmapfind = pmap.find(params[j]);
         if (pmapfind != pmap.end()) {
-            // assert(p2c.find(pmapfind->second) != p2c.end());
-            std::vector<Constraint *> constrs=p2c[pmapfind->second];
-            for (std::vector<Constraint *>::const_iterator constr = constrs.begin();
-                 constr != constrs.end(); ++constr)
-                grad[j] += (*constr)->error() * (*constr)->grad(pmapfind->second);
+            int col = int(pmapfind->second - &pvals[0]);
+            for (Eigen::SparseMatrix<double>::InnerIterator it(jacobiValues, col); it; ++it)
+                grad[j] += r[it.row()] * it.value();
         }
     }
 }
@@ -298,6 +414,60 @@ void SubSystem::calcGrad(Eigen::VectorXd &grad)
     calcGrad(plist, grad);
 }
 
+bool SubSystem::solveNormal(Eigen::SparseMatrix<double> &JtJ, double mu, Eigen::VectorXd &b, Eigen::VectorXd &x)
+{
+    Eigen::SparseMatrix<double> A(JtJ);
+    for (int i=0; i < A.outerSize(); i++)
+        A.coeffRef(i,i) += mu;
+
+    if (!normalLDLT.compute(A))
+        return false;
+    x = normalLDLT.solve(b);
+    return x.allFinite();
+}
+
+bool SubSystem::solveLeastNorm(Eigen::SparseMatrix<double> &J, Eigen::VectorXd &b, Eigen::VectorXd &x)
+{
+    // x = J^T * (J*J^T)^-1 * b, J*J^T is regular as long as the constraints are not redundant
+    Eigen::SparseMatrix<double> JJt = J * Eigen::SparseMatrix<double>(J.transpose());
+    if (!leastNormLDLT.compute(JJt))
+        return false;
+    x = J.transpose() * leastNormLDLT.solve(b);
+    return x.allFinite();
+}
+
+bool SubSystem::solveKKT(Eigen::SparseMatrix<double> &J, Eigen::VectorXd &H, Eigen::VectorXd &g,
+                         Eigen::VectorXd &r, Eigen::VectorXd &x)
+{
+    // [ H  J^T ] [ x ]   [ -g ]
+    // [ J  -dI ] [ y ] = [ -r ]
+    // The small regularization d makes the matrix quasi-definite, so that it can be
+    // factorized with LDLT in any order. The pattern is the same for all the iterations.
+    int xsize = int(J.cols());
+    std::vector< Eigen::Triplet<double> > triplets;
+    triplets.reserve(xsize + csize + 2*J.nonZeros());
+    for (int i=0; i < xsize; i++)
+        triplets.push_back(Eigen::Triplet<double>(i, i, H[i]));
+    for (int j=0; j < J.outerSize(); j++) {
+        for (Eigen::SparseMatrix<double>::InnerIterator it(J, j); it; ++it) {
+            triplets.push_back(Eigen::Triplet<double>(xsize + int(it.row()), j, it.value()));
+            triplets.push_back(Eigen::Triplet<double>(j, xsize + int(it.row()), it.value()));
+        }
+    }
+    for (int i=0; i < csize; i++)
+        triplets.push_back(Eigen::Triplet<double>(xsize + i, xsize + i, -1e-12));
+
+    Eigen::SparseMatrix<double> K(xsize + csize, xsize + csize);
+    K.setFromTriplets(triplets.begin(), triplets.end());
+    if (!kktLDLT.compute(K))
+        return false;
+
+    Eigen::VectorXd b(xsize + csize);
+    b << -g, -r;
+    x = kktLDLT.solve(b).head(xsize);
+    return x.allFinite();
+}
+
 double SubSystem::maxStep(VEC_pD &params, Eigen::VectorXd &xdir)
 {
     assert(xdir.size() == int(params.size()));
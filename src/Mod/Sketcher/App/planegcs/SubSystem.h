@@ -27,11 +27,24 @@
 #undef max
 
 #include <Eigen/Core>
+#include <Eigen/Sparse>
 #include "Constraints.h"
 
 namespace GCS
 {
 
+    // Sparse LDLT factorization of symmetric positive definite matrices that
+    // keeps the symbolic analysis as long as the pattern of the matrix does not change
+    class CachedLDLT
+    {
+    public:
+        bool compute(const Eigen::SparseMatrix<double> &A);
+        Eigen::VectorXd solve(const Eigen::VectorXd &b) const { return ldlt.solve(b); }
+    private:
+        Eigen::SimplicialLDLT< Eigen::SparseMatrix<double> > ldlt;
+        std::vector<int> outerIndex, innerIndex; // pattern of the analysed matrix
+    };
+
     class SubSystem
     {
     private:
@@ -43,7 +56,17 @@ namespace GCS
 //        JacobianMatrix jacobi;  // jacobi matrix of the residuals
         std::map<Constraint *,VEC_pD > c2p; // constraint to parameter adjacency list
         std::map<double *,std::vector<Constraint *> > p2c; // parameter to constraint adjacency list
+        Eigen::SparseMatrix<double> jacobiPattern; // nonzero pattern of the jacobi matrix (csize x psize)
+        // Each constraint writes the derivatives with respect to its parameters into consecutive
+        // slots (see Constraint::errorAndGrad). slotStart[i] is the first slot of clist[i] and
+        // slotEntries tells which nonzero of the jacobi matrix a slot contributes to (-1 for none).
+        std::vector<int> slotStart, slotEntries;
+        std::vector<int> evalOrder; // constraints grouped by type, so that the same code runs in a row
+        VEC_D slotGrads;
+        Eigen::SparseMatrix<double> jacobiValues;
+        CachedLDLT normalLDLT, leastNormLDLT, kktLDLT;
         void initialize(VEC_pD &params, MAP_pD_pD &reductionmap); // called by the constructors
+        void evaluate(Eigen::VectorXd *r, Eigen::SparseMatrix<double> &jacobi);
     public:
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params);
         SubSystem(std::vector<Constraint *> &clist_, VEC_pD &params,
@@ -71,9 +94,20 @@ namespace GCS
         void calcResidual(Eigen::VectorXd &r, double &err);
         void calcJacobi(VEC_pD &params, Eigen::MatrixXd &jacobi);
         void calcJacobi(Eigen::MatrixXd &jacobi);
+        void calcJacobi(Eigen::SparseMatrix<double> &jacobi);
+        void calcJacobi(VEC_pD &params, Eigen::SparseMatrix<double> &jacobi);
+        void calcResidualJacobi(Eigen::VectorXd &r, double &err, Eigen::SparseMatrix<double> &jacobi);
         void calcGrad(VEC_pD &params, Eigen::VectorXd &grad);
         void calcGrad(Eigen::VectorXd &grad);
 
+        // solves (J^T*J + mu*I)*x = b
+        bool solveNormal(Eigen::SparseMatrix<double> &JtJ, double mu, Eigen::VectorXd &b, Eigen::VectorXd &x);
+        // computes the least norm solution of J*x = b
+        bool solveLeastNorm(Eigen::SparseMatrix<double> &J, Eigen::VectorXd &b, Eigen::VectorXd &x);
+        // minimizes 0.5*x^T*diag(H)*x + g^T*x under the condition J*x + r = 0
+        bool solveKKT(Eigen::SparseMatrix<double> &J, Eigen::VectorXd &H, Eigen::VectorXd &g,
+                      Eigen::VectorXd &r, Eigen::VectorXd &x);
+
         double maxStep(VEC_pD &params, Eigen::VectorXd &xdir);
         double maxStep(Eigen::VectorXd &xdir);
 
@@ -0,0 +1,51 @@
+# Timings of the sketch solver on large sketches. This is not a unit test, run it
+# from the Python console:
+#
+#   import SketcherBenchmark
+#   SketcherBenchmark.run()
+
+import time
+import FreeCAD as App
+import Part, Sketcher
+from TestSketcherApp import CreateRectangleSketch, CreateCircleSketch, CreateRectangleChain
+
+def constraintAddLatency(doc, count, adds=10, incremental=False):
+    """Returns the time in ms to add a constraint to a sketch of count rectangles."""
+    sketch = doc.addObject('Sketcher::SketchObject','SketchLatency')
+    sketch.IncrementalDiagnosis = incremental
+    for r in range(count):
+        CreateRectangleSketch(sketch, [12.0 * (r % 10), 8.0 * (r // 10)], [10, 5])
+    sketch.solve()
+    start = time.time()
+    for i in range(adds):
+        CreateCircleSketch(sketch, [5.0 + 12.0 * i, -10.0], 2.0)
+    # three constraints per circle
+    return (time.time() - start) * 1000.0 / (3 * adds)
+
+def dragLatency(doc, count, steps=50):
+    """Returns the time in ms of one drag step on a chain of count rectangles."""
+    sketch = doc.addObject('Sketcher::SketchObject','SketchDrag')
+    CreateRectangleChain(sketch, count, False)
+    doc.recompute()
+    sketch.initTemporaryMove(2, 2)
+    start = time.time()
+    for s in range(1, steps + 1):
+        sketch.moveTemporaryPoint(2, 2, App.Vector(1.0 + 0.1 * s, 1.0 + 0.05 * s, 0))
+    return (time.time() - start) * 1000.0 / steps
+
+def run(counts=(10, 50, 200)):
+    doc = App.newDocument("SketcherBenchmark")
+    try:
+        for count in counts:
+            for incremental in (False, True):
+                ms = constraintAddLatency(doc, count, incremental=incremental)
+                App.Console.PrintMessage("Adding constraints to {} rectangles (incremental diagnosis {}): {:.3f} ms per constraint\n"
+                                         .format(count, "on" if incremental else "off", ms))
+        for count in counts:
+            ms = dragLatency(doc, count)
+            App.Console.PrintMessage("Dragging a chain of {} rectangles: {:.3f} ms per step\n".format(count, ms))
+    finally:
+        App.closeDocument(doc.Name)
+
+if __name__ == "__main__":
+    run()
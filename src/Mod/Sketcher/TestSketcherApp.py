@@ -56,6 +56,36 @@ def CreateRectangleSketch(SketchFeature, corner, lengths):
         SketchFeature.addConstraint(Sketcher.Constraint('Distance',i+1,vmax-vmin)) 
         SketchFeature.addConstraint(Sketcher.Constraint('Distance',i+0,hmax-hmin)) 
 
+def CreateRectangleChain(SketchFeature, count, fixedX=True):
+    for r in range(count):
+        hmin, vmin = 12.0 * r + 0.3 * (r % 3), 1.0 + r - 0.2 * (r % 2)
+        hmax, vmax = hmin + 9.5, vmin + 5.5
+        i = 4 * r
+        SketchFeature.addGeometry(Part.LineSegment(App.Vector(hmin,vmax,0),App.Vector(hmax,vmax,0)))
+        SketchFeature.addGeometry(Part.LineSegment(App.Vector(hmax,vmax,0),App.Vector(hmax,vmin,0)))
+        SketchFeature.addGeometry(Part.LineSegment(App.Vector(hmax,vmin,0),App.Vector(hmin,vmin,0)))
+        SketchFeature.addGeometry(Part.LineSegment(App.Vector(hmin,vmin,0),App.Vector(hmin,vmax,0)))
+        conList = []
+        conList.append(Sketcher.Constraint('Coincident',i+0,2,i+1,1))
+        conList.append(Sketcher.Constraint('Coincident',i+1,2,i+2,1))
+        conList.append(Sketcher.Constraint('Coincident',i+2,2,i+3,1))
+        conList.append(Sketcher.Constraint('Coincident',i+3,2,i+0,1))
+        conList.append(Sketcher.Constraint('Horizontal',i+0))
+        conList.append(Sketcher.Constraint('Horizontal',i+2))
+        conList.append(Sketcher.Constraint('Vertical',i+1))
+        conList.append(Sketcher.Constraint('Vertical',i+3))
+        conList.append(Sketcher.Constraint('Distance',i+0,10.0))
+        conList.append(Sketcher.Constraint('Distance',i+1,5.0))
+        if r == 0:
+            if fixedX:
+                conList.append(Sketcher.Constraint('DistanceX',i+2,2,1.0))
+            conList.append(Sketcher.Constraint('DistanceY',i+2,2,1.0))
+        else:
+            # place the bottom left corner relative to the bottom right corner of the previous rectangle
+            conList.append(Sketcher.Constraint('DistanceX',i-2,1,i+2,2,2.0))
+            conList.append(Sketcher.Constraint('DistanceY',i-2,1,i+2,2,1.0))
+        SketchFeature.addConstraint(conList)
+
 def CreateCircleSketch(SketchFeature, center, radius):
     i = int(SketchFeature.GeometryCount)
     SketchFeature.addGeometry(Part.Circle(App.Vector(*center), App.Vector(0,0,1), radius),False)
@@ -152,6 +182,84 @@ class SketcherSolverTestCases(unittest.TestCase):
 		self.Doc.recompute()
 		self.failUnless(len(self.Slot.Shape.Edges) == 9)
 
+	def testLargeSketch(self):
+		# a chain of rectangles forms one large subsystem that is solved with sparse matrices
+		sketch = self.Doc.addObject('Sketcher::SketchObject','SketchChain')
+		count = 40
+		CreateRectangleChain(sketch, count)
+		self.Doc.recompute()
+		self.assertEqual(sketch.solve(), 0)
+		for r in range(count):
+			self.assertTrue(sketch.getPoint(4 * r + 2, 2).isEqual(App.Vector(1.0 + 12.0 * r, 1.0 + r, 0), 1e-7))
+			self.assertTrue(sketch.getPoint(4 * r, 2).isEqual(App.Vector(11.0 + 12.0 * r, 6.0 + r, 0), 1e-7))
+
+	def testDragLargeSketch(self):
+		# the chain can only move horizontally, every move starts from the previous solution
+		sketch = self.Doc.addObject('Sketcher::SketchObject','SketchDrag')
+		count = 30
+		CreateRectangleChain(sketch, count, False)
+		self.Doc.recompute()
+		sketch.initTemporaryMove(2, 2)
+		steps = 10
+		for s in range(1, steps + 1):
+			self.assertTrue(sketch.moveTemporaryPoint(2, 2, App.Vector(1.0 + 0.1 * s, 1.0 + 0.05 * s, 0)))
+		sketch.movePoint(2, 2, App.Vector(1.0 + 0.1 * steps, 1.0, 0))
+		for r in range(count):
+			self.assertTrue(sketch.getPoint(4 * r + 2, 2).isEqual(App.Vector(1.0 + 0.1 * steps + 12.0 * r, 1.0 + r, 0), 1e-7))
+
+	def testParallelSolve(self):
+		# many independent rectangles are solved and diagnosed as independent components
+		sketches = []
+		for parallel in (False, True):
+			sketch = self.Doc.addObject('Sketcher::SketchObject','SketchComponents')
+			sketch.ParallelSolve = parallel
+			for r in range(50):
+				CreateRectangleSketch(sketch, [12.0 * (r % 10), 8.0 * (r // 10)], [10, 5])
+			for r in range(50):
+				sketch.setDatum(12 * r + 11, 10.0 - 0.1 * r)
+			# a redundant constraint in one of the rectangles
+			sketch.addConstraint(Sketcher.Constraint('DistanceY',58,2,8.0))
+			sketches.append(sketch)
+		self.Doc.recompute()
+		self.assertEqual(sketches[0].solve(), -2)
+		self.assertEqual(sketches[1].solve(), -2)
+		for i in range(sketches[0].GeometryCount):
+			for pos in (1, 2):
+				self.assertTrue(sketches[0].getPoint(i, pos).isEqual(sketches[1].getPoint(i, pos), 1e-9))
+		self.assertAlmostEqual(sketches[1].getPoint(4 * 49, 2).x, 108.0 + 10.0 - 4.9, 7)
+
+	def testAddConstraintsIncrementally(self):
+		# only the parts of the sketch touched by a new constraint are diagnosed again
+		self.assertFalse(self.Doc.addObject('Sketcher::SketchObject','SketchDefault').IncrementalDiagnosis)
+		for count in (1, 10):
+			sketch = self.Doc.addObject('Sketcher::SketchObject','SketchIncremental')
+			sketch.IncrementalDiagnosis = True
+			for r in range(count):
+				CreateRectangleSketch(sketch, [12.0 * (r % 10), 8.0 * (r // 10)], [10, 5])
+			adds = 5
+			for i in range(adds):
+				CreateCircleSketch(sketch, [5.0 + 12.0 * i, -10.0], 2.0)
+			self.assertEqual(sketch.solve(), 0)
+			self.assertTrue(sketch.getPoint(4 * count + adds - 1, 3).isEqual(App.Vector(5.0 + 12.0 * (adds - 1), -10.0, 0), 1e-9))
+
+	def testIncrementalDiagnosis(self):
+		# the diagnosis of the components agrees with the diagnosis of the whole sketch
+		sketches = []
+		for incremental in (False, True):
+			sketch = self.Doc.addObject('Sketcher::SketchObject','SketchDiagnosis')
+			sketch.IncrementalDiagnosis = incremental
+			for r in range(5):
+				CreateRectangleSketch(sketch, [12.0 * r, 0.0], [10, 5])
+			sketch.solve()
+			# a redundant constraint in one of the rectangles
+			sketch.addConstraint(Sketcher.Constraint('DistanceY',6,2,0.0))
+			sketches.append(sketch)
+		self.assertEqual(sketches[0].solve(), sketches[1].solve())
+		self.assertEqual(sketches[0].solve(), -2)
+		for i in range(sketches[0].GeometryCount):
+			for pos in (1, 2):
+				self.assertTrue(sketches[0].getPoint(i, pos).isEqual(sketches[1].getPoint(i, pos), 1e-9))
+
 	def testIssue3245(self):
 		self.Doc2 = FreeCAD.newDocument("Issue3245")
 		self.Doc2.addObject('Sketcher::SketchObject','Sketch')